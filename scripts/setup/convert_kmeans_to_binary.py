@@ -0,0 +1,36 @@
+import sys
+import struct
+from array import array
+
+# Converts a k-means dataset from the text format
+#   k dim col count
+#   <count rows with col values each, of which the first dim are used>
+# to the binary format read by Mallob's KMeans application:
+# a 24-byte header (magic, k, dim, count) followed by count*dim float32 values.
+# Usage: python3 convert_kmeans_to_binary.py <input.txt> <output.bin>
+
+if len(sys.argv) != 3:
+    print("Usage: " + sys.argv[0] + " <input.txt> <output.bin>")
+    exit(1)
+
+with open(sys.argv[1], 'r') as fin, open(sys.argv[2], 'wb') as fout:
+    def next_tokens():
+        for line in fin:
+            for token in line.split():
+                yield token
+    it = next_tokens()
+    k, dim, col, count = int(next(it)), int(next(it)), int(next(it)), int(next(it))
+    fout.write(b'MLBKMNS1' + struct.pack('<iiq', k, dim, count))
+
+    # write the points in batches
+    batch = array('f')
+    for point in range(count):
+        for entry in range(col):
+            value = float(next(it))
+            if entry < dim:
+                batch.append(value)
+        if len(batch) >= 1<<20 or point+1 == count:
+            if sys.byteorder != 'little':
+                batch.byteswap()
+            batch.tofile(fout)
+            batch = array('f')
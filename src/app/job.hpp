@@ -132,6 +132,11 @@ public:
     */
     virtual void appl_memoryPanic() = 0;
     /*
+    The suspended job is about to be dropped from this worker (and terminated right after).
+    Preserve whatever state is worth preserving for a later restart of this job node.
+    */
+    virtual void appl_preempt() {}
+    /*
     Return how many processes this job would like to run on based on its meta data 
     and its previous volume.
     This method must return an integer greater than 0 and no greater than _comm_size. 
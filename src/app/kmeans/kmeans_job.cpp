@@ -1,6 +1,9 @@
 #include "kmeans_job.hpp"
 
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <random>
 #include <thread>
 
@@ -44,11 +47,10 @@ void KMeansJob::appl_start() {
 
     loadInstance();
     _cluster_membership.assign(_num_points, -1);
+    if (_params.kmeansPruning()) _bounds.init(_num_points);
 
-    _local_cluster_centers.resize(_num_clusters);
     _cluster_centers.resize(_num_clusters);
     for (int cluster = 0; cluster < _num_clusters; ++cluster) {
-        _local_cluster_centers[cluster].assign(_dimension, 0);
         _cluster_centers[cluster].resize(_dimension);
     }
     LOG(V5_DEBG, "KMDBG myIndex: %i Ready!\n", _my_index);
@@ -229,7 +231,7 @@ void KMeansJob::appl_communicate() {
                 if (!_right_done) _right_done = (currentIndex == (_my_index * 2 + 2));
                 LOG(V5_DEBG, "KMDBG myIndex: %i Start Calc\n", _my_index);
                 if (!_skip_current_iter) {
-                    calcNearestCenter(metric, cI);
+                    calcNearestCenter(cI);
                 }
                 LOG(V5_DEBG, "KMDBG myIndex: %i End Calc childs\n", _my_index);
 
@@ -250,10 +252,7 @@ void KMeansJob::appl_communicate() {
         LOG(V5_DEBG, "KMDBG myIndex: %i all work Finished2!!!\n", _my_index);
         if (!_skip_current_iter) {
             auto producer = [&]() {
-                calcCurrentClusterCenters();
-
-                // LOG(V5_DEBG, "clusterCenters: \n%s\n", dataToString(localClusterCenters).c_str());
-                return clusterCentersToReduce(_local_sum_members, _local_cluster_centers);
+                return calcLocalClusterSums();
             };
             (_reducer)->produce(producer);
             (_reducer)->advance();
@@ -390,7 +389,7 @@ void KMeansJob::appl_communicate(int source, int mpiTag, JobMessage& msg) {
             //     dataToString(clusterCenters).c_str());
             _calculating_task = ProcessWideThreadPool::get().addTask([&]() {
                 LOG(V5_DEBG, "KMDBG myIndex: %i Start Calc\n", _my_index);
-                calcNearestCenter(metric, _my_index);
+                calcNearestCenter(_my_index);
                 LOG(V5_DEBG, "KMDBG myIndex: %i End Calc basic\n", _my_index);
                 _calculating_finished = true;
             });
@@ -425,10 +424,30 @@ void KMeansJob::loadInstance() {
     _dimension = metadata[1];
     _num_points = metadata[2];
     LOG(V5_DEBG, "                          countClusters: %i dimension %i pointsCount: %i\n", _num_clusters, _dimension, _num_points);
-    _all_red_elem_size = (_dimension + 1) * _num_clusters;
+    initReductionLayout();
     setMaxDemand();
 }
 
+void KMeansJob::initReductionLayout() {
+    _exact_sums = _params.kmeansExactSums();
+    _sums_size = (_exact_sums ? 2 : 4) * _num_clusters * _dimension;
+    _all_red_elem_size = _sums_size + _num_clusters;
+    if (!_exact_sums) return;
+
+    // Every worker holds all points, so all workers arrive at the same scale:
+    // the largest power of two for which no sum of up to _num_points
+    // scaled coordinates can exceed 2^62 in absolute value.
+    float maxAbs = 0;
+    const size_t nbEntries = (size_t) _num_points * _dimension;
+    for (size_t i = 0; i < nbEntries; ++i) {
+        maxAbs = std::max(maxAbs, std::fabs(_points_start[i]));
+    }
+    int exponent = 0;
+    if (maxAbs > 0) std::frexp((double) maxAbs * _num_points, &exponent);
+    _fixed_point_scale = std::ldexp(1.0, 62 - exponent);
+    LOG(V5_DEBG, "KMDBG max. abs. coordinate %.4e, fixed-point scale 2^%i\n", maxAbs, 62 - exponent);
+}
+
 void KMeansJob::setRandomStartCenters() {  // use RNG with seed
     _cluster_centers.clear();
     _cluster_centers.resize(_num_clusters);
@@ -453,72 +472,96 @@ void KMeansJob::setRandomStartCenters() {  // use RNG with seed
     }
 }
 
-void KMeansJob::calcNearestCenter(std::function<float(const float* p1, const float* p2, const size_t dim)> metric, int intervalId) {
-    int currentCluster;
-    float currentDistance;
-    float distanceToCluster;
+void KMeansJob::calcNearestCenter(int intervalId) {
     // while own or child slices todo
     int startIndex = static_cast<int>(static_cast<float>(_num_points) * (static_cast<float>(intervalId) / static_cast<float>(_num_curr_workers)));
     int endIndex = static_cast<int>(static_cast<float>(_num_points) * (static_cast<float>(intervalId + 1) / static_cast<float>(_num_curr_workers)));
     LOG(V5_DEBG, "KMDBG MI: %i intervalId: %i PC: %i cW: %i start:%i end:%i!!      iter:%i k:%i \n", _my_index, intervalId, _num_points, _num_curr_workers, startIndex, endIndex, _iterations_done, _num_clusters);
-    for (int pointID = startIndex; pointID < endIndex; ++pointID) {
-        if (_terminate) return;
-        // LOG(V1_WARN, "(pointID / endIndex) < 0.25: %i iAmRoot: %i countCurrentWorkers == 1: %i std::find(work.begin(), work.end(), 1) != work.end() && std::find(work.begin(), work.end(), 2) != work.end()): %i leftDone && rightDone:%i this->getVolume() > 1:%i\n", (pointID / endIndex) < 0.25, iAmRoot, countCurrentWorkers == 1, std::find(work.begin(), work.end(), 1) != work.end() && std::find(work.begin(), work.end(), 2) != work.end(), leftDone && rightDone,  this->getVolume() > 1);
-
-        if (((float)pointID / endIndex) < 0.25 &&
-            _is_root &&
-            (_num_curr_workers == 1 ||
-             (std::find(_work.begin(), _work.end(), 1) != _work.end() && std::find(_work.begin(), _work.end(), 2) != _work.end())) &&
-            (_left_done && _right_done) &&
-            this->getVolume() > 1) {
-            LOG(V3_VERB, "%s : will skip Iter\n", toStr());
-            _skip_current_iter = true;
-            _work.clear();
-            _work_done.clear();
-            return;
-        }
-        currentCluster = -1;
-        currentDistance = std::numeric_limits<float>::infinity();
-        for (int clusterID = 0; clusterID < _num_clusters; ++clusterID) {
-            distanceToCluster = metric(getKMeansData(pointID), _cluster_centers[clusterID].data(), _dimension);
-            if (distanceToCluster < currentDistance) {
-                currentCluster = clusterID;
-                currentDistance = distanceToCluster;
+
+    // Points are assigned block by block, so that termination and skipping are noticed quickly
+    const int pointsPerBlock = 1024;
+    auto assignPoints = [&](int from, int to, bool mayDecideSkip) {
+        for (int blockStart = from; blockStart < to; blockStart += pointsPerBlock) {
+            if (_terminate || _skip_current_iter) return;
+            if (mayDecideSkip && shouldSkipIteration(blockStart, endIndex)) {
+                LOG(V3_VERB, "%s : will skip Iter\n", toStr());
+                _skip_current_iter = true;
+                _work.clear();
+                _work_done.clear();
+                return;
+            }
+            const int blockEnd = std::min(to, blockStart + pointsPerBlock);
+            if (_params.kmeansPruning()) {
+                _bounds.assign(_points_start, blockStart, blockEnd, _center_matrix, _cluster_membership.data());
+            } else {
+                KMeansUtils::nearestCenters(getKMeansData(blockStart), blockEnd - blockStart, _center_matrix,
+                                            _cluster_membership.data() + blockStart);
             }
         }
+    };
 
-        _cluster_membership[pointID] = currentCluster;
-    }
+    // Split the interval among multiple threads if it is large enough
+    const int minPointsPerThread = 4 * pointsPerBlock;
+    int nbThreads = _params.kmeansThreads() > 0 ? _params.kmeansThreads() : std::max(1, _params.numThreadsPerProcess());
+    nbThreads = std::max(1, std::min(nbThreads, (endIndex - startIndex) / minPointsPerThread));
+    std::vector<std::thread> threads;
+    for (int t = 1; t < nbThreads; ++t) {
+        const int from = startIndex + (long)(endIndex - startIndex) * t / nbThreads;
+        const int to = startIndex + (long)(endIndex - startIndex) * (t + 1) / nbThreads;
+        threads.emplace_back([&, from, to]() { assignPoints(from, to, false); });
+    }
+    // Only the calling thread (with the first part of the interval) may decide to skip the iteration
+    assignPoints(startIndex, startIndex + (endIndex - startIndex) / nbThreads, true);
+    for (auto& thread : threads) thread.join();
+    if (_terminate || _skip_current_iter) return;
     LOG(V5_DEBG, "KMDBG MI: %i intervalId: %i PC: %i cW: %i start:%i end:%i COMPLETED iter:%i \n", _my_index, intervalId, _num_points, _num_curr_workers, startIndex, endIndex, _iterations_done);
 }
 
-void KMeansJob::calcCurrentClusterCenters() {
+bool KMeansJob::shouldSkipIteration(int pointID, int endIndex) {
+    // LOG(V1_WARN, "(pointID / endIndex) < 0.25: %i iAmRoot: %i countCurrentWorkers == 1: %i std::find(work.begin(), work.end(), 1) != work.end() && std::find(work.begin(), work.end(), 2) != work.end()): %i leftDone && rightDone:%i this->getVolume() > 1:%i\n", (pointID / endIndex) < 0.25, iAmRoot, countCurrentWorkers == 1, std::find(work.begin(), work.end(), 1) != work.end() && std::find(work.begin(), work.end(), 2) != work.end(), leftDone && rightDone,  this->getVolume() > 1);
+    return ((float)pointID / endIndex) < 0.25 &&
+           _is_root &&
+           (_num_curr_workers == 1 ||
+            (std::find(_work.begin(), _work.end(), 1) != _work.end() && std::find(_work.begin(), _work.end(), 2) != _work.end())) &&
+           (_left_done && _right_done) &&
+           this->getVolume() > 1;
+}
+
+std::vector<int> KMeansJob::calcLocalClusterSums() {
     _old_cluster_centers = _cluster_centers;
 
-    countMembers();
+    // The element is filled in place and travels up the job tree as is
+    std::vector<int> elem(_all_red_elem_size, 0);
+    int* counts = elem.data() + _sums_size;
+    int64_t* fixedSums = (int64_t*) elem.data();
+    double* sums = (double*) elem.data();
+    double* compensations = sums + _num_clusters * _dimension;
 
-    for (int cluster = 0; cluster < _num_clusters; ++cluster) {
-        auto currentCenter = _local_cluster_centers[cluster].data();
-        for (int d = 0; d < _dimension; ++d) {
-            currentCenter[d] = 0;
-        }
-    }
     for (auto workIndex : _work_done) {
         int startIndex = static_cast<int>(static_cast<float>(_num_points) * (static_cast<float>(workIndex) / static_cast<float>(_num_curr_workers)));
 
         int endIndex = static_cast<int>(static_cast<float>(_num_points) * (static_cast<float>(workIndex + 1) / static_cast<float>(_num_curr_workers)));
         for (int pointID = startIndex; pointID < endIndex; ++pointID) {
-            // if (clusterMembership[pointID] != -1) {
             int clusterId = _cluster_membership[pointID];
-            auto currentCenter = _local_cluster_centers[clusterId].data();
-            float divisor = static_cast<float>(_local_sum_members[clusterId]);
+            if (clusterId == -1) continue;
+            counts[clusterId] += 1;
             auto currentDataPoint = getKMeansData(pointID);
-            for (int d = 0; d < _dimension; ++d) {
-                currentCenter[d] += currentDataPoint[d] / divisor;
+            const int offset = clusterId * _dimension;
+            if (_exact_sums) {
+                for (int d = 0; d < _dimension; ++d) {
+                    fixedSums[offset + d] += std::llrint(currentDataPoint[d] * _fixed_point_scale);
+                }
+            } else {
+                for (int d = 0; d < _dimension; ++d) {
+                    KMeansUtils::addCompensated(sums[offset + d], compensations[offset + d], currentDataPoint[d]);
+                }
             }
         }
     }
+    LOG(V5_DEBG, "KMDBG myIndex: %i sumMembers: %s\n",
+        _my_index, dataToString(std::vector<int>(counts, counts + _num_clusters)).c_str());
     ++_iterations_done;
+    return elem;
 }
 
 std::string KMeansJob::dataToString(std::vector<Point> data) {
@@ -542,18 +585,6 @@ std::string KMeansJob::dataToString(std::vector<int> data) {
     return result.str();
 }
 
-void KMeansJob::countMembers() {
-    _local_sum_members.assign(_num_clusters, 0);
-    for (int i = 0; i < _num_points; ++i) {
-        int clusterID = _cluster_membership[i];
-        if (clusterID != -1) {
-            _local_sum_members[clusterID] += 1;
-        }
-    }
-    LOG(V5_DEBG, "KMDBG myIndex: %i sumMembers: %s\n",
-        _my_index, dataToString(_local_sum_members).c_str());
-}
-
 bool KMeansJob::centersChanged() {
     if (_iterations_done == 0) {
         return true;
@@ -591,7 +622,7 @@ std::vector<float> KMeansJob::clusterCentersToSolution() {
     result.push_back((float)_num_clusters);
     result.push_back((float)_dimension);
 
-    for (auto point : _cluster_centers) {
+    for (const auto& point : _cluster_centers) {
         for (auto entry : point) {
             result.push_back(entry);
         }
@@ -603,7 +634,7 @@ std::vector<int> KMeansJob::clusterCentersToBroadcast(const std::vector<Point>&
     std::vector<int> result;
     result.resize(reduceClusterCenters.size() * _dimension);
     int i = 0;
-    for (auto point : reduceClusterCenters) {
+    for (const auto& point : reduceClusterCenters) {
         auto centerData = point.data();
         for (int entry = 0; entry < _dimension; ++entry) {
             result[i++] = (*((int*)(centerData + entry)));
@@ -614,27 +645,8 @@ std::vector<int> KMeansJob::clusterCentersToBroadcast(const std::vector<Point>&
     return result;
 }
 
-std::vector<KMeansJob::Point> KMeansJob::broadcastToClusterCenters(const std::vector<int>& reduce) {
-    std::vector<Point> localClusterCentersResult;
-    const int elementsCount = _all_red_elem_size - _num_clusters;
-    const int* reduceData = reduce.data();
-
-    reduceData += _num_clusters;
-
-    localClusterCentersResult.resize(_num_clusters);
-    for (int k = 0; k < _num_clusters; ++k) {
-        localClusterCentersResult[k].resize(_dimension);
-        auto currentCenter = localClusterCentersResult[k].data();
-        auto receivedCenter = reduceData + k * _dimension;
-        for (int d = 0; d < _dimension; ++d) {
-            currentCenter[d] = *((float*)(receivedCenter + d));
-        }
-    }
-
-    return localClusterCentersResult;
-}
 void KMeansJob::setClusterCenters(const std::vector<int>& reduce) {
-    const int elementsCount = _all_red_elem_size - _num_clusters;
+    const int elementsCount = _num_clusters * _dimension;
     for (int k = 0; k < _num_clusters; ++k) {
         assert(k < _cluster_centers.size());
         auto& currentCenter = _cluster_centers[k];
@@ -645,94 +657,63 @@ void KMeansJob::setClusterCenters(const std::vector<int>& reduce) {
         }
     }
     _num_curr_workers = reduce[elementsCount];
+    // Prepare the centers for all intervals computed in this iteration
+    _center_matrix.set(_cluster_centers, _dimension);
+    if (_params.kmeansPruning()) _bounds.updateCenters(_cluster_centers, _center_matrix);
     LOG(V5_DEBG, "KMDBG myIndex: %i countCurrentWorkers: %i\n", _my_index, _num_curr_workers);
 }
 
-std::vector<int> KMeansJob::clusterCentersToReduce(const std::vector<int>& reduceSumMembers, const std::vector<Point>& reduceClusterCenters) {
-    std::vector<int> result;
-    int i = 0;
-    std::vector<int> tempCenters = clusterCentersToBroadcast(reduceClusterCenters);
-
-    result.resize(reduceSumMembers.size());
-
-    for (auto entry : reduceSumMembers) {
-        result[i++] = entry;
-    }
-    result.insert(result.end(), tempCenters.begin(), tempCenters.end());
-
-    return result;
-}
-
-std::pair<std::vector<std::vector<float>>, std::vector<int>>
-KMeansJob::reduceToclusterCenters(const std::vector<int>& reduce) {
-    // auto [centers, counts] = reduceToclusterCenters(); //call example
-    std::vector<int> localSumMembersResult;
-    const int elementsCount = _all_red_elem_size - _num_clusters;
-
-    const int* reduceData = reduce.data();
+void KMeansJob::sumsToClusterCenters(const std::vector<int>& reduce) {
+    assert(reduce.size() == _all_red_elem_size);
+    const int* counts = reduce.data() + _sums_size;
+    const int64_t* fixedSums = (const int64_t*) reduce.data();
+    const double* sums = (const double*) reduce.data();
+    const double* compensations = sums + _num_clusters * _dimension;
 
-    localSumMembersResult.assign(_num_clusters, 0);
-    for (int i = 0; i < _num_clusters; ++i) {
-        // LOG(V5_DEBG, "i: %d\n", i);
-        localSumMembersResult[i] = reduceData[i];
+    for (int k = 0; k < _num_clusters; ++k) {
+        auto& currentCenter = _cluster_centers[k];
+        const int offset = k * _dimension;
+        for (int d = 0; d < _dimension; ++d) {
+            if (counts[k] == 0) {
+                currentCenter[d] = 0;
+                continue;
+            }
+            const double sum = _exact_sums ? fixedSums[offset + d] / _fixed_point_scale
+                : sums[offset + d] + compensations[offset + d];
+            currentCenter[d] = static_cast<float>(sum / counts[k]);
+        }
     }
-
-    return std::pair(std::move(broadcastToClusterCenters(reduce)), std::move(localSumMembersResult));
 }
 
-std::vector<int> KMeansJob::aggregate(const std::list<std::vector<int>>& messages) {
-    std::vector<std::vector<KMeansJob::Point>> centers;
-    std::vector<int> counts;
-    std::vector<int> tempSumMembers;
-    std::vector<Point> tempClusterCenters;
-    const int countMessages = messages.size();
-    centers.resize(countMessages);
-    counts.reserve(countMessages * _num_clusters);
-    auto message = messages.begin();
-    // LOG(V5_DEBG, "                         myIndex: %i countMessages: %d\n", myIndex, countMessages);
-    for (int i = 0; i < countMessages; ++i) {
-        auto data = reduceToclusterCenters(*message);
-        ++message;
-        centers[i] = std::move(data.first);
-        counts.insert(counts.end(), data.second.begin(), data.second.end());
-
-        // LOG(V5_DEBG, "                         myIndex: %i counts[%d] : \n%s\n", myIndex, i, dataToString(counts[i]).c_str());
-        //  LOG(V5_DEBG, "clusterCentersI: \n%s\n", dataToString(centers[i]).c_str());
-    }
-
-    tempSumMembers.resize(_num_clusters);
-    for (int i = 0; i < countMessages; ++i) {
-        for (int j = 0; j < _num_clusters; ++j) {
-            tempSumMembers[j] = tempSumMembers[j] + counts[i * _num_clusters + j];
-
-            // LOG(V5_DEBG, "tempSumMembers[%d] + counts[%d][%d] : \n%d\n",j,i,j, tempSumMembers[j] + counts[i][j]);
-            // LOG(V5_DEBG, "tempSumMembers[%d] : \n%d\n",j, tempSumMembers[j]);
-            // LOG(V5_DEBG, "KRITcounts[%d] : \n%s\n",i, dataToString(tempSumMembers).c_str());
+std::vector<int> KMeansJob::aggregate(std::list<std::vector<int>>& messages) {
+    // Fold all elements into the first one, in the (fixed) order given
+    auto& result = messages.front();
+    assert(result.size() == _all_red_elem_size);
+    int* counts = result.data() + _sums_size;
+    int64_t* fixedSums = (int64_t*) result.data();
+    double* sums = (double*) result.data();
+    double* compensations = sums + _num_clusters * _dimension;
+    const int nbSums = _num_clusters * _dimension;
+
+    for (auto it = std::next(messages.begin()); it != messages.end(); ++it) {
+        assert(it->size() == _all_red_elem_size);
+        const int* otherCounts = it->data() + _sums_size;
+        for (int k = 0; k < _num_clusters; ++k) {
+            counts[k] += otherCounts[k];
         }
-    }
-    tempClusterCenters.resize(_num_clusters);
-    for (int i = 0; i < _num_clusters; ++i) {
-        tempClusterCenters[i].assign(_dimension, 0);
-    }
-
-    float ratio;
-    float currentSum;
-
-    for (int i = 0; i < countMessages; ++i) {
-        std::vector<KMeansJob::Point>& currentMsg = centers[i];
-        for (int j = 0; j < _num_clusters; ++j) {
-            currentSum = static_cast<float>(tempSumMembers[j]);
-            if (currentSum != 0) {
-                KMeansJob::Point& currentCenter = tempClusterCenters[j];
-                KMeansJob::Point& currentMsgCenter = currentMsg[j];
-                ratio = static_cast<float>(counts[i * _num_clusters + j]) /
-                        currentSum;
-                for (int k = 0; k < _dimension; ++k) {
-                    currentCenter[k] += currentMsgCenter[k] * ratio;
-                }
+        if (_exact_sums) {
+            const int64_t* otherSums = (const int64_t*) it->data();
+            for (int i = 0; i < nbSums; ++i) {
+                fixedSums[i] += otherSums[i];
+            }
+        } else {
+            const double* otherSums = (const double*) it->data();
+            const double* otherCompensations = otherSums + nbSums;
+            for (int i = 0; i < nbSums; ++i) {
+                KMeansUtils::addCompensated(sums[i], compensations[i], otherSums[i]);
+                compensations[i] += otherCompensations[i];
             }
         }
     }
-
-    return clusterCentersToReduce(tempSumMembers, tempClusterCenters);  // localSumMembers, tempClusterCenters
-}
\ No newline at end of file
+    return std::move(result);
+}
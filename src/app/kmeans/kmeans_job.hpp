@@ -18,10 +18,21 @@ class KMeansJob : public Job {
     typedef std::vector<float> Point;
 
     std::vector<Point> _cluster_centers;       // The centers of cluster 0..n
-    std::vector<Point> _local_cluster_centers;  // The centers of cluster 0..n
     std::vector<Point> _old_cluster_centers;
+    KMeansUtils::CenterMatrix _center_matrix;  // contiguous copy of _cluster_centers for the distance kernel
+    KMeansUtils::BoundedAssignment _bounds;    // distance bounds for skipping points (if pruning)
     std::vector<int> _cluster_membership;  // A point KMeansData[i] belongs to cluster ClusterMembership[i]
-    std::vector<int> _local_sum_members;
+
+    // An all-reduction element holds, for each cluster, the sum of its members'
+    // coordinates (k*d 64-bit values, viewed in place) followed by its number of
+    // members (k ints). With exact sums, each coordinate is accumulated as a 64-bit
+    // fixed-point integer, which renders the reduced sums (and hence the centers)
+    // bitwise independent of the job tree's shape and of the order of aggregation.
+    // Otherwise, doubles are accumulated with Kahan-Babuska compensation, and the
+    // k*d compensation terms follow the sums.
+    bool _exact_sums = true;
+    double _fixed_point_scale = 1;  // power of two to scale coordinates with
+    int _sums_size;                 // number of ints taken by the sums (and compensations)
 
     int _num_clusters;
     int _dimension;
@@ -44,8 +55,8 @@ class KMeansJob : public Job {
     bool _has_reducer = false;
     bool _left_done = false;
     bool _right_done = false;
-    bool _skip_current_iter = false;
-    bool _terminate = false;
+    std::atomic<bool> _skip_current_iter {false};
+    std::atomic<bool> _terminate {false};
     std::vector<int> _work;
     std::vector<int> _work_done;
     int _my_rank;
@@ -55,10 +66,6 @@ class KMeansJob : public Job {
     JobResult _internal_result;
     std::unique_ptr<JobTreeBasicAllReduction> _reducer;
 
-    const std::function<float(const float* p1, const float* p2, const size_t dim)> metric =
-        [&](const float* p1, const float* p2, const size_t dim) {
-            return KMeansUtils::eukild(p1, p2, dim);
-        };
     const std::function<std::vector<int>(std::list<std::vector<int>>&)> folder =
         [&](std::list<std::vector<int>>& elems) {
             return aggregate(elems);
@@ -66,16 +73,8 @@ class KMeansJob : public Job {
     const std::function<std::vector<int>(const std::vector<int>&)> rootTransform =
         [&](const std::vector<int>& payload) {
             LOG(V5_DEBG, "KMDBG myIndex: %i start Roottransform\n", _my_index);
-            auto data = reduceToclusterCenters(payload);
-            const int* sumMembers;
-
-            _cluster_centers = data.first;
-            sumMembers = data.second.data();
-            int sum = 0;
-            for (int i = 0; i < _num_clusters; ++i) {
-                sum += sumMembers[i];
-            }
-            
+            sumsToClusterCenters(payload);
+
             auto transformed = clusterCentersToBroadcast(_cluster_centers);
             transformed.push_back(this->getVolume());  // will be countCurrentWorkers
             LOG(V5_DEBG, "KMDBG COMMSIZE: %i myIndex: %i \n",
@@ -167,21 +166,20 @@ class KMeansJob : public Job {
     void doInitWork();
     void sendRootNotification();
     void setRandomStartCenters();
-    void calcNearestCenter(std::function<float(const float* p1, const float* p2, const size_t dim)> metric, int intervalId);
-    void calcCurrentClusterCenters();
+    void calcNearestCenter(int intervalId);
+    bool shouldSkipIteration(int pointID, int endIndex);
+    void initReductionLayout();
+    std::vector<int> calcLocalClusterSums();
     std::string dataToString(std::vector<Point> data);
     std::string dataToString(std::vector<int> data);
-    void countMembers();
     float calculateDifference(std::function<float(const float* p1, const float* p2, const size_t dim)> metric);
     bool centersChanged();
     bool centersChanged(float factor);
     std::vector<float> clusterCentersToSolution();
     std::vector<int> clusterCentersToBroadcast(const std::vector<Point>&);
-    std::vector<Point> broadcastToClusterCenters(const std::vector<int>&);
     void setClusterCenters(const std::vector<int>&);
-    std::vector<int> clusterCentersToReduce(const std::vector<int>&, const std::vector<Point>&);
-    std::pair<std::vector<std::vector<float>>, std::vector<int>> reduceToclusterCenters(const std::vector<int>&);
-    std::vector<int> aggregate(const std::list<std::vector<int>>&);
+    void sumsToClusterCenters(const std::vector<int>&);
+    std::vector<int> aggregate(std::list<std::vector<int>>&);
     void advanceCollective(JobMessage& msg, JobTree& jobTree);
     void initReducer(JobMessage& msg);
     int getIndex(int rank);
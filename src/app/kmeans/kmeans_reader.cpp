@@ -1,12 +1,71 @@
 #include "kmeans_reader.hpp"
 
 #include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <fstream>
 #include <iostream>
 #include <vector>
 
+#include "util/logger.hpp"
 #include "util/sys/terminator.hpp"
+
 bool KMeansReader::read(const std::string &filename, JobDescription &desc) {
+    // Binary files are recognized by their magic bytes
+    char magic[sizeof(BINARY_MAGIC)] = {0};
+    {
+        std::ifstream ifile(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!ifile.is_open()) {
+            std::cerr << "There was a problem opening the input file!\n";
+            return false;
+        }
+        ifile.read(magic, sizeof(magic));
+    }
+    if (memcmp(magic, BINARY_MAGIC, sizeof(magic)) == 0) return readBinary(filename, desc);
+    return readText(filename, desc);
+}
+
+bool KMeansReader::readBinary(const std::string &filename, JobDescription &desc) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+    struct stat s;
+    if (fstat(fd, &s) == -1 || (size_t) s.st_size < sizeof(BinaryHeader)) {
+        close(fd);
+        return false;
+    }
+    const size_t size = s.st_size;
+    void* mmapped = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mmapped == MAP_FAILED) return false;
+    madvise(mmapped, size, MADV_SEQUENTIAL);
+
+    BinaryHeader header;
+    memcpy(&header, mmapped, sizeof(BinaryHeader));
+    const size_t nbValues = header.numPoints * header.dimension;
+    if (header.numClusters <= 0 || header.dimension <= 0 || header.numPoints <= 0 || header.numPoints > INT32_MAX
+            || size < sizeof(BinaryHeader) + nbValues * sizeof(float)) {
+        LOG(V0_CRIT, "[ERROR] Invalid binary k-means dataset %s\n", filename.c_str());
+        munmap(mmapped, size);
+        return false;
+    }
+
+    desc.beginInitialization(0);
+    desc.reserveSize((3 + nbValues) * sizeof(float));
+    desc.addData(header.numClusters);
+    desc.addData(header.dimension);
+    desc.addData((int) header.numPoints);
+    // The matrix already has the layout of the job description's payload
+    desc.addData((const float*) ((const uint8_t*) mmapped + sizeof(BinaryHeader)), nbValues);
+    munmap(mmapped, size);
+
+    desc.endInitialization();
+    return true;
+}
+
+bool KMeansReader::readText(const std::string &filename, JobDescription &desc) {
     /*
     files have to be in format:
     k = k of kmeans
@@ -44,15 +103,15 @@ bool KMeansReader::read(const std::string &filename, JobDescription &desc) {
 
     int skipCols = columnsInFile - dimension;  // dont read the last few columns
 
-    desc.addPermanentData(countClusters);
-    desc.addPermanentData(dimension);
-    desc.addPermanentData(pointsCount);
+    desc.addData(countClusters);
+    desc.addData(dimension);
+    desc.addData(pointsCount);
     //LOG(V5_DEBG, "                          countClusters: %i dimension %i pointsCount: %i columnsInFile: %i skipCols:%i\n", countClusters, dimension, pointsCount, columnsInFile, skipCols);
     float num = 0.0;
     for (int point = 0; point < pointsCount; ++point) {
         for (int entry = 0; entry < dimension; ++entry) {
             ifile >> num;
-            desc.addPermanentData(num);
+            desc.addData(num);
             //if (point < 10) {
             //    LOG(V5_DEBG, "                          num: %f\n", num);
             //}
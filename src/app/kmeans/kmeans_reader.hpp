@@ -1,13 +1,28 @@
-
 #ifndef DOMPASCH_MALLOB_KMEANS_READER_HPP
 #define DOMPASCH_MALLOB_KMEANS_READER_HPP
 
+#include <cstdint>
 #include <string>
 
 #include "data/job_description.hpp"
 
 namespace KMeansReader {
+// Header of the binary dataset format, which is followed by the points as a
+// row-major matrix of numPoints x dimension 32-bit floats (little endian).
+// Files in this format can be created from text files via
+// scripts/setup/convert_kmeans_to_binary.py.
+struct BinaryHeader {
+    char magic[8];  // BINARY_MAGIC
+    int32_t numClusters;
+    int32_t dimension;
+    int64_t numPoints;
+};
+static_assert(sizeof(BinaryHeader) == 24);
+constexpr char BINARY_MAGIC[8] = {'M', 'L', 'B', 'K', 'M', 'N', 'S', '1'};
+
 bool read(const std::string& filename, JobDescription& desc);
+bool readText(const std::string& filename, JobDescription& desc);
+bool readBinary(const std::string& filename, JobDescription& desc);
 };
 
 #endif
@@ -2,9 +2,11 @@
 
 #include <x86intrin.h>
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <vector>
 
@@ -42,6 +44,195 @@ float eukild(const float* p1, const float* p2, const size_t dim) {
 
     return sum;
 }
+void CenterMatrix::set(const std::vector<Point>& centers, int dim) {
+    nbCenters = centers.size();
+    nbCentersPadded = (nbCenters + CENTER_PADDING - 1) / CENTER_PADDING * CENTER_PADDING;
+    dimension = dim;
+    transposed.assign((size_t) dimension * nbCentersPadded, 0);
+    sqNorms.assign(nbCentersPadded, std::numeric_limits<float>::infinity());
+    for (int c = 0; c < nbCenters; ++c) {
+        float sqNorm = 0;
+        for (int d = 0; d < dimension; ++d) {
+            transposed[(size_t) d * nbCentersPadded + c] = centers[c][d];
+            sqNorm += centers[c][d] * centers[c][d];
+        }
+        sqNorms[c] = sqNorm;
+    }
+}
+
+namespace {
+// Clones of the kernel for different instruction sets are selected at load time.
+#if defined(__x86_64__) && defined(__GNUC__)
+#define KMEANS_KERNEL_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define KMEANS_KERNEL_CLONES
+#endif
+
+constexpr int POINT_BLOCK = 4;
+constexpr int CENTER_BLOCK = 64;  // multiple of CenterMatrix::CENTER_PADDING
+
+KMEANS_KERNEL_CLONES
+void nearestCentersKernel(const float* __restrict points, int nbPoints, int dim,
+                          const float* __restrict centersT, const float* __restrict sqNorms, int nbCentersPadded,
+                          int* __restrict nearest, float* __restrict sqDistances, float* __restrict secondSqDistances) {
+    alignas(64) float dots[POINT_BLOCK][CENTER_BLOCK];
+    for (int p0 = 0; p0 < nbPoints; p0 += POINT_BLOCK) {
+        const int np = std::min(POINT_BLOCK, nbPoints - p0);
+        float best[POINT_BLOCK];
+        float secondBest[POINT_BLOCK];
+        int bestIdx[POINT_BLOCK];
+        for (int q = 0; q < POINT_BLOCK; ++q) {
+            best[q] = std::numeric_limits<float>::infinity();
+            secondBest[q] = std::numeric_limits<float>::infinity();
+            bestIdx[q] = -1;
+        }
+        for (int c0 = 0; c0 < nbCentersPadded; c0 += CENTER_BLOCK) {
+            const int nc = std::min(CENTER_BLOCK, nbCentersPadded - c0);
+            // dot products of the block's points with the block's centers
+            for (int q = 0; q < POINT_BLOCK; ++q)
+                for (int c = 0; c < CENTER_BLOCK; ++c) dots[q][c] = 0;
+            for (int d = 0; d < dim; ++d) {
+                const float* __restrict row = centersT + (size_t) d * nbCentersPadded + c0;
+                for (int q = 0; q < np; ++q) {
+                    const float x = points[(size_t) (p0 + q) * dim + d];
+                    float* __restrict dotsOfPoint = dots[q];
+                    for (int c = 0; c < nc; ++c) dotsOfPoint[c] += x * row[c];
+                }
+            }
+            // ||x||^2 is the same for all centers, so it is irrelevant for the minimum
+            for (int q = 0; q < np; ++q) {
+                for (int c = 0; c < nc; ++c) {
+                    const float dist = sqNorms[c0 + c] - 2 * dots[q][c];
+                    if (dist < best[q]) {
+                        secondBest[q] = best[q];
+                        best[q] = dist;
+                        bestIdx[q] = c0 + c;
+                    } else if (dist < secondBest[q]) {
+                        secondBest[q] = dist;
+                    }
+                }
+            }
+        }
+        for (int q = 0; q < np; ++q) {
+            nearest[p0 + q] = bestIdx[q];
+            if (!sqDistances && !secondSqDistances) continue;
+            const float* x = points + (size_t) (p0 + q) * dim;
+            float sqNorm = 0;
+            for (int d = 0; d < dim; ++d) sqNorm += x[d] * x[d];
+            if (sqDistances) sqDistances[p0 + q] = std::max(0.0f, sqNorm + best[q]);
+            if (secondSqDistances) secondSqDistances[p0 + q] = std::max(0.0f, sqNorm + secondBest[q]);
+        }
+    }
+}
+}  // namespace
+
+void nearestCenters(const float* points, int nbPoints, const CenterMatrix& centers,
+                    int* nearest, float* sqDistances, float* secondSqDistances) {
+    nearestCentersKernel(points, nbPoints, centers.dimension, centers.transposed.data(),
+                         centers.sqNorms.data(), centers.nbCentersPadded, nearest, sqDistances, secondSqDistances);
+}
+
+void BoundedAssignment::init(int nbPoints) {
+    _assignment.assign(nbPoints, -1);
+    _upper_bounds.assign(nbPoints, 0);
+    _lower_bounds.assign(nbPoints, 0);
+    _bounds_version.assign(nbPoints, -1);
+}
+
+void BoundedAssignment::updateCenters(const std::vector<Point>& centers, const CenterMatrix& matrix) {
+    if (centers == _bounds_centers) return;
+    const int nbCenters = centers.size();
+    const int dimension = matrix.dimension;
+    const bool comparable = _bounds_centers.size() == centers.size();
+    _center_drift.assign(nbCenters, 0);
+    _max_drift_center = -1;
+    _max_drift = 0;
+    _second_max_drift = 0;
+    for (int c = 0; c < nbCenters; ++c) {
+        if (!comparable) break;
+        const float drift = std::sqrt(eukild(_bounds_centers[c].data(), centers[c].data(), dimension));
+        _center_drift[c] = drift;
+        if (drift > _max_drift) {
+            _second_max_drift = _max_drift;
+            _max_drift = drift;
+            _max_drift_center = c;
+        } else if (drift > _second_max_drift) {
+            _second_max_drift = drift;
+        }
+    }
+    // Bounds of a version other than the previous one cannot be updated
+    _centers_version += comparable ? 1 : 2;
+    _bounds_centers = centers;
+
+    // A point whose distance to its center is at most half the distance of this center
+    // to any other center cannot be closer to another center
+    _center_half_gaps.assign(nbCenters, std::numeric_limits<float>::infinity());
+    _max_center_sq_norm = 0;
+    for (int c = 0; c < nbCenters; ++c) {
+        _max_center_sq_norm = std::max(_max_center_sq_norm, matrix.sqNorms[c]);
+        for (int other = c + 1; other < nbCenters; ++other) {
+            const float halfGap = 0.5f * std::sqrt(eukild(centers[c].data(), centers[other].data(), dimension));
+            _center_half_gaps[c] = std::min(_center_half_gaps[c], halfGap);
+            _center_half_gaps[other] = std::min(_center_half_gaps[other], halfGap);
+        }
+    }
+}
+
+// Hamerly's algorithm: the points which cannot be skipped are gathered
+// and handed to the distance kernel in bulk.
+void BoundedAssignment::assign(const float* points, int from, int to, const CenterMatrix& matrix, int* nearest) {
+    const int dimension = matrix.dimension;
+    std::vector<int> toScan;
+    for (int pointID = from; pointID < to; ++pointID) {
+        const int version = _bounds_version[pointID];
+        if (version < _centers_version - 1) {
+            toScan.push_back(pointID);
+            continue;
+        }
+        const int center = _assignment[pointID];
+        if (version == _centers_version - 1) {
+            // Update the bounds w.r.t. the centers' movement
+            _upper_bounds[pointID] += _center_drift[center];
+            _lower_bounds[pointID] -= center == _max_drift_center ? _second_max_drift : _max_drift;
+            _bounds_version[pointID] = _centers_version;
+        }
+        const float threshold = std::max(_center_half_gaps[center], _lower_bounds[pointID]);
+        if (_upper_bounds[pointID] > threshold) {
+            // Tighten the upper bound to the exact distance and check again
+            _upper_bounds[pointID] = std::sqrt(eukild(points + (size_t) pointID * dimension, _bounds_centers[center].data(), dimension));
+            if (_upper_bounds[pointID] > threshold) {
+                toScan.push_back(pointID);
+                continue;
+            }
+        }
+        nearest[pointID] = center;
+    }
+    if (toScan.empty()) return;
+
+    // Compute all distances for the remaining points
+    const int nbScan = toScan.size();
+    std::vector<float> scanPoints((size_t) nbScan * dimension);
+    for (int i = 0; i < nbScan; ++i) {
+        const float* point = points + (size_t) toScan[i] * dimension;
+        std::copy(point, point + dimension, scanPoints.data() + (size_t) i * dimension);
+    }
+    std::vector<int> scanNearest(nbScan);
+    std::vector<float> secondSqDistances(nbScan);
+    nearestCenters(scanPoints.data(), nbScan, matrix, scanNearest.data(), nullptr, secondSqDistances.data());
+    for (int i = 0; i < nbScan; ++i) {
+        const int pointID = toScan[i];
+        const float* point = scanPoints.data() + (size_t) i * dimension;
+        nearest[pointID] = scanNearest[i];
+        _assignment[pointID] = scanNearest[i];
+        _upper_bounds[pointID] = std::sqrt(eukild(point, _bounds_centers[scanNearest[i]].data(), dimension));
+        // The kernel's distances may suffer from cancellation: subtract a bound on the rounding error
+        const float pointSqNorm = std::inner_product(point, point + dimension, point, 0.0f);
+        const float slack = 4 * dimension * std::numeric_limits<float>::epsilon() * (pointSqNorm + _max_center_sq_norm);
+        _lower_bounds[pointID] = std::sqrt(std::max(0.0f, secondSqDistances[i] - slack));
+        _bounds_version[pointID] = _centers_version;
+    }
+}
+
 // childIndexesOf(1, 12) = [3, 4, 7, 8, 9, 10]
 std::vector<int> childIndexesOf(int parentIndex, int jobVolume) {
     std::vector<int> indexList;
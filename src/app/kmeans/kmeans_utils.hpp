@@ -1,4 +1,8 @@
+#pragma once
+
+#include <cmath>
 #include <string>
+#include <vector>
 
 #include "data/job_description.hpp"
 
@@ -6,4 +10,59 @@ namespace KMeansUtils {
     typedef std::vector<float> Point;
     float eukild(const float* p1, const float* p2, const size_t dim);
     std::vector<int> childIndexesOf(int parentIndex, int jobVolume);
+
+    // Contiguous layout of the cluster centers for computing the nearest centers of
+    // many points at once: the centers are stored dimension by dimension ("transposed")
+    // and padded to a multiple of CENTER_PADDING, together with their squared norms.
+    struct CenterMatrix {
+        static constexpr int CENTER_PADDING = 16;
+        int nbCenters {0};
+        int nbCentersPadded {0};
+        int dimension {0};
+        std::vector<float> transposed;  // entry d*nbCentersPadded + c: center c at dimension d
+        std::vector<float> sqNorms;     // padded centers have an infinite norm
+        void set(const std::vector<Point>& centers, int dimension);
+    };
+    // Writes the index of the nearest center (w.r.t. the Euclidean distance) of each of
+    // the given nbPoints consecutive points to nearest and, if provided, the according
+    // squared distance to sqDistances and the squared distance to the second nearest center
+    // to secondSqDistances. Distances are computed as ||x||^2 - 2 x.c + ||c||^2
+    // over blocks of points and centers, using AVX-512 or AVX2 if supported.
+    void nearestCenters(const float* points, int nbPoints, const CenterMatrix& centers,
+                        int* nearest, float* sqDistances = nullptr, float* secondSqDistances = nullptr);
+    // Hamerly-style distance bounds per point, which allow to skip the distance
+    // computations of most points once the assignments have mostly settled.
+    class BoundedAssignment {
+    public:
+        void init(int nbPoints);
+        // Checks whether the centers changed since the last call. If so, computes how far each
+        // center moved, which then widens the bounds of points which refer to the previous centers.
+        // To be called whenever the centers are updated, after setting matrix to the new centers.
+        void updateCenters(const std::vector<Point>& centers, const CenterMatrix& matrix);
+        // Writes the nearest center of each point in [from, to) to nearest, as nearestCenters
+        // would, skipping all points whose bounds prove that their nearest center did not change.
+        // Disjoint ranges may be assigned concurrently.
+        void assign(const float* points, int from, int to, const CenterMatrix& matrix, int* nearest);
+    private:
+        std::vector<int> _assignment;       // nearest center last found for each point
+        std::vector<float> _upper_bounds;   // bound on the distance of each point to its assigned center
+        std::vector<float> _lower_bounds;   // bound on the distance of each point to all other centers
+        std::vector<int> _bounds_version;   // version of the centers the bounds refer to (-1: none)
+        int _centers_version = 0;
+        std::vector<Point> _bounds_centers;    // centers of version _centers_version
+        std::vector<float> _center_drift;      // distance each center moved since the previous version
+        std::vector<float> _center_half_gaps;  // half the distance of each center to its nearest other center
+        int _max_drift_center = -1;
+        float _max_drift = 0;
+        float _second_max_drift = 0;
+        float _max_center_sq_norm = 0;
+    };
+    // Adds value to sum, keeping track of the lost low-order bits in compensation
+    // (Kahan-Babuska). The compensated sum is sum + compensation.
+    inline void addCompensated(double& sum, double& compensation, double value) {
+        const double newSum = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) compensation += (sum - newSum) + value;
+        else compensation += (value - newSum) + sum;
+        sum = newSum;
+    }
 };  // namespace KMeansUtils
@@ -2,8 +2,13 @@
 #pragma once
 
 #include "optionslist.hpp"
+#include "util/option.hpp"
 
-// Add your application-specific options here
+// Application-specific program options for k-means clustering.
+// memberName                               short option name, long option name          default   min  max
 
-// OPTION_GROUP(grpAppYourapp, "app/yourappkey", "Options for application XXX")
-// OPT_* ...
+OPTION_GROUP(grpAppKmeans, "app/kmeans", "K-means clustering options")
+
+OPT_INT(kmeansThreads, "kmeans-threads", "", 0, 0, 256, "Number of threads per worker to assign points to their nearest centers (0: number of threads per process)")
+OPT_BOOL(kmeansPruning, "kmeans-prune", "", true, "Skip distance computations via Hamerly-style bounds on each point's distances to the centers")
+OPT_BOOL(kmeansExactSums, "kmeans-exact-sums", "", true, "Reduce cluster sums as 64-bit fixed-point integers, rendering the centers independent of the job tree's shape (otherwise: compensated double sums)")
@@ -3,8 +3,11 @@
 set(KMEANS_SOURCES src/app/kmeans/kmeans_job.cpp src/app/kmeans/kmeans_reader.cpp src/app/kmeans/kmeans_utils.cpp)
 
 # Add these sources to Mallob's base sources
-set(BASE_SOURCES ${BASE_SOURCES} ${KMEANS_SOURCES} CACHE INTERNAL "")
+set(MALLOB_COREPLUSCOMM_SOURCES ${MALLOB_COREPLUSCOMM_SOURCES} ${KMEANS_SOURCES} CACHE INTERNAL "")
 
 #message("commons+DUMMY sources: ${BASE_SOURCES}") # Use to debug
 
+# Add unit tests
+new_test(kmeans_utils "${BASE_INCLUDES}" mallob_corepluscomm)
+
 # Done!
@@ -4,6 +4,7 @@
 #include "app/maxsat/maxsat_instance.hpp"
 #include "util/logger.hpp"
 #include <functional>
+#include <vector>
 
 void cardinality_encoding_add_literal(int lit, void* instance);
 void cardinality_encoding_add_assumption(int lit, void* instance);
@@ -17,6 +18,14 @@ public:
     void setAssumptionCollector(std::function<void(int)> assumptionCollector) {
         _assumption_collector = assumptionCollector;
     }
+    // Bulk alternative to the collectors: the encoding appends its literals
+    // directly to the given vectors, without an indirect call per literal.
+    void setClauseBuffer(std::vector<int>* clauseBuffer) {
+        _clause_buffer = clauseBuffer;
+    }
+    void setAssumptionBuffer(std::vector<int>* assumptionBuffer) {
+        _assumption_buffer = assumptionBuffer;
+    }
     void encode(size_t lb, size_t ub, size_t max) {
         //int guardVar = prepareGuardVariable();
         doEncode(lb, ub, max);
@@ -33,6 +42,8 @@ protected:
     unsigned int _nb_vars;
     std::function<void(int)> _clause_collector;
     std::function<void(int)> _assumption_collector;
+    std::vector<int>* _clause_buffer {nullptr};
+    std::vector<int>* _assumption_buffer {nullptr};
     virtual void doEncode(size_t min, size_t ub, size_t max) = 0;
     virtual void doEnforce(size_t bound) = 0;
     int prepareGuardVariable() {
@@ -55,10 +66,18 @@ protected:
     }
 private:
     void addLiteral(int lit) {
+        if (_clause_buffer) {
+            _clause_buffer->push_back(lit);
+            return;
+        }
         LOG(V6_DEBGV, "CARDI ADD %i\n", lit);
         _clause_collector(lit);
     }
     void addAssumption(int lit) {
+        if (_assumption_buffer) {
+            _assumption_buffer->push_back(lit);
+            return;
+        }
         LOG(V6_DEBGV, "CARDI ASSUME %i\n", lit);
         _assumption_collector(lit);
     }
@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+
+// Totalizer over a set of input literals whose outputs are created lazily:
+// output k (1-based) is implied whenever at least k inputs are true, but only
+// the outputs (and clauses) up to the largest k requested so far are encoded.
+// Increasing k later on only adds the missing clauses, so the encoding can be
+// extended incrementally across SAT calls of an incremental solver.
+// Only the direction "sum >= k implies output k" is encoded, which suffices
+// for assuming negated outputs (i.e., upper bounds on the number of true inputs).
+class IncrementalTotalizer {
+
+private:
+    struct Node {
+        int left {-1};
+        int right {-1};
+        size_t nbInputs {0};
+        std::vector<int> outputs; // outputs[j-1] <=> at least j inputs of this subtree
+    };
+    std::vector<Node> _nodes;
+    int _root {-1};
+
+    unsigned int& _nb_vars;
+    std::function<void(int)> _clause_collector;
+
+public:
+    IncrementalTotalizer(const std::vector<int>& inputs, unsigned int& nbVars, std::function<void(int)> clauseCollector) :
+            _nb_vars(nbVars), _clause_collector(clauseCollector) {
+        assert(!inputs.empty());
+        _nodes.reserve(2*inputs.size());
+        // Leaves
+        std::vector<int> level;
+        for (int lit : inputs) {
+            _nodes.push_back(Node{-1, -1, 1, {lit}});
+            level.push_back(_nodes.size()-1);
+        }
+        // Inner nodes, built bottom-up as a balanced binary tree
+        while (level.size() > 1) {
+            std::vector<int> nextLevel;
+            for (size_t i = 0; i+1 < level.size(); i += 2) {
+                Node node;
+                node.left = level[i];
+                node.right = level[i+1];
+                node.nbInputs = _nodes[node.left].nbInputs + _nodes[node.right].nbInputs;
+                _nodes.push_back(std::move(node));
+                nextLevel.push_back(_nodes.size()-1);
+            }
+            if (level.size() % 2 == 1) nextLevel.push_back(level.back());
+            level = std::move(nextLevel);
+        }
+        _root = level.front();
+    }
+
+    size_t getNbInputs() const {
+        return _nodes[_root].nbInputs;
+    }
+
+    // Returns the literal which is implied to be true if at least k inputs are true,
+    // encoding any missing parts of the totalizer first. Requires 1 <= k <= #inputs.
+    int getOutput(size_t k) {
+        assert(k >= 1 && k <= getNbInputs());
+        extend(_root, k);
+        return _nodes[_root].outputs[k-1];
+    }
+
+private:
+    void extend(int nodeIdx, size_t k) {
+        k = std::min(k, _nodes[nodeIdx].nbInputs);
+        const size_t prevK = _nodes[nodeIdx].outputs.size();
+        if (k <= prevK) return; // also covers leaves
+        const int left = _nodes[nodeIdx].left;
+        const int right = _nodes[nodeIdx].right;
+        extend(left, k);
+        extend(right, k);
+
+        auto& outputs = _nodes[nodeIdx].outputs;
+        while (outputs.size() < k) outputs.push_back(++_nb_vars);
+        const auto& leftOut = _nodes[left].outputs;
+        const auto& rightOut = _nodes[right].outputs;
+        // For each pair (a, b) with prevK < a+b <= k: left sum >= a AND right sum >= b => sum >= a+b.
+        // All pairs with a+b <= prevK have been encoded before.
+        for (size_t a = 0; a <= leftOut.size(); a++) {
+            for (size_t b = (a > prevK ? 0 : prevK+1-a); b <= rightOut.size() && a+b <= k; b++) {
+                if (a+b == 0) continue;
+                if (a > 0) addLiteral(-leftOut[a-1]);
+                if (b > 0) addLiteral(-rightOut[b-1]);
+                addLiteral(outputs[a+b-1]);
+                addLiteral(0);
+            }
+        }
+    }
+
+    void addLiteral(int lit) {
+        LOG(V6_DEBGV, "ITOT ADD %i\n", lit);
+        _clause_collector(lit);
+    }
+};
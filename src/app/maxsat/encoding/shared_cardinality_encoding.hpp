@@ -0,0 +1,123 @@
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "app/maxsat/encoding/cardinality_encoding.hpp"
+#include "robin_map.h"
+#include "util/assert.hpp"
+#include "util/hashing.hpp"
+#include "util/logger.hpp"
+#include "util/sys/threading.hpp"
+
+// Wraps a cardinality encoding of the objective function such that several search
+// procedures can use (and extend) one and the same encoding concurrently.
+// The permanent literals emitted by each encoding call form one immutable segment
+// of a log, and each user keeps a cursor into this log (the number of segments received).
+// For a bound, a user receives the log up to and including the segment in which the bound
+// was encoded, since a bound's clauses may build upon any earlier clauses of the encoding.
+// Segments appended later for other users' bounds are only received when needed.
+// Each bound (together with the range it was encoded for) is encoded only once, and the
+// assumptions enforcing it are computed only once as well.
+class SharedCardinalityEncoding {
+
+private:
+    struct BoundKey {
+        size_t min;
+        size_t ub;
+        size_t max;
+        bool operator==(const BoundKey& other) const {
+            return min == other.min && ub == other.ub && max == other.max;
+        }
+    };
+    struct BoundKeyHasher {
+        size_t operator()(const BoundKey& key) const {
+            size_t h = 17;
+            hash_combine(h, key.min);
+            hash_combine(h, key.ub);
+            hash_combine(h, key.max);
+            return h;
+        }
+    };
+    struct EncodedBound {
+        size_t nbSegments; // size of the log after the bound was encoded
+        std::vector<int> assumptions;
+    };
+
+    // Serializes all calls to the underlying encoding.
+    Mutex _enc_mtx;
+    std::unique_ptr<CardinalityEncoding> _enc;
+    std::vector<int> _clause_buffer;
+    std::vector<int> _assumption_buffer;
+
+    // Protects the log and the table of encoded bounds. Only held briefly,
+    // so that users of encoded bounds are not blocked by a running encoding.
+    Mutex _log_mtx;
+    std::vector<std::shared_ptr<const std::vector<int>>> _segments;
+    tsl::robin_map<BoundKey, EncodedBound, BoundKeyHasher> _encoded_bounds;
+    size_t _nb_lits {0};
+    size_t _nb_requests {0};
+    size_t _nb_reused {0};
+
+public:
+    SharedCardinalityEncoding(CardinalityEncoding* enc) : _enc(enc) {
+        _enc->setClauseBuffer(&_clause_buffer);
+        _enc->setAssumptionBuffer(&_assumption_buffer);
+    }
+
+    // Makes sure that the encoding can enforce the bound ub (within the range [min, max])
+    // and appends the according assumptions to `assumptions`. All literals of the encoding
+    // which are required for this bound and have not been received yet, i.e., from segment
+    // `cursor` onwards, are appended to `lits`, and the cursor is advanced accordingly.
+    // Thread-safe.
+    void encodeAndEnforce(size_t min, size_t ub, size_t max, size_t& cursor,
+            std::vector<int>& lits, std::vector<int>& assumptions) {
+        const BoundKey key {min, ub, max};
+        size_t nbSegments;
+        if (!tryGetEncodedBound(key, nbSegments, assumptions)) {
+            auto encLock = _enc_mtx.getLock();
+            // Another user may have encoded the bound in the meantime
+            if (!tryGetEncodedBound(key, nbSegments, assumptions)) {
+                _clause_buffer.clear();
+                _assumption_buffer.clear();
+                _enc->encode(min, ub, max);
+                _enc->enforceBound(ub);
+                assumptions.insert(assumptions.end(), _assumption_buffer.begin(), _assumption_buffer.end());
+                auto logLock = _log_mtx.getLock();
+                _nb_requests++;
+                _nb_lits += _clause_buffer.size();
+                _segments.emplace_back(new std::vector<int>(std::move(_clause_buffer)));
+                nbSegments = _segments.size();
+                _encoded_bounds.insert({key, EncodedBound {nbSegments, _assumption_buffer}});
+            }
+        }
+
+        // Fetch the segments to receive, then copy them without holding any lock
+        std::vector<std::shared_ptr<const std::vector<int>>> segments;
+        {
+            auto logLock = _log_mtx.getLock();
+            assert(nbSegments <= _segments.size());
+            for (size_t i = cursor; i < nbSegments; i++) segments.push_back(_segments[i]);
+        }
+        for (auto& segment : segments) lits.insert(lits.end(), segment->begin(), segment->end());
+        cursor = std::max(cursor, nbSegments);
+    }
+
+    ~SharedCardinalityEncoding() {
+        LOG(V3_VERB, "MAXSAT encoding: %lu lits, %lu bounds requested, %lu of them reused\n",
+            _nb_lits, _nb_requests, _nb_reused);
+    }
+
+private:
+    bool tryGetEncodedBound(const BoundKey& key, size_t& nbSegments, std::vector<int>& assumptions) {
+        auto lock = _log_mtx.getLock();
+        auto it = _encoded_bounds.find(key);
+        if (it == _encoded_bounds.end()) return false;
+        _nb_requests++;
+        _nb_reused++;
+        nbSegments = it->second.nbSegments;
+        assumptions.insert(assumptions.end(), it->second.assumptions.begin(), it->second.assumptions.end());
+        return true;
+    }
+};
@@ -0,0 +1,256 @@
+
+#pragma once
+
+#include "app/incsat/inc_sat_controller.hpp"
+#include "app/maxsat/encoding/incremental_totalizer.hpp"
+#include "app/maxsat/maxsat_instance.hpp"
+#include "app/maxsat/solution_writer.hpp"
+#include "app/sat/job/sat_constants.h"
+#include "core/dtask_tracker.hpp"
+#include "interface/api/api_connector.hpp"
+#include "robin_map.h"
+#include "robin_set.h"
+#include "util/logger.hpp"
+#include "util/params.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <memory>
+#include <vector>
+
+// Core-guided lower-bounding search (OLL with stratification) which runs on a Mallob
+// job stream of its own, concurrently to the solution-improving MaxSatSearchProcedures.
+// Each SAT call assumes that no cost is incurred by the objective terms (and sums of
+// terms) whose remaining weight is at least the current stratum. An UNSAT result comes
+// with the failed assumptions, i.e., a core: its minimum weight is added to the lower
+// bound and its terms are relaxed into an incremental totalizer, whose next output
+// is assumed with the core's weight from then on. A SAT result provides a solution
+// and lets the search descend to the next stratum. If all assumptions of the lowest
+// stratum hold, the lower bound is proven to be the optimal cost.
+class MaxSatCoreGuidedSearch {
+
+private:
+    const Parameters& _params; // configuration, cmd line arguments
+    JobDescription& _desc; // contains our instance to solve and all metadata
+    MaxSatInstance& _instance;
+    const std::string _label;
+    int _nb_orig_vars;
+    unsigned int _nb_vars;
+
+    std::unique_ptr<IncSatController> _stream_wrapper;
+
+    // vector of 0-separated (hard) clauses to add in the next SAT call
+    std::vector<int> _lits_to_add;
+    // assumptions of the current (or last) SAT call
+    std::vector<int> _assumptions;
+    bool _solving {false};
+    bool _initialized {false};
+    bool _done {false};
+
+    // remaining weight of each assumption literal ("this cost is not incurred")
+    tsl::robin_map<int, size_t> _weights;
+    // assumptions which negate a totalizer output: the totalizer and the output's bound
+    struct SumAssumption {
+        int totalizerIdx;
+        size_t bound;
+    };
+    tsl::robin_map<int, SumAssumption> _sums;
+    std::vector<std::unique_ptr<IncrementalTotalizer>> _totalizers;
+
+    size_t _stratum {0}; // minimum weight of assumptions in the next SAT call
+    size_t _lower_bound {0};
+    int _nb_cores {0};
+
+    std::shared_ptr<SolutionWriter> _sol_writer;
+
+public:
+    MaxSatCoreGuidedSearch(const Parameters& params, APIConnector& api, JobDescription& desc, DTaskTracker& tracker,
+            MaxSatInstance& instance, const std::string& label) :
+        _params(params), _desc(desc), _instance(instance), _label(label),
+        _nb_orig_vars(instance.nbVars), _nb_vars(instance.nbVars),
+        _lits_to_add(_instance.formulaData, _instance.formulaData+_instance.formulaSize) {
+
+        _stream_wrapper.reset(new IncSatController(_params, api, _desc, tracker));
+        // No cross-sharing group: the totalizers' variables are specific to this search
+        _stream_wrapper->initInteractiveSolving();
+
+        // A term (factor, lit) incurs its cost iff lit is true
+        for (auto& term : _instance.objective) _weights[-term.lit] += term.factor;
+        _stratum = 1;
+        if (_params.maxSatCoreStratification()) {
+            for (auto& [lit, weight] : _weights) _stratum = std::max(_stratum, weight);
+        }
+    }
+
+    void setSolutionWriter(std::shared_ptr<SolutionWriter> solutionWriter) {
+        _sol_writer = solutionWriter;
+    }
+
+    bool isSolving() const {
+        return _solving;
+    }
+    bool isDone() const {
+        return _done;
+    }
+    size_t getLowerBound() const {
+        return _lower_bound;
+    }
+
+    void solveNonblocking() {
+        assert(!_solving && !_done);
+
+        _assumptions.clear();
+        for (auto& [lit, weight] : _weights) if (weight >= _stratum) _assumptions.push_back(lit);
+        std::sort(_assumptions.begin(), _assumptions.end());
+        LOG(V2_INFO, "MAXSAT %s Calling SAT (%lu new lits, %lu/%lu assumptions, stratum %lu, %i cores)\n",
+            _label.c_str(), _lits_to_add.size(), _assumptions.size(), _weights.size(), _stratum, _nb_cores);
+
+        if (!_initialized && _stream_wrapper->hasStream()) {
+            _stream_wrapper->getMallobProcessor()->setInitialSize(
+                _instance.nbVars,
+                _desc.getAppConfiguration().fixedSizeEntryToInt("__NC"));
+            _initialized = true;
+        }
+
+        _stream_wrapper->solveNextRevisionNonblocking(std::move(_lits_to_add),
+            std::vector<int>(_assumptions));
+        _lits_to_add.clear();
+        _solving = true;
+    }
+    bool isNonblockingSolvePending() {
+        return _stream_wrapper->getStream().isNonblockingSolvePending() && _solving;
+    }
+    int processNonblockingSolveResult() {
+        _solving = false;
+
+        auto [resultCode, solution] = _stream_wrapper->getStream().getNonblockingSolveResult();
+        if (resultCode == RESULT_SAT) {
+            handleSolution(solution);
+            return RESULT_SAT;
+        }
+        if (resultCode == RESULT_UNSAT) {
+            // The result holds the failed assumptions (possibly followed by other data)
+            tsl::robin_set<int> assumed(_assumptions.begin(), _assumptions.end());
+            std::vector<int> core;
+            for (int lit : solution) {
+                if (assumed.erase(lit)) core.push_back(lit);
+            }
+            if (core.empty()) {
+                LOG(V2_INFO, "MAXSAT %s Hard clauses unsat\n", _label.c_str());
+                _done = true;
+                return RESULT_UNSAT;
+            }
+            relaxCore(core);
+            return RESULT_UNSAT;
+        }
+        // UNKNOWN or something else - presumably because the job was interrupted
+        LOG(V2_INFO, "MAXSAT %s Call returned UNKNOWN\n", _label.c_str());
+        _done = true;
+        return RESULT_UNKNOWN;
+    }
+
+    void interrupt() {
+        assert(_solving);
+        if (_stream_wrapper->getStream().interrupt())
+            LOG(V2_INFO, "MAXSAT %s Interrupt core-guided solving\n", _label.c_str());
+    }
+
+    void finalize() {
+        _stream_wrapper->finalize();
+    }
+
+    ~MaxSatCoreGuidedSearch() {
+        finalize();
+    }
+
+private:
+    void relaxCore(const std::vector<int>& core) {
+        size_t minWeight = ULONG_MAX;
+        for (int lit : core) minWeight = std::min(minWeight, _weights[lit]);
+        _lower_bound += minWeight;
+        _nb_cores++;
+
+        std::vector<int> costLits;
+        for (int lit : core) {
+            auto it = _weights.find(lit);
+            if (it->second == minWeight) _weights.erase(it);
+            else it.value() -= minWeight;
+            costLits.push_back(-lit);
+
+            // Relaxed a sum "at most (bound-1) true": assume "at most bound true" next
+            auto sumIt = _sums.find(lit);
+            if (sumIt == _sums.end()) continue;
+            auto [totalizerIdx, bound] = sumIt->second;
+            auto& totalizer = *_totalizers[totalizerIdx];
+            if (bound+1 <= totalizer.getNbInputs()) {
+                const int nextLit = -totalizer.getOutput(bound+1);
+                _weights[nextLit] += minWeight;
+                _sums[nextLit] = {totalizerIdx, bound+1};
+            }
+        }
+
+        if (core.size() == 1) {
+            // The single term must incur its cost
+            appendLiteral(costLits.front());
+            appendLiteral(0);
+        } else {
+            // At least one of the core's terms incurs its cost: assume that at most one does
+            _totalizers.emplace_back(new IncrementalTotalizer(costLits, _nb_vars,
+                [&](int lit) {appendLiteral(lit);}));
+            const int sumLit = -_totalizers.back()->getOutput(2);
+            _weights[sumLit] += minWeight;
+            _sums[sumLit] = {(int) _totalizers.size()-1, 2};
+        }
+
+        LOG(V3_VERB, "MAXSAT %s Core #%i of size %lu and weight %lu - lower bound %lu\n",
+            _label.c_str(), _nb_cores, core.size(), minWeight, _lower_bound);
+        updateLowerBound(_lower_bound);
+    }
+
+    void handleSolution(const std::vector<int>& solution) {
+        const size_t cost = _instance.getCostOfModel(solution);
+        if (cost < _instance.bestCost) {
+            _instance.upperBound = std::min(_instance.upperBound, cost);
+            _instance.bestCost = cost;
+            _instance.bestSolution = solution;
+            _instance.bestSolution.resize(_nb_orig_vars+1); // truncate to original variables
+            _instance.bestSolutionPreprocessLayer = _instance.preprocessLayer;
+            LOG(V2_INFO, "MAXSAT %s Stratum %lu solved with cost %lu - new bounds: (%lu,%lu)\n",
+                _label.c_str(), _stratum, cost, _instance.lowerBound, _instance.upperBound);
+            if (_sol_writer) _sol_writer->appendSolution(cost, solution);
+            if (_instance.intervalSearch)
+                _instance.intervalSearch->stopTestingAndUpdateUpper(ULONG_MAX, cost);
+        } else {
+            LOG(V2_INFO, "MAXSAT %s Stratum %lu solved with cost %lu - bounds unchanged\n",
+                _label.c_str(), _stratum, cost);
+        }
+
+        // Descend to the next lower stratum of remaining weights
+        size_t nextStratum = 0;
+        for (auto& [lit, weight] : _weights) if (weight < _stratum) nextStratum = std::max(nextStratum, weight);
+        if (nextStratum > 0) {
+            _stratum = nextStratum;
+            return;
+        }
+        // All assumptions hold, so the solution's cost matches the lower bound
+        LOG(V2_INFO, "MAXSAT %s Lowest stratum solved with cost %lu after %i cores (lower bound %lu)\n",
+            _label.c_str(), cost, _nb_cores, _lower_bound);
+        updateLowerBound(_lower_bound);
+        _done = true;
+    }
+
+    void updateLowerBound(size_t lowerBound) {
+        if (lowerBound <= _instance.lowerBound) return;
+        _instance.lowerBound = lowerBound;
+        LOG(V2_INFO, "MAXSAT %s Lower bound %lu - new bounds: (%lu,%lu)\n",
+            _label.c_str(), lowerBound, _instance.lowerBound, _instance.upperBound);
+        if (_instance.intervalSearch)
+            _instance.intervalSearch->stopTestingAndUpdateLower(lowerBound-1);
+    }
+
+    // Add a permanent literal to the next SAT call. (0 = end of clause)
+    void appendLiteral(int lit) {
+        LOG(V6_DEBGV, "MAXSAT %s Append lit %i\n", _label.c_str(), lit);
+        _lits_to_add.push_back(lit);
+    }
+};
@@ -5,6 +5,7 @@
 #include "app/maxsat/encoding/cardinality_encoding.hpp"
 #include "app/maxsat/encoding/generalized_totalizer.hpp"
 #include "app/maxsat/encoding/polynomial_watchdog.hpp"
+#include "app/maxsat/encoding/shared_cardinality_encoding.hpp"
 #include "app/maxsat/encoding/warners_adder.hpp"
 #include "app/sat/stream/internal_sat_job_stream_processor.hpp"
 #include "app/sat/stream/mallob_sat_job_stream_processor.hpp"
@@ -84,7 +85,8 @@ private:
     std::vector<int> _assumptions_to_persist_upon_sat;
 
     EncodingStrategy _encoding_strat;
-    std::shared_ptr<CardinalityEncoding> _enc;
+    std::shared_ptr<SharedCardinalityEncoding> _enc;
+    size_t _enc_cursor {0}; // number of the encoding's log segments received so far
     volatile bool _is_encoding {false};
     volatile bool _is_done_encoding {false};
     std::future<void> _future_encoder;
@@ -106,7 +108,8 @@ private:
 
 public:
     MaxSatSearchProcedure(const Parameters& params, APIConnector& api, JobDescription& desc, DTaskTracker& tracker,
-            MaxSatInstance& instance, EncodingStrategy encStrat, SearchStrategy searchStrat, const std::string& label) :
+            MaxSatInstance& instance, EncodingStrategy encStrat, SearchStrategy searchStrat, const std::string& label,
+            std::shared_ptr<SharedCardinalityEncoding> sharedEnc = {}) :
         _params(params), _api(api), _desc(desc), _instance(instance),
         _lits_to_add(_instance.formulaData, _instance.formulaData+_instance.formulaSize),
         _current_bound(ULONG_MAX), _encoding_strat(encStrat), _search_strat(searchStrat), _label(label) {
@@ -115,16 +118,8 @@ public:
 
         _nb_orig_vars = _instance.nbVars; // before cardinality constraint encodings!
 
-        if (encStrat == WARNERS_ADDER)
-            _enc.reset(new WarnersAdder(_instance.nbVars, _instance.objective));
-        if (encStrat == DYNAMIC_POLYNOMIAL_WATCHDOG)
-            _enc.reset(new PolynomialWatchdog(_instance.nbVars, _instance.objective));
-        if (encStrat == GENERALIZED_TOTALIZER)
-            _enc.reset(new GeneralizedTotalizer(_instance.nbVars, _instance.objective));
-        if (_enc) {
-            _enc->setClauseCollector([&](int lit) {appendLiteral(lit);});
-            _enc->setAssumptionCollector([&](int lit) {appendAssumption(lit);});
-        }
+        // Use the provided encoding shared with other searches or else an encoding of our own
+        _enc = sharedEnc ? sharedEnc : createEncoding(encStrat, _instance);
 
         if (_encoding_strat == VIRTUAL) {
             LOG(V2_INFO, "MAXSAT Setting up virtual \"theory\" encoding ...\n");
@@ -147,6 +142,18 @@ public:
         }
     }
 
+    static std::shared_ptr<SharedCardinalityEncoding> createEncoding(EncodingStrategy encStrat, const MaxSatInstance& instance) {
+        CardinalityEncoding* enc {nullptr};
+        if (encStrat == WARNERS_ADDER)
+            enc = new WarnersAdder(instance.nbVars, instance.objective);
+        if (encStrat == DYNAMIC_POLYNOMIAL_WATCHDOG)
+            enc = new PolynomialWatchdog(instance.nbVars, instance.objective);
+        if (encStrat == GENERALIZED_TOTALIZER)
+            enc = new GeneralizedTotalizer(instance.nbVars, instance.objective);
+        if (!enc) return {};
+        return std::shared_ptr<SharedCardinalityEncoding>(new SharedCardinalityEncoding(enc));
+    }
+
     void setSolutionWriter(std::shared_ptr<SolutionWriter> solutionWriter) {
         _sol_writer = solutionWriter;
     }
@@ -183,9 +190,9 @@ public:
         if (_enc) {
             _future_encoder = ProcessWideThreadPool::get().addTask([&, min=globalLowerBound, ub=_current_bound, max=globalUpperBound]() {
                 CoreAllocator::Allocation ca(1);
-                _enc->encode(min, ub, max);
-                // Enforce our current bound (assumptions only)
-                _enc->enforceBound(ub);
+                // Encode the bound (unless already present) and enforce it via assumptions.
+                // Fetches all of the encoding's literals which we did not receive yet.
+                _enc->encodeAndEnforce(min, ub, max, _enc_cursor, _lits_to_add, _assumptions_to_set);
                 // If the result is SAT, we can add the 1st assumption permanently.
                 //if (!_assumptions_to_set.empty())
                 //    _assumptions_to_persist_upon_sat.push_back(_assumptions_to_set.front());
@@ -489,8 +496,4 @@ private:
         LOG(V6_DEBGV, "MAXSAT %s Append lit %i\n", _label.c_str(), lit);
         _lits_to_add.push_back(lit);
     }
-    // Append an assumption for the next SAT call.
-    void appendAssumption(int lit) {
-        _assumptions_to_set.push_back(lit);
-    }
 };
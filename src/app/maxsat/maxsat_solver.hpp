@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "app/maxsat/maxsat_core_guided_search.hpp"
 #include "app/maxsat/maxsat_instance.hpp"
 #include "app/maxsat/maxsat_search_procedure.hpp"
 #include "app/maxsat/parse/maxsat_reader.hpp"
@@ -79,6 +80,8 @@ private:
     DTaskTracker _dtask_tracker;
 
     std::list<std::unique_ptr<MaxSatSearchProcedure>> searches;
+    // optional core-guided search which improves the lower bound
+    std::unique_ptr<MaxSatCoreGuidedSearch> _core_guided_search;
 
     MessageSubscription _sub_xtcs_incoming_clauses;
     Mutex _mtx_incoming_messages;
@@ -155,6 +158,10 @@ public:
         size_t nbSearchers = std::min((size_t)_params.maxSatNumSearchers(), (_instance->upperBound - _instance->lowerBound) + 1);
         std::string searchStrats = std::string(nbSearchers, 'd');
         const int nbWorkers = _params.numWorkers() == -1 ? MyMpi::size(MPI_COMM_WORLD) : _params.numWorkers();
+        // Optionally, all searches share one incrementally extended encoding of the objective
+        std::shared_ptr<SharedCardinalityEncoding> sharedEnc;
+        if (_params.maxSatShareEncoding())
+            sharedEnc = MaxSatSearchProcedure::createEncoding(_encoding_strat, *_instance);
         // Loop over each specified search strategy
         for (int i = 0; i < searchStrats.size(); i++) {
             char c = searchStrats[i];
@@ -165,11 +172,11 @@ public:
                 break;
             }
             // Initialize search procedure
-            searches.emplace_back(initializeSearchProcedure(c, i, searchStrats.size()));
+            searches.emplace_back(initializeSearchProcedure(c, i, searchStrats.size(), sharedEnc));
             searches.back()->setDescriptionLabelForNextCall("base-formula-" + std::to_string(updateLayer));
 
-            // While everybody uses their own encoder, we can put all of them in the same cross-sharing group
-            // due to the consistent naming of variables across all encoders.
+            // Whether everybody uses the shared encoder or their own encoder, we can put all of them in the
+            // same cross-sharing group due to the consistent naming of variables across all encoders.
             searches.back()->setGroupId("consistent-logic-" + std::to_string(updateLayer)/*, 1, _instance->nbVars*/);
 
             if (writer) searches.back()->setSolutionWriter(writer);
@@ -231,6 +238,13 @@ public:
                 std::min(_instance->upperBound, _instance->bestCost-1));
         }
 
+        // Launch the core-guided search for lower bounds, if desired and a worker is left for it
+        if (_params.maxSatCoreGuided() && nbWorkers > searches.size()) {
+            _core_guided_search.reset(new MaxSatCoreGuidedSearch(_params, _api, _desc, _dtask_tracker,
+                *_instance, std::to_string(searches.size()) + ":OLL"));
+            if (writer) _core_guided_search->setSolutionWriter(writer);
+        }
+
         // Main loop for solution improving search.
         std::list<std::unique_ptr<MaxSatSearchProcedure>> searchesToFinalize;
         bool changeSinceLastFocus = true;
@@ -282,6 +296,8 @@ public:
                     change = true;
                 }
             }
+            if (_core_guided_search && advanceCoreGuidedSearch())
+                change = true;
             if (stagnation || _instance->lowerBound >= _instance->bestCost)
                 break;
 
@@ -355,6 +371,7 @@ public:
                     // cleanup (has to happen before update)
                     LOG(V2_INFO, "MAXSAT improvement found by MaxPRE: restart searches\n");
                     tryStopAllSearches(searches);
+                    stopCoreGuidedSearch();
                     if (!isTimeoutHit()) {
                         for (auto& search : searches) searchesToFinalize.push_back(std::move(search));
                         searches.clear();
@@ -376,6 +393,7 @@ public:
 
         LOG(V4_VVER, "MAXSAT trying to stop all searches ...\n");
         tryStopAllSearches(searches);
+        stopCoreGuidedSearch();
 
         // Did we find *some* solution?
         if (_instance->bestCost < ULONG_MAX) {
@@ -612,7 +630,8 @@ private:
         return MaxSatSearchProcedure::DYNAMIC_POLYNOMIAL_WATCHDOG;
     }
 
-    MaxSatSearchProcedure* initializeSearchProcedure(char c, int index, int nbTotal) {
+    MaxSatSearchProcedure* initializeSearchProcedure(char c, int index, int nbTotal,
+            std::shared_ptr<SharedCardinalityEncoding> sharedEnc) {
         // Parse search strategy
         MaxSatSearchProcedure::SearchStrategy searchStrat;
         std::string label = std::to_string(index) + ":";
@@ -637,7 +656,7 @@ private:
         }
         // Initialize search procedure
         auto p = new MaxSatSearchProcedure(_params, _api, _desc, _dtask_tracker,
-            *_instance, _encoding_strat, searchStrat, label);
+            *_instance, _encoding_strat, searchStrat, label, sharedEnc);
         return p;
     }
 
@@ -658,6 +677,32 @@ private:
         return false;
     }
 
+    // Processes a finished SAT call of the core-guided search and launches the next one.
+    // Returns true iff anything changed.
+    bool advanceCoreGuidedSearch() {
+        auto& search = *_core_guided_search;
+        if (search.isSolving() && !search.isNonblockingSolvePending()) {
+            (void) search.processNonblockingSolveResult();
+            return true;
+        }
+        if (!search.isSolving() && !search.isDone() && _instance->lowerBound < _instance->bestCost) {
+            search.solveNonblocking();
+            return true;
+        }
+        return false;
+    }
+
+    void stopCoreGuidedSearch() {
+        if (!_core_guided_search) return;
+        auto& search = *_core_guided_search;
+        while (search.isSolving()) {
+            if (!search.isNonblockingSolvePending()) search.processNonblockingSolveResult();
+            else search.interrupt();
+            usleep(1000 * 1); // 1 ms
+        }
+        _core_guided_search.reset();
+    }
+
     void tryStopAllSearches(std::list<std::unique_ptr<MaxSatSearchProcedure>>& searches) {
         while (true) {
             bool allIdle = true;
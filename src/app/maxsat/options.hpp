@@ -15,6 +15,10 @@ OPT_INT(maxSatFocusMin, "maxsat-focus-min", "", 1, 1, LARGE_INT, "Minimum number
 OPT_INT(maxSatNumSearchers, "maxsat-searchers", "", 1, 1, LARGE_INT, "Number of searchers to run in parallel")
 OPT_FLOAT(maxSatIntervalSkew, "maxsat-interval-skew", "", 0.5, 0, 1, "Skew to cut search intervals with")
 OPT_STRING(maxSatSolutionFile, "maxsat-sol-file", "", "", "Path to file to write intermediate solutions to")
+OPT_BOOL(maxSatShareEncoding, "maxsat-share-enc", "", false, "Let all searchers share (and incrementally extend) a single cardinality encoding of the objective")
+OPT_BOOL(maxSatCoreGuided, "maxsat-cg", "", false, "Run a core-guided (OLL) lower-bounding search concurrently to the solution-improving searches")
+OPT_BOOL(maxSatCoreStratification, "maxsat-cg-strat", "", true, "Stratify the core-guided search by descending weights")
+OPT_INT(maxSatParseThreads, "maxsat-parse-threads", "", 4, 1, 64, "Number of threads to parse large uncompressed WCNF files with")
 OPT_BOOL(maxSatWriteJobLiterals, "maxsat-write-job-lits", "", false, "Output all submitted jobs' literals into files for debugging")
 
 #if MALLOB_USE_MAXPRE == 1
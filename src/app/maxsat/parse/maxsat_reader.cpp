@@ -10,6 +10,7 @@
 #include <fstream>
 #include <map>
 #include <memory>
+#include <thread>
 #include <vector>
 
 #if MALLOB_USE_MAXPRE == 1
@@ -59,9 +60,13 @@ bool MaxSatReader::parseInternally(JobDescription& desc) {
 		desc.reserveSize(size / sizeof(int));
 		void* mmapped = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
 
-		char* f = (char*) mmapped;
-		for (long i = 0; i < size; i++) {
-			process(f[i], desc);
+		const char* f = (const char*) mmapped;
+		const int nbThreads = _params.maxSatParseThreads();
+		if (nbThreads > 1 && size >= MIN_SIZE_FOR_PARALLEL_PARSING) {
+			madvise(mmapped, size, MADV_WILLNEED);
+			parseInParallel(f, size, nbThreads, desc);
+		} else {
+			process(f, f+size, desc);
 		}
 		process(EOF, desc);
 
@@ -102,6 +107,50 @@ bool MaxSatReader::parseInternally(JobDescription& desc) {
 	return true;
 }
 
+void MaxSatReader::parseInParallel(const char* data, size_t size, int nbThreads, JobDescription& desc) {
+
+	// Split the content into chunks of roughly equal size which begin at the start of a line.
+	// Since every line is self-contained, a fresh reader can parse each chunk.
+	std::vector<size_t> chunkBegins {0};
+	for (int i = 1; i < nbThreads; i++) {
+		size_t pos = std::max(chunkBegins.back(), (size_t) (size * (double) i / nbThreads));
+		const char* newline = pos < size ? (const char*) memchr(data+pos, '\n', size-pos) : nullptr;
+		pos = newline ? newline-data+1 : size;
+		if (pos > chunkBegins.back() && pos < size) chunkBegins.push_back(pos);
+	}
+	chunkBegins.push_back(size);
+	const int nbChunks = chunkBegins.size()-1;
+
+	std::vector<std::unique_ptr<MaxSatReader>> readers(nbChunks);
+	std::vector<LiteralBuffer> buffers(nbChunks);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < nbChunks; i++) {
+		readers[i].reset(new MaxSatReader(_params, _filename));
+		threads.emplace_back([&, i]() {
+			const char* begin = data + chunkBegins[i];
+			const char* end = data + chunkBegins[i+1];
+			buffers[i].data.reserve((end-begin) / sizeof(int));
+			readers[i]->process(begin, end, buffers[i]);
+			// conclude a last line without a line break
+			readers[i]->process('\n', buffers[i]);
+		});
+	}
+	for (auto& thread : threads) thread.join();
+
+	// Concatenate the chunks' results in order
+	for (int i = 0; i < nbChunks; i++) {
+		auto& reader = *readers[i];
+		for (int lit : buffers[i].data) desc.addData(lit);
+		std::vector<int>().swap(buffers[i].data);
+		_objective.insert(_objective.end(), reader._objective.begin(), reader._objective.end());
+		_max_var = std::max(_max_var, reader._max_var);
+		_num_read_clauses += reader._num_read_clauses;
+		_contains_empty_clause |= reader._contains_empty_clause;
+		_input_invalid |= reader._input_invalid;
+	}
+	LOG(V3_VERB, "MAXSAT parsed %lu bytes in %i chunks\n", size, nbChunks);
+}
+
 bool MaxSatReader::read(JobDescription& desc) {
 
 	auto& config = desc.getAppConfiguration();
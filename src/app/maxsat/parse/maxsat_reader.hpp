@@ -5,8 +5,10 @@
 #include <stdio.h>
 #include <bits/std_abs.h>
 #include <stdlib.h>
+#include <string.h>
 #include <string>
 #include <algorithm>
+#include <vector>
 
 #include "data/job_description.hpp"
 
@@ -38,14 +40,41 @@ private:
     bool _input_invalid {false};
     bool _input_finished {false};
 
+    // Plain files of at least this size are parsed by multiple threads
+    static constexpr size_t MIN_SIZE_FOR_PARALLEL_PARSING = 1UL << 24;
+    // Receives the literals parsed from one chunk of the input
+    struct LiteralBuffer {
+        std::vector<int> data;
+        inline void addData(int lit) {data.push_back(lit);}
+    };
+
 public:
     MaxSatReader(const Parameters& params, const std::string& filename) : 
         _params(params), _filename(filename) {}
     bool read(JobDescription& desc);
     bool parseInternally(JobDescription& desc);
     bool parseWithTrustedParser(JobDescription& desc);
+    // Parses the given (complete) file content with the given number of threads, each of which
+    // processes a chunk of consecutive lines. The chunks' results are concatenated in order,
+    // so the resulting description is the same as when processing the content sequentially.
+    void parseInParallel(const char* data, size_t size, int nbThreads, JobDescription& desc);
+
+    // Processes a range of characters, skipping over comment lines in bulk.
+    template <typename T>
+    inline void process(const char* begin, const char* end, T& desc) {
+        const char* c = begin;
+        while (c < end) {
+            if (_comment) {
+                c = (const char*) memchr(c, '\n', end-c);
+                if (!c) return;
+            }
+            process(*c, desc);
+            c++;
+        }
+    }
 
-    inline void process(char c, JobDescription& desc) {
+    template <typename T>
+    inline void process(char c, T& desc) {
 
         if (_comment && c != '\n') return;
 
@@ -23,6 +23,9 @@ endif()
 # Add unit tests: for each $arg there must be a standalone cpp file under "test/test_${arg}.cpp".
 new_test(rustsat_encoders "${BASE_INCLUDES}" mallob_core)
 new_test(interval_search "${BASE_INCLUDES}" mallob_core)
+new_test(incremental_totalizer "${BASE_INCLUDES}" mallob_core)
+new_test(shared_cardinality_encoding "${BASE_INCLUDES}" mallob_corepluscomm)
+new_test(maxsat_reader "${BASE_INCLUDES}" mallob_corepluscomm)
 if(NOT MALLOB_USE_KISSAT EQUAL 0)
     new_test(cardinality_encoding "${BASE_INCLUDES}" "mallob_corepluscomm;mallob_sat_subproc")
 endif()
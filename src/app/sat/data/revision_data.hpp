@@ -6,4 +6,6 @@
 struct RevisionData {
     std::shared_ptr<std::vector<int>> fLits;
     Checksum chksum;
+    // fLits holds plain clause literals: no compression, no signature, no assumptions
+    bool decoded {false};
 };
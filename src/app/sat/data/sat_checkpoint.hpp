@@ -0,0 +1,137 @@
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "data/checksum.hpp"
+#include "util/params.hpp"
+#include "util/sys/threading.hpp"
+#include "util/sys/tmpdir.hpp"
+
+// Checkpoint of the learned clauses of a SAT engine's solvers. It is written when
+// a suspended job node is dropped from a worker and read when the same job node
+// is started again, on the same machine or (via a shared file system) on another one.
+// Since job IDs are only unique within a run, a checkpoint also carries a checksum of
+// the job's formula and the nonce of the run it was written in; it may only be restored
+// if both match (see isCompatible).
+// File layout: MAGIC, VERSION, job ID, revision, run nonce, #solvers, formula checksum
+// (count, value); then for each solver the number of ints followed by a sequence of
+// clauses as (size, lbd, lits...).
+struct SatCheckpoint {
+
+    static constexpr int MAGIC = 0x504b434d; // "MCKP"
+    static constexpr int VERSION = 2;
+
+    int jobId {-1};
+    int revision {-1}; // the learned clauses are implied by this revision of the formula
+    int runNonce {0};
+    Checksum formulaChecksum; // of the job's first revision
+    std::vector<std::vector<int>> clausesPerSolver;
+
+    static std::string getDirectory(const Parameters& params) {
+        return params.checkpointDirectory.isSet() ?
+            params.checkpointDirectory() : TmpDir::getMachineLocalTmpDir();
+    }
+    static std::string getPath(const std::string& directory, int jobId, int appRank) {
+        return directory + "/edu.kit.iti.mallob.checkpoint.#" + std::to_string(jobId) + "." + std::to_string(appRank);
+    }
+    // Glob pattern matching the checkpoints of all nodes of a job
+    static std::string getPathPattern(const std::string& directory, int jobId) {
+        return directory + "/edu.kit.iti.mallob.checkpoint.#" + std::to_string(jobId) + ".*";
+    }
+
+    static Checksum getFormulaChecksum(const std::vector<int>& formula) {
+        Checksum chksum;
+        for (int x : formula) chksum.combine(x);
+        return chksum;
+    }
+
+    bool isCompatible(int jobId, const Checksum& formulaChecksum, int runNonce) const {
+        return this->jobId == jobId && this->formulaChecksum == formulaChecksum
+            && this->runNonce == runNonce;
+    }
+
+    bool write(const std::string& path) const {
+        // Write to a temporary file first so that no reader sees a partial checkpoint
+        const std::string tmpPath = path + "~";
+        FILE* f = fopen(tmpPath.c_str(), "wb");
+        if (!f) return false;
+        int header[] {MAGIC, VERSION, jobId, revision, runNonce, (int) clausesPerSolver.size()};
+        size_t chksum[] {formulaChecksum.count(), formulaChecksum.get()};
+        bool ok = fwrite(header, sizeof(int), 6, f) == 6
+            && fwrite(chksum, sizeof(size_t), 2, f) == 2;
+        for (auto& clauses : clausesPerSolver) {
+            if (!ok) break;
+            size_t size = clauses.size();
+            ok = fwrite(&size, sizeof(size_t), 1, f) == 1
+                && fwrite(clauses.data(), sizeof(int), size, f) == size;
+        }
+        ok = fclose(f) == 0 && ok;
+        if (!ok || ::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            ::remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool read(const std::string& path) {
+        FILE* f = fopen(path.c_str(), "rb");
+        if (!f) return false;
+        int header[6];
+        size_t chksum[2];
+        bool ok = fread(header, sizeof(int), 6, f) == 6 && header[0] == MAGIC
+            && header[1] == VERSION && header[5] >= 0
+            && fread(chksum, sizeof(size_t), 2, f) == 2;
+        if (ok) {
+            jobId = header[2];
+            revision = header[3];
+            runNonce = header[4];
+            formulaChecksum = Checksum(chksum[0], chksum[1]);
+            clausesPerSolver.resize(header[5]);
+        }
+        for (size_t i = 0; ok && i < clausesPerSolver.size(); i++) {
+            size_t size;
+            ok = fread(&size, sizeof(size_t), 1, f) == 1;
+            if (!ok) break;
+            clausesPerSolver[i].resize(size);
+            ok = fread(clausesPerSolver[i].data(), sizeof(int), size, f) == size;
+        }
+        fclose(f);
+        if (!ok) clausesPerSolver.clear();
+        return ok;
+    }
+};
+
+// Bounded collection of the clauses a solver most recently exported,
+// from which a checkpoint of the solver can be written at any time.
+class LearnedClauseReservoir {
+
+private:
+    Mutex _mtx;
+    std::vector<int> _buffer; // sequence of (size, lbd, lits...)
+    const size_t _capacity;
+
+public:
+    LearnedClauseReservoir(size_t capacity) : _capacity(capacity) {}
+
+    void add(const int* lits, int size, int lbd, const std::vector<int>& conditionalLits) {
+        auto lock = _mtx.getLock();
+        _buffer.push_back(size + conditionalLits.size());
+        _buffer.push_back(lbd);
+        _buffer.insert(_buffer.end(), lits, lits+size);
+        _buffer.insert(_buffer.end(), conditionalLits.begin(), conditionalLits.end());
+        if (_buffer.size() > _capacity) {
+            // Drop the older half of the clauses at once (amortized constant time per clause)
+            size_t pos = 0;
+            while (pos < _buffer.size()/2) pos += 2 + _buffer[pos];
+            _buffer.erase(_buffer.begin(), _buffer.begin()+pos);
+        }
+    }
+
+    std::vector<int> extract() {
+        auto lock = _mtx.getLock();
+        return std::move(_buffer);
+    }
+};
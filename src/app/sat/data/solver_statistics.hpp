@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
 
 class ClauseHistogram;
@@ -29,6 +30,10 @@ struct SolverStatistics {
 	unsigned long receivedClausesDigested = 0;
 	unsigned long receivedClausesDropped = 0;
 
+	// import utility: solver-side counters at the last sample
+	unsigned long importedAtLastSample = 0;
+	unsigned long discardedAtLastSample = 0;
+
 	std::string getReport() const {
 		return "pps:" + std::to_string(propagations)
 			+ " dcs:" + std::to_string(decisions)
@@ -45,12 +50,25 @@ struct SolverStatistics {
 			+ ") + intim:" + std::to_string(imported) + "/" + std::to_string(imported+discarded);
 	}
 
+	// Adds the number of delivered clauses which the solver kept (i.e., did not discard
+	// at import) since the last sample as well as the total number of delivered clauses.
+	void sampleImportUtility(unsigned long& nbKept, unsigned long& nbDelivered) {
+		unsigned long newImported = imported - std::min(imported, importedAtLastSample);
+		unsigned long newDiscarded = discarded - std::min(discarded, discardedAtLastSample);
+		nbKept += newImported;
+		nbDelivered += newImported + newDiscarded;
+		importedAtLastSample = imported;
+		discardedAtLastSample = discarded;
+	}
+
 	void aggregate(const SolverStatistics& other) {
 		propagations += other.propagations;
 		decisions += other.decisions;
 		conflicts += other.conflicts;
 		restarts += other.restarts;
 		memPeak += other.memPeak;
+		imported += other.imported;
+		discarded += other.discarded;
 		producedClauses += other.producedClauses;
 		producedClausesAdmitted += other.producedClausesAdmitted;
 		producedClausesFiltered += other.producedClausesFiltered;
@@ -5,11 +5,14 @@
 #include "app/sat/data/clause_metadata.hpp"
 #include "app/sat/data/portfolio_sequence.hpp"
 #include "app/sat/data/revision_data.hpp"
+#include "app/sat/data/sat_checkpoint.hpp"
 #include "app/sat/data/theories/theory_specification.hpp"
+#include "app/sat/parse/serialized_formula_parser.hpp"
 #include "app/sat/solvers/solver_portfolio_config.hpp"
 #include "app/sat/solvers/solving_replay.hpp"
 #include "util/logger.hpp"
 #include "util/sys/fileutils.hpp"
+#include "util/sys/numa.hpp"
 #include "util/sys/thread_pool.hpp"
 #include "util/sys/timer.hpp"
 #include "data/app_configuration.hpp"
@@ -201,10 +204,6 @@ SatEngine::SatEngine(const Parameters& params, const SatProcessConfig& config, L
 		}
 		*solverToAdd += numFullCycles + (i < begunCyclePos);
 	}
-	if (config.incremental && hasPseudoincrementalSolvers) {
-		LOG(V0_CRIT, "[ERROR] Non-incremental solvers are currently unsupported for incremental jobs.\n");
-		abort();
-	}
 
 	// Solver-agnostic options each solver in the portfolio will receive
 	SolverSetup setup;
@@ -231,6 +230,9 @@ SatEngine::SatEngine(const Parameters& params, const SatProcessConfig& config, L
 	setup.numBufferedClsGenerations = params.bufferedImportedClsGenerations();
 	setup.skipClauseSharingDiagonally = params.skipClauseSharingDiagonally();
 	setup.adaptiveImportManager = params.adaptiveImportManager();
+	if (params.satNumaPlacement()) Numa::init(); // before any solver thread is pinned
+	if (params.checkpointSuspendedJobs() && !ClauseMetadata::enabled())
+		setup.checkpointReservoirSize = params.checkpointLitsPerSolver();
 	setup.maxNumSolvers = config.mpisize * params.numThreadsPerProcess();
 	setup.numVars = numVars;
 	setup.numOriginalClauses = numClauses;
@@ -262,6 +264,7 @@ SatEngine::SatEngine(const Parameters& params, const SatProcessConfig& config, L
 	int cyclePos = begunCyclePos;
 	for (setup.localId = 0; setup.localId < _num_solvers; setup.localId++) {
 		setup.globalId = appRank * numOrigSolvers + setup.localId;
+		if (params.satNumaPlacement()) setup.numaNode = Numa::getNodeForIndex(setup.localId);
 
 		// Which solver? Which diversification?
 		PortfolioSequence::Item item;
@@ -306,6 +309,14 @@ SatEngine::SatEngine(const Parameters& params, const SatProcessConfig& config, L
 		if (mclc) modelCheckingLratConnector = mclc;
 	}
 	_base_solver_setup = setup;
+	if (setup.hasPseudoincrementalSolvers) {
+		if (params.onTheFlyChecking() || params.forceIncrementalTrustedParser()) {
+			// Proof checkers need to see each revision's original payload again
+			_keep_revision_data = true;
+		} else {
+			_formula_snapshot.reset(new std::vector<int>());
+		}
+	}
 
 	_sharing_manager.reset(new SharingManager(_solver_interfaces, _params, _logger, 
 		/*max. deferred literals per solver=*/5*config.maxBroadcastedLitsPerCycle, config.apprank));
@@ -390,7 +401,7 @@ void SatEngine::appendRevision(int revision, RevisionData data, bool lastRevisio
 		if (revision == 0) {
 			// Initialize solver thread
 			_solver_threads.emplace_back(new SolverThread(
-				_params, _config, _solver_interfaces[i], data, i
+				_params, _config, _solver_interfaces[i], data, i, _on_state_change
 			));
 		} else {
 			if (_solver_interfaces[i]->getSolverSetup().doIncrementalSolving) {
@@ -420,23 +431,52 @@ void SatEngine::appendRevision(int revision, RevisionData data, bool lastRevisio
 				SolverSetup s = _solver_interfaces[i]->getSolverSetup();
 				s.solverRevision++;
 				_solver_interfaces[i] = createSolver(s);
-				_solver_threads[i] = std::shared_ptr<SolverThread>(new SolverThread(
-					_params, _config, _solver_interfaces[i], _revision_data[0], i
-				));
-				// Load entire formula 
-				for (int importedRevision = 1; importedRevision <= revision; importedRevision++) {
-					auto data = _revision_data[importedRevision];
-					_solver_threads[i]->appendRevision(importedRevision, data);
+				if (_formula_snapshot) {
+					// Load all previous revisions at once from the parsed snapshot,
+					// then only the newest revision needs to be parsed
+					_solver_threads[i] = std::shared_ptr<SolverThread>(new SolverThread(
+						_params, _config, _solver_interfaces[i], RevisionData {_formula_snapshot, Checksum(), true}, i, _on_state_change
+					));
+					auto emptyRevision = RevisionData {std::shared_ptr<std::vector<int>>(new std::vector<int>()), Checksum(), true};
+					for (int importedRevision = 1; importedRevision < revision; importedRevision++) {
+						_solver_threads[i]->appendRevision(importedRevision, emptyRevision);
+					}
+					_solver_threads[i]->appendRevision(revision, data);
+				} else {
+					_solver_threads[i] = std::shared_ptr<SolverThread>(new SolverThread(
+						_params, _config, _solver_interfaces[i], _revision_data[0], i, _on_state_change
+					));
+					// Load entire formula 
+					for (int importedRevision = 1; importedRevision <= revision; importedRevision++) {
+						auto data = _revision_data[importedRevision];
+						_solver_threads[i]->appendRevision(importedRevision, data);
+					}
 				}
 				_sharing_manager->continueClauseImport(i);
 				if (_solvers_started) _solver_threads[i]->start();
 			}
 		}
 	}
-	_revision_data.back().fLits.reset(); // formula increment no longer needed here
+	if (_formula_snapshot) appendToFormulaSnapshot(data);
+	if (!_keep_revision_data)
+		_revision_data.back().fLits.reset(); // formula increment no longer needed here
 	_revision = revision;
 }
 
+void SatEngine::appendToFormulaSnapshot(RevisionData& data) {
+	// A solver thread may still be reading the current snapshot: copy on write
+	if (_formula_snapshot.use_count() > 1)
+		_formula_snapshot.reset(new std::vector<int>(*_formula_snapshot));
+	SerializedFormulaParser parser(_logger, data.fLits);
+	if (_params.compressFormula()) parser.setCompressed();
+	const int* chunk;
+	size_t chunkSize;
+	while (parser.getNextLiteralChunk(chunk, chunkSize, /*maxChunkSize=*/1<<16)) {
+		_formula_snapshot->insert(_formula_snapshot->end(), chunk, chunk+chunkSize);
+	}
+	LOGGER(_logger, V5_DEBG, "Formula snapshot: %lu lits\n", _formula_snapshot->size());
+}
+
 void SatEngine::solve() {
 	assert(_revision >= 0);
 	_result.result = UNKNOWN;
@@ -558,14 +598,14 @@ void SatEngine::addSharingEpoch(int epoch) {
 	_sharing_manager->addSharingEpoch(epoch);
 }
 
-void SatEngine::digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>& filter) {
+void SatEngine::digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>& filter, int epoch) {
 	if (isCleanedUp()) return;
-	_sharing_manager->digestSharingWithFilter(clauseBuf, &filter);
+	_sharing_manager->digestSharingWithFilter(clauseBuf, &filter, epoch);
 }
 
-void SatEngine::digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless) {
+void SatEngine::digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless, int epoch) {
 	if (isCleanedUp()) return;
-	_sharing_manager->digestSharingWithoutFilter(clauseBuf, stateless);
+	_sharing_manager->digestSharingWithoutFilter(clauseBuf, stateless, epoch);
 }
 
 void SatEngine::returnClauses(std::vector<int>& clauseBuf) {
@@ -578,6 +618,44 @@ void SatEngine::digestHistoricClauses(int epochBegin, int epochEnd, std::vector<
 	_sharing_manager->digestHistoricClauses(epochBegin, epochEnd, clauseBuf);
 }
 
+bool SatEngine::writeCheckpoint(const std::string& path, int revision, const Checksum& formulaChecksum, int runNonce) {
+	if (isCleanedUp()) return false;
+	SatCheckpoint checkpoint;
+	checkpoint.jobId = _job_id;
+	checkpoint.revision = revision;
+	checkpoint.formulaChecksum = formulaChecksum;
+	checkpoint.runNonce = runNonce;
+	size_t nbInts = 0;
+	for (auto& solver : _solver_interfaces) {
+		if (!solver) continue;
+		checkpoint.clausesPerSolver.push_back(solver->extractCheckpointClauses());
+		nbInts += checkpoint.clausesPerSolver.back().size();
+	}
+	if (!checkpoint.write(path)) {
+		LOGGER(_logger, V1_WARN, "[WARN] Could not write checkpoint to %s\n", path.c_str());
+		return false;
+	}
+	LOGGER(_logger, V3_VERB, "wrote checkpoint of %lu solvers (%lu ints) to %s\n",
+		checkpoint.clausesPerSolver.size(), nbInts, path.c_str());
+	return true;
+}
+
+void SatEngine::restoreCheckpoint(SatCheckpoint& checkpoint) {
+	if (isCleanedUp() || _solver_interfaces.empty()) return;
+	// The number of solvers may have changed: distribute the checkpointed clauses round robin
+	size_t nbClauses = 0;
+	for (size_t i = 0; i < checkpoint.clausesPerSolver.size(); i++) {
+		auto& solver = _solver_interfaces[i % _solver_interfaces.size()];
+		if (!solver) continue;
+		auto& clauses = checkpoint.clausesPerSolver[i];
+		for (size_t pos = 0; pos+1 < clauses.size(); pos += 2 + clauses[pos]) {
+			solver->addLearnedClause(Mallob::Clause(clauses.data()+pos+2, clauses[pos], clauses[pos+1]));
+			nbClauses++;
+		}
+	}
+	LOGGER(_logger, V3_VERB, "restored %lu clauses of rev. %i from checkpoint\n", nbClauses, checkpoint.revision);
+}
+
 void SatEngine::syncDeterministicSolvingAndCheckForLocalWinner() {
 	if (_block_result) {
 		_block_result = !_sharing_manager->syncDeterministicSolvingAndCheckForWinningSolver();
@@ -605,7 +683,7 @@ void SatEngine::setActiveThreadCount(int nbThreads) {
 		_solver_interfaces[i] = createSolver(s);
 		auto movedThread = std::move(_solver_threads[i]);
 		_solver_threads[i] = std::shared_ptr<SolverThread>(new SolverThread(
-			_params, _config, _solver_interfaces[i], {}, i
+			_params, _config, _solver_interfaces[i], {}, i, _on_state_change
 		));
 		_num_active_solvers--;
 		_solver_thread_cleanups.push_back(ProcessWideThreadPool::get().addTask([thread = std::move(movedThread), solver = std::move(movedSolver)]() mutable {
@@ -638,6 +716,22 @@ void SatEngine::dumpStats(bool final) {
 	}
 	_logger.log(verb, "%s%s\n", final ? "END " : "", solveStats.getReport().c_str());
 
+	// NUMA page allocation statistics (system-wide) since the last report
+	if (_params.satNumaPlacement()) {
+		auto numaStats = Numa::getNodeStats();
+		for (size_t i = 0; i < numaStats.size(); i++) {
+			auto& st = numaStats[i];
+			unsigned long local = st.localPages, remote = st.remotePages;
+			if (i < _last_numa_stats.size()) {
+				local -= _last_numa_stats[i].localPages;
+				remote -= _last_numa_stats[i].remotePages;
+			}
+			_logger.log(verb, "%snuma node%i localpages:%lu remotepages:%lu\n",
+				final ? "END " : "", st.node, local, remote);
+		}
+		_last_numa_stats = std::move(numaStats);
+	}
+
 	// Sharing statistics
 	SharingStatistics shareStats;
 	if (_sharing_manager != NULL) shareStats = _sharing_manager->getStatistics();
@@ -681,7 +775,9 @@ SatEngine::LastAdmittedStats SatEngine::getLastAdmittedClauseShare() {
 	return LastAdmittedStats {
 		_sharing_manager->getLastNumAdmittedClausesToImport(), 
 		_sharing_manager->getLastNumClausesToImport(),
-		_sharing_manager->getLastNumAdmittedLitsToImport()
+		_sharing_manager->getLastNumAdmittedLitsToImport(),
+		_sharing_manager->getLastNumKeptImports(),
+		_sharing_manager->getLastNumDeliveredImports()
 	};
 }
 
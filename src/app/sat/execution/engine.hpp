@@ -13,6 +13,7 @@
 #include "app/sat/data/theories/integer_rule.hpp"
 #include "app/sat/sharing/filter/clause_prefilter.hpp"
 #include "util/sys/threading.hpp"
+#include "util/sys/numa.hpp"
 #include "util/logger.hpp"
 #include "../sharing/sharing_manager.hpp"
 #include "solver_thread.hpp"
@@ -26,6 +27,7 @@ class Logger;
 class PortfolioSolverInterface;
 class SharingManager;
 struct SolverSetup;
+struct SatCheckpoint;
 
 class SatEngine {
 
@@ -49,6 +51,10 @@ private:
 	std::list<std::future<void>> _solver_thread_cleanups;
 
 	std::vector<RevisionData> _revision_data;
+	// Parsed clause literals of all revisions imported so far, from which
+	// pseudo-incremental solvers are restarted without re-parsing each revision
+	std::shared_ptr<std::vector<int>> _formula_snapshot;
+	bool _keep_revision_data {false};
 	
 	bool _solvers_started = false;
 	volatile SolvingStates::SolvingState _state;
@@ -63,11 +69,19 @@ private:
 
 	std::vector<int> _preprocessed_formula;
 
+	std::vector<Numa::NodeStats> _last_numa_stats;
+
+	// Invoked by solver threads on state changes which solveLoop() and isFullyInitialized() report
+	std::function<void()> _on_state_change {[]() {}};
+
 public:
 
     SatEngine(const Parameters& params, const SatProcessConfig& config, Logger& loggingInterface);
 	~SatEngine();
 
+	// Must be set before the first revision is appended
+	void setStateChangeCallback(std::function<void()> callback) {_on_state_change = callback;}
+
 	void solve();
 	void setClauseBufferRevision(int revision);
 	void appendRevision(int revision, RevisionData data, bool lastRevisionForNow = true);
@@ -81,15 +95,20 @@ public:
 	std::vector<int> prepareSharing(int literalLimit, int& outSuccessfulSolverId, int& outNbLits);
 	std::vector<int> filterSharing(std::vector<int>& clauseBuf);
 	void addSharingEpoch(int epoch);
-	void digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>& filter);
-	void digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless);
+	void digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>& filter, int epoch);
+	void digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless, int epoch);
 	void returnClauses(std::vector<int>& clauseBuf);
 	void digestHistoricClauses(int epochBegin, int epochEnd, std::vector<int>& clauseBuf);
 
+	bool writeCheckpoint(const std::string& path, int revision, const Checksum& formulaChecksum, int runNonce);
+	void restoreCheckpoint(SatCheckpoint& checkpoint);
+
 	struct LastAdmittedStats {
 		int nbAdmittedCls;
 		int nbTotalCls;
 		int nbAdmittedLits;
+		int nbKeptImports;
+		int nbDeliveredImports;
 	};
 	LastAdmittedStats getLastAdmittedClauseShare();
 	long long getBestFoundObjectiveCost() const;
@@ -122,5 +141,6 @@ public:
 private:
 
 	void writeClauseEpochs();
+	void appendToFormulaSnapshot(RevisionData& data);
 	std::shared_ptr<PortfolioSolverInterface> createSolver(const SolverSetup& setup);
 };
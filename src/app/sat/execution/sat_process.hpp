@@ -9,6 +9,7 @@
 #include <vector>
 #include <memory>
 #include "app/sat/data/clause_metadata.hpp"
+#include "app/sat/data/sat_checkpoint.hpp"
 #include "app/sat/job/inplace_sharing_aggregation.hpp"
 #include "util/assert.hpp"
 
@@ -16,6 +17,7 @@
 #include "util/sys/bidirectional_anytime_pipe_shmem.hpp"
 #include "util/sys/thread_pool.hpp"
 #include "util/sys/timer.hpp"
+#include "util/sys/tmpdir.hpp"
 #include "util/logger.hpp"
 #include "util/params.hpp"
 #include "util/sys/shared_memory.hpp"
@@ -44,6 +46,11 @@ private:
 
     bool _has_solution {false};
 
+    std::string _checkpoint_path;
+    Checksum _formula_checksum;
+    SatCheckpoint _checkpoint;
+    bool _checkpoint_to_restore {false};
+
 public:
     SatProcess(const Parameters& params, const SatProcessConfig& config, Logger& log) 
         : _params(params), _config(config), _log(log) {
@@ -52,7 +59,7 @@ public:
         _shmem_id = _config.getSharedMemId(Proc::getParentPid());
         LOGGER(log, V4_VVER, "Access base shmem: %s\n", _shmem_id.c_str());
         _hsm = (SatSharedMemory*) accessMemory(_shmem_id, sizeof(SatSharedMemory));
-        _hsm->didStart = true; // signal to parent: I started properly (signal handlers etc.)
+        _hsm->signalParent(_hsm->didStart); // signal to parent: I started properly (signal handlers etc.)
 
         // Adjust OOM killer score to make this process the first to be killed
         // (always better than touching an MPI process, which would crash everything)
@@ -80,9 +87,9 @@ private:
         // Write imported clauses from shared memory into vector
         if (revision >= 0) engine.setClauseBufferRevision(revision);
         if (filterOrNull) {
-            engine.digestSharingWithFilter(incomingClauses, *filterOrNull);
+            engine.digestSharingWithFilter(incomingClauses, *filterOrNull, epoch);
         } else {
-            engine.digestSharingWithoutFilter(incomingClauses, stateless);
+            engine.digestSharingWithoutFilter(incomingClauses, stateless, epoch);
         }
         engine.addSharingEpoch(epoch);
         engine.syncDeterministicSolvingAndCheckForLocalWinner();
@@ -106,10 +113,17 @@ private:
             false);
         LOGGER(_log, V4_VVER, "Pipes set up\n");
 
+        // Wake up the main loop as soon as a solver thread is initialized or finds a result
+        engine.setStateChangeCallback([hsm = _hsm]() {hsm->childEvent.notify();});
+
         // Import first revision
         _desired_revision = _config.firstrev;
         char c;
-        while ((c = pipe.pollForData()) == 0) usleep(100);
+        while (true) {
+            int eventState = _hsm->childEvent.state();
+            if ((c = pipe.pollForData()) != 0) break;
+            _hsm->childEvent.wait(eventState, 100);
+        }
         if (c != CLAUSE_PIPE_START_NEXT_REVISION) {
             LOG(V0_CRIT, "[ERROR] Expected pipe data %c (START_NEW_REVISION), got %c!\n", CLAUSE_PIPE_START_NEXT_REVISION, c);
             abort();
@@ -118,8 +132,10 @@ private:
         _desired_revision = popLast(*rev0);
         int rev = popLast(*rev0);
         assert(rev == 0);
+        readCheckpoint(*rev0);
         engine.appendRevision(0, {std::move(rev0), {}}, 0 == _desired_revision);
         _last_present_revision = 0;
+        tryRestoreCheckpoint(engine);
         
         // Start solver threads
         engine.solve();
@@ -144,12 +160,19 @@ private:
             Timer::cacheElapsedSeconds();
             watchdog.reset(Timer::elapsedSecondsCached());
 
+            // Remember the event state before checking for signals and messages
+            // so that no notification by the parent can be missed while sleeping
+            const int eventState = _hsm->childEvent.state();
+
             // Terminate
-            if (_hsm->doTerminate) {
+            if (SatSharedMemory::isSignalled(_hsm->doTerminate)) {
                 Terminator::setTerminating();
             }
             if (Terminator::isTerminating(true)) {
                 LOGGER(_log, V4_VVER, "DO terminate\n");
+                if (SatSharedMemory::isSignalled(_hsm->doCheckpoint) && !_checkpoint_path.empty())
+                    engine.writeCheckpoint(_checkpoint_path, _last_present_revision,
+                        _formula_checksum, _params.runNonce());
                 engine.dumpStats(/*final=*/true);
                 break;
             }
@@ -211,7 +234,9 @@ private:
                     auto filter = pipe.readData(c);
                     int epoch = popLast(filter);
                     doImportClauses(engine, incomingClauses, &filter, -1, epoch);
-                    pipe.writeData({engine.getLastAdmittedClauseShare().nbAdmittedLits}, CLAUSE_PIPE_DIGEST_IMPORT);
+                    auto admitted = engine.getLastAdmittedClauseShare();
+                    pipe.writeData({admitted.nbAdmittedLits, admitted.nbKeptImports, admitted.nbDeliveredImports},
+                        CLAUSE_PIPE_DIGEST_IMPORT);
 
                 } else if (c == CLAUSE_PIPE_DIGEST_IMPORT_WITHOUT_FILTER) {
                     incomingClauses = pipe.readData(c);
@@ -259,6 +284,7 @@ private:
                     engine.appendRevision(_last_present_revision, {data, {}},
                         _last_present_revision == _desired_revision);
                     _has_solution = false;
+                    tryRestoreCheckpoint(engine);
 
                 } else if (c == CLAUSE_PIPE_UPDATE_BEST_FOUND_OBJECTIVE_COST) {
                     LOGGER(_log, V5_DEBG, "DO update best found objective cost\n");
@@ -272,16 +298,16 @@ private:
                 }
             }
 
-            if (sleep) doSleep();
+            if (sleep) doSleep(eventState);
 
             // Check initialization state
-            if (!_hsm->isInitialized && engine.isFullyInitialized()) {
+            if (!SatSharedMemory::isSignalled(_hsm->isInitialized) && engine.isFullyInitialized()) {
                 LOGGER(_log, V5_DEBG, "DO set initialized\n");
-                _hsm->isInitialized = true;
+                _hsm->signalParent(_hsm->isInitialized);
             }
             
             // Terminate "improperly" in order to be restarted automatically
-            if (_hsm->doCrash) {
+            if (SatSharedMemory::isSignalled(_hsm->doCrash)) {
                 LOGGER(_log, V3_VERB, "Restarting this subprocess\n");
                 exitStatus = SIGUSR2;
                 break;
@@ -323,7 +349,7 @@ private:
                 // Solution found!
                 auto& result = engine.getResult();
                 result.id = _config.jobid;
-                if (_hsm->doTerminate || result.revision < _desired_revision) {
+                if (SatSharedMemory::isSignalled(_hsm->doTerminate) || result.revision < _desired_revision) {
                     // Result obsolete
                     continue;
                 }
@@ -368,7 +394,7 @@ private:
             // clean up all resources which MUST be cleaned up (e.g., child processes)
             engine.cleanUp(true);
             cbAtForcedExit();
-            _hsm->didTerminate = true;
+            _hsm->signalParent(_hsm->didTerminate);
             // terminate yourself
             assert(exitStatus != 9); // not hard-killed - wouldn't make sense
             LOGGER(_log, V4_VVER, "Exiting\n");
@@ -387,9 +413,37 @@ private:
         return ptr;
     }
 
-    void doSleep() {
-        // Wait until something happens
-        // (can be interrupted by Fork::wakeUp(hsm->childPid))
-        usleep(1000 /*1 millisecond*/);
+    void readCheckpoint(const std::vector<int>& rev0) {
+        if (!_params.checkpointSuspendedJobs() || ClauseMetadata::enabled()) return;
+        _formula_checksum = SatCheckpoint::getFormulaChecksum(rev0);
+        _checkpoint_path = SatCheckpoint::getPath(SatCheckpoint::getDirectory(_params),
+            _config.jobid, _config.apprank);
+        // Read a checkpoint left behind by a previous process for this job node
+        if (_checkpoint.read(_checkpoint_path)) {
+            if (_checkpoint.isCompatible(_config.jobid, _formula_checksum, _params.runNonce())) {
+                LOGGER(_log, V3_VERB, "Found checkpoint of rev. %i\n", _checkpoint.revision);
+                _checkpoint_to_restore = true;
+            } else {
+                LOGGER(_log, V1_WARN, "[WARN] Rejecting checkpoint %s of a different formula or run\n",
+                    _checkpoint_path.c_str());
+                _checkpoint = SatCheckpoint();
+            }
+        }
+        ::remove(_checkpoint_path.c_str()); // each checkpoint is restored at most once
+    }
+
+    void tryRestoreCheckpoint(SatEngine& engine) {
+        // Checkpointed clauses may only be added once their formula revision is present
+        if (!_checkpoint_to_restore || _last_present_revision < _checkpoint.revision) return;
+        engine.restoreCheckpoint(_checkpoint);
+        _checkpoint = SatCheckpoint();
+        _checkpoint_to_restore = false;
+    }
+
+    void doSleep(int eventState) {
+        // Wait until the parent signals something or writes into the pipe, or until
+        // a solver thread is initialized or finds a result. The timeout is only a fallback
+        // for events which are not notified (e.g., a preprocessed formula being found).
+        _hsm->childEvent.wait(eventState, 100);
     }
 };
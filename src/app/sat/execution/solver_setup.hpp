@@ -18,6 +18,7 @@ struct SolverSetup {
 	Logger* logger {nullptr};
 	int globalId {0};
 	int localId {0};
+	int numaNode {-1}; // NUMA node to run the solver and place its import buffers on (-1: any)
 	std::string jobname;
 	int jobId;
 	std::string profilingBaseDir; 
@@ -60,6 +61,8 @@ struct SolverSetup {
 	unsigned int qualityLbdLimit {255};
 	unsigned int freeMaxLitsPerClause {255};
 	size_t clauseBaseBufferSize {1000};
+	// Max. number of ints of exported clauses to keep for checkpointing (0: none)
+	size_t checkpointReservoirSize {0};
 
 
 	// Clause import
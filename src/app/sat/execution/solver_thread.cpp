@@ -16,6 +16,7 @@
 #include "util/random.hpp"
 #include "util/string_utils.hpp"
 #include "util/sys/proc.hpp"
+#include "util/sys/numa.hpp"
 #include "util/hashing.hpp"
 #include "app/sat/proof/lrat_connector.hpp"
 #include "app/sat/data/definitions.hpp"
@@ -26,12 +27,14 @@
 #include "util/params.hpp"
 
 SolverThread::SolverThread(const Parameters& params, const SatProcessConfig& config,
-         std::shared_ptr<PortfolioSolverInterface> solver, RevisionData firstRevision, int localId) : 
+         std::shared_ptr<PortfolioSolverInterface> solver, RevisionData firstRevision, int localId,
+         std::function<void()> onStateChange) : 
     _params(params), _solver_ptr(solver), _solver(*solver), 
     _logger(_solver.getLogger()),
     _lrat(_solver.getSolverSetup().onTheFlyChecking ? _solver.getLratConnector() : nullptr),
     _local_id(localId),
-    _has_pseudoincremental_solvers(solver->getSolverSetup().hasPseudoincrementalSolvers) {
+    _has_pseudoincremental_solvers(solver->getSolverSetup().hasPseudoincrementalSolvers),
+    _on_state_change(onStateChange) {
     
     _portfolio_rank = config.apprank;
     _portfolio_size = config.mpisize;
@@ -58,6 +61,7 @@ void SolverThread::init() {
     LOGGER(_logger, V5_DEBG, "tid %ld\n", _tid);
     std::string threadName = "SATSolver#" + std::to_string(_local_id);
     Proc::nameThisThread(threadName.c_str());
+    pin();
 
     if (_lrat) _lrat->init();
     if (_solver.getSolverSetup().owningModelCheckingLratConnector)
@@ -66,6 +70,19 @@ void SolverThread::init() {
     _active_revision = 0;
     _imported_lits_curr_revision = 0;
     _initialized = true;
+    _on_state_change();
+}
+
+void SolverThread::pin() {
+    // Pinning this thread before reading the formula makes the solver's own data
+    // structures node-local as well, since they are first touched by this thread.
+    int node = _solver.getSolverSetup().numaNode;
+    if (node < 0) return;
+    if (Numa::pinThisThreadToNode(node)) {
+        LOGGER(_logger, V4_VVER, "pinned to NUMA node %i\n", node);
+    } else {
+        LOGGER(_logger, V1_WARN, "[WARN] Could not pin thread to NUMA node %i\n", node);
+    }
 }
 
 void* SolverThread::run() {
@@ -117,30 +134,35 @@ bool SolverThread::readFormula() {
 
         LOGGER(_logger, V4_VVER, "Reading rev. %i, start %i\n", (int)_active_revision, (int)_imported_lits_curr_revision);
         
-        // Read literals, checking in between whether to stop/terminate
-        int lit;
-        while (fParser->getNextLiteral(lit)) {
-
-            if (std::abs(lit) > (1<<30)) {
-                LOGGER(_logger, V0_CRIT, "[ERROR] Invalid literal %i at rev. %i pos. %ld/%ld.\n",
-                    lit, (int)_active_revision, _imported_lits_curr_revision, fParser->getPayloadSize());
-                _logger.flush();
-                abort();
+        // Read literals chunk by chunk, checking in between whether to stop/terminate
+        const int* chunk;
+        size_t chunkSize;
+        while (fParser->getNextLiteralChunk(chunk, chunkSize, FORMULA_READ_CHUNK_SIZE)) {
+
+            // Validate the entire chunk in a single pass
+            int maxVar = _max_var;
+            bool lastLitZero = _last_read_lit_zero;
+            for (size_t i = 0; i < chunkSize; i++) {
+                const int lit = chunk[i];
+                const int var = std::abs(lit);
+                if (var > (1<<30) || (lit == 0 && lastLitZero)) {
+                    LOGGER(_logger, V0_CRIT, "[ERROR] %s %i at rev. %i pos. %ld/%ld.\n",
+                        lit == 0 ? "Empty clause" : "Invalid literal", lit, (int)_active_revision,
+                        _imported_lits_curr_revision+i, fParser->getPayloadSize());
+                    _logger.flush();
+                    abort();
+                }
+                maxVar = std::max(maxVar, var);
+                lastLitZero = lit == 0;
             }
-            if (lit == 0 && _last_read_lit_zero) {
-                LOGGER(_logger, V0_CRIT, "[ERROR] Empty clause at rev. %i pos. %ld/%ld.\n", 
-                    (int)_active_revision, _imported_lits_curr_revision, fParser->getPayloadSize());
-                _logger.flush();
-                abort();
+            if (_params.useChecksums()) {
+                for (size_t i = 0; i < chunkSize; i++) _running_chksum.combine(chunk[i]);
             }
-            _solver.addLiteral(lit);
-            if (_params.useChecksums()) _running_chksum.combine(lit);
-            _max_var = std::max(_max_var, std::abs(lit));
-            _last_read_lit_zero = lit == 0;
-            //_dbg_lits += std::to_string(lit]) + " ";
-            //if (lit == 0) _dbg_lits += "\n";
-
-            ++_imported_lits_curr_revision;
+            _solver.addClauses(chunk, chunkSize);
+            _max_var = maxVar;
+            _last_read_lit_zero = lastLitZero;
+
+            _imported_lits_curr_revision += chunkSize;
             // Suspend and/or terminate if needed
             if (_terminated) return false;
         }
@@ -157,6 +179,7 @@ bool SolverThread::readFormula() {
             
                 // Parse assumptions
                 _pending_assumptions.clear();
+                int lit;
                 while (fParser->getNextAssumption(lit)) {
                     _pending_assumptions.push_back(lit);
                     // Adjust _max_var according to assumptions as well
@@ -178,10 +201,10 @@ void SolverThread::appendRevision(int revision, RevisionData data) {
     {
         auto lock = _state_mutex.getLock();
         _pending_formulae.emplace_back(
-            new SerializedFormulaParser(_logger, data.fLits, _solver.getSolverSetup().onTheFlyChecking
-                || _solver.getSolverSetup().trustedParserForced)
+            new SerializedFormulaParser(_logger, data.fLits, !data.decoded && (_solver.getSolverSetup().onTheFlyChecking
+                || _solver.getSolverSetup().trustedParserForced))
         );
-        if (_params.compressFormula()) {
+        if (_params.compressFormula() && !data.decoded) {
             _pending_formulae.back()->setCompressed();
             LOGGER(_logger, V4_VVER, "Received compressed formula of size %i\n", data.fLits->size());
         } else {
@@ -383,6 +406,7 @@ void SolverThread::reportResult(int res, int revision) {
     _found_result_rev = revision;
     _solver.setFoundResult();
     _state_mutex.unlock();
+    _on_state_change();
 }
 
 SolverThread::~SolverThread() {
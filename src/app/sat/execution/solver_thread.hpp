@@ -32,6 +32,9 @@ class SerializedFormulaParser;
 class SolverThread {
 
 private:
+    // Max. number of literals which are validated and added to the solver at once
+    static constexpr size_t FORMULA_READ_CHUNK_SIZE = 1<<16;
+
     const Parameters& _params;
     std::shared_ptr<PortfolioSolverInterface> _solver_ptr;
     PortfolioSolverInterface& _solver;
@@ -71,9 +74,13 @@ private:
     int _found_result_rev = -1;
     JobResult _result;
 
+    // Called whenever this thread's state changes in a way the engine's owner should notice
+    // without delay (initialization done, result found)
+    std::function<void()> _on_state_change;
+
 public:
     SolverThread(const Parameters& params, const SatProcessConfig& config, std::shared_ptr<PortfolioSolverInterface> solver, 
-                RevisionData firstRevision, int localId);
+                RevisionData firstRevision, int localId, std::function<void()> onStateChange);
     ~SolverThread();
 
     void start();
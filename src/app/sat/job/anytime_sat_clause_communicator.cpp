@@ -23,6 +23,7 @@
 #include "comm/mpi_base.hpp"
 #include "data/job_state.h"
 #include "util/option.hpp"
+#include "util/sys/fileutils.hpp"
 #include "util/sys/timer.hpp"
 
 void advanceCollective(BaseSatJob* job, JobMessage& msg, int broadcastTag) {
@@ -51,10 +52,19 @@ AnytimeSatClauseCommunicator::AnytimeSatClauseCommunicator(const Parameters& par
             setup.slotsForSumOfLengthAndLbd = _params.groupClausesByLengthLbdSum();
             setup.numLiterals = _job->getBufferLimit(MyMpi::size(MPI_COMM_WORLD), false);
             return setup;
-        }(), _job)
+        }(), _job, _params.clauseHistoryHotSlots(), [&]() {
+            // file for spilling older parts of the history to disk
+            if (_params.clauseHistoryHotSlots() > 0) FileUtils::mkdir(_params.extMemDiskDirectory());
+            return _params.extMemDiskDirectory() + "/disk.clshist." + std::to_string(_job->getId())
+                + "." + std::to_string(_job->getContextId());
+        }())
     ),
     _cross_job_clause_sharer(_job->getDescription().getGroupId() > 0 && _job->getJobTree().isRoot() ?
         new InterJobClauseSharer(_params, job->getDescription().getGroupId(), job->getContextId(), job->toStr()) : nullptr),
+    // Pipelining epochs would interleave the per-epoch clause ID alignment of proof production
+    // and break the lock-step of deterministic solving, so we only pipeline without these.
+    _active_sessions(ClauseMetadata::enabled() || params.deterministicSolving() ?
+        1 : params.clauseSharingPipelineDepth()),
     _sent_cert_unsat_ready_msg(!params.proofOutputFile.isSet() && !params.deterministicSolving()),
     _sub_incoming_crossshared_clauses(MSG_SEND_APP_DATA_TO_JOB_TREE_ROOT, [&](MessageHandle& h) {
         JobMessage msg = Serializable::get<JobMessage>(h.getRecvData());
@@ -96,14 +106,8 @@ void AnytimeSatClauseCommunicator::communicate() {
     // if doing certified UNSAT, advance the establishing communication
     checkCertifiedUnsatReadyMsg();
 
-    // Advance and/or clean up current clause sharing session
-    if (_current_session) {
-        _current_session->advanceSharing();
-        if (_current_session->isDone()) {
-            _time_of_last_epoch_conclusion = Timer::elapsedSecondsCached();
-            _cancelled_sessions.emplace_back(_current_session.release());
-        }
-    }
+    // Advance and/or clean up current clause sharing session(s)
+    advanceActiveSessions();
     if (_cross_sharing_session) {
         _cross_job_clause_sharer->setClauseBufferRevision(_job->getClausesRevision());
         _cross_sharing_session->advanceSharing();
@@ -161,8 +165,8 @@ void AnytimeSatClauseCommunicator::handle(int source, int mpiTag, JobMessage& ms
         if (msg.tag == MSG_INITIATE_CLAUSE_SHARING) {
             // Initiation of clause sharing was rejected:
             // go on without this child.
-            if (_current_session) {
-                _current_session->pruneChild(source);
+            for (auto& session : _active_sessions) {
+                if (session->getEpoch() == msg.epoch) session->pruneChild(source);
             }
         }
         if (msg.tag == MSG_INITIATE_CROSS_JOB_CLAUSE_SHARING) {
@@ -287,10 +291,12 @@ bool AnytimeSatClauseCommunicator::handleClauseSharingMessage(int source, int mp
     }
 
     // Advance all-reductions
+    // (each all-reduction only accepts messages of its own epoch)
     bool success = false;
-    if (_current_session) {
-        success = _current_session->advanceClauseAggregation(source, mpiTag, msg)
-                || _current_session->advanceFilterAggregation(source, mpiTag, msg);
+    for (auto& session : _active_sessions) {
+        success = session->advanceClauseAggregation(source, mpiTag, msg)
+                || session->advanceFilterAggregation(source, mpiTag, msg);
+        if (success) break;
     }
     if (!success && _cross_sharing_session) {
         success = _cross_sharing_session->advanceClauseAggregation(source, mpiTag, msg)
@@ -301,8 +307,8 @@ bool AnytimeSatClauseCommunicator::handleClauseSharingMessage(int source, int mp
 
 void AnytimeSatClauseCommunicator::initiateClauseSharing(JobMessage& msg, int source, bool fromDeferredQueue) {
 
-    if (_current_session || (!fromDeferredQueue && !_deferred_sharing_initiation_msgs.empty())) {
-        // defer message until all past sessions are done
+    if (!canBeginNextSession() || (!fromDeferredQueue && !_deferred_sharing_initiation_msgs.empty())) {
+        // defer message until enough past sessions are done
         // and all earlier deferred initiation messages have been processed
         LOG(V3_VERB, "%s : deferring CS initiation\n", _job->toStr());
         _deferred_sharing_initiation_msgs.push_back({source, std::move(msg)});
@@ -315,7 +321,7 @@ void AnytimeSatClauseCommunicator::initiateClauseSharing(JobMessage& msg, int so
         return;
     }
 
-    // no current sessions active - can start new session
+    // can start new session
     _current_epoch = msg.epoch;
     const auto snapshot = _job->getJobTree().getSnapshot();
     if (!_job->getJobTree().isRoot() && snapshot.parentNodeRank != source) {
@@ -330,14 +336,17 @@ void AnytimeSatClauseCommunicator::initiateClauseSharing(JobMessage& msg, int so
     static_assert(sizeof(float) == sizeof(int));
     memcpy(&compensationFactor, msg.payload.data(), sizeof(float));
     assert(compensationFactor >= 0.1 && compensationFactor <= 10);
+    // extract limits adapted to the utility of imported clauses
+    float importUtilityVolumeFactor;
+    memcpy(&importUtilityVolumeFactor, msg.payload.data()+1, sizeof(float));
+    _job->setImportUtilityLimits(importUtilityVolumeFactor, msg.payload[2], msg.payload[3]);
 
-    _current_session.reset(
-        new ClauseSharingSession(_params, _job, snapshot, _cls_history.get(), _current_epoch, compensationFactor)
-    );
+    auto session = new ClauseSharingSession(_params, _job, snapshot, _cls_history.get(), _current_epoch, compensationFactor);
+    _active_sessions.add(session);
 
     // register listener to grab final, filtered shared clauses and share them with other jobs
-    _current_session->setAdditionalClauseListener(
-        [&, session = _current_session.get()](std::vector<int>& clauses) {
+    session->setAdditionalClauseListener(
+        [&, session](std::vector<int>& clauses) {
             if (!_cross_job_clause_sharer) return;
             while (!_incoming_crossshared_clauses.empty()) {
                 auto clauseBuf = std::move(_incoming_crossshared_clauses.back());
@@ -444,8 +453,8 @@ void AnytimeSatClauseCommunicator::initiateCrossSharing(JobMessage& msg, int sou
 
 void AnytimeSatClauseCommunicator::tryActivateDeferredSharingInitiation() {
     
-    if (!_deferred_sharing_initiation_msgs.empty() && !_current_session) {
-        // sessions are empty -> WILL succeed to initiate sharing
+    if (!_deferred_sharing_initiation_msgs.empty() && canBeginNextSession()) {
+        // a session can be begun -> WILL succeed to initiate sharing
         // -> initiation message CAN be deleted afterwards.
         auto [source, msg] = std::move(_deferred_sharing_initiation_msgs.front());
         _deferred_sharing_initiation_msgs.pop_front();
@@ -473,8 +482,7 @@ bool AnytimeSatClauseCommunicator::tryInitiateSharing() {
     }
     if (!nextEpochDue) return false;
 
-    bool lastEpochDone = !_current_session;
-    if (!lastEpochDone) {
+    if (!canBeginNextSession()) {
         if (!_params.deterministicSolving()) {
             // Warn that a new epoch is over-due, but only once for each skipped epoch ...
             int nbSkippedEpochs = (int) std::floor((time - _time_of_last_epoch_initiation) / _params.appCommPeriod()) - 1;
@@ -492,10 +500,18 @@ bool AnytimeSatClauseCommunicator::tryInitiateSharing() {
     // Assemble job message
     JobMessage msg(_job->getId(), _job->getContextId(), _job->getRevision(), 
         _current_epoch, MSG_INITIATE_CLAUSE_SHARING);
-    msg.payload.push_back(0);
-    float compensationFactor = _job->updateSharingCompensationFactor();
+    msg.payload.resize(4);
+    // The compensation factor is updated from the latest digested epoch: if the previous
+    // epoch is still undigested (pipelined sharing), the current factor is re-used.
+    float compensationFactor = _active_sessions.shouldUpdateSharingLimits() ?
+        _job->updateSharingCompensationFactor() : _job->getSharingCompensationFactor();
     static_assert(sizeof(float) == sizeof(int));
     memcpy(msg.payload.data(), &compensationFactor, sizeof(float));
+    auto& importUtility = _job->getImportUtilityController();
+    float importUtilityVolumeFactor = importUtility.getVolumeFactor();
+    memcpy(msg.payload.data()+1, &importUtilityVolumeFactor, sizeof(float));
+    msg.payload[2] = importUtility.getQualityLengthLimit();
+    msg.payload[3] = importUtility.getQualityLbdLimit();
 
     // Advance initiation time exactly by the specified period 
     // in order to lose no time for the subsequent epoch
@@ -510,8 +526,19 @@ bool AnytimeSatClauseCommunicator::tryInitiateSharing() {
     return true;
 }
 
+void AnytimeSatClauseCommunicator::advanceActiveSessions() {
+    _active_sessions.advance([&](std::unique_ptr<ClauseSharingSession>&& session) {
+        _time_of_last_epoch_conclusion = Timer::elapsedSecondsCached();
+        _cancelled_sessions.emplace_back(session.release());
+    });
+}
+
+bool AnytimeSatClauseCommunicator::canBeginNextSession() const {
+    return _active_sessions.canBeginNext();
+}
+
 bool AnytimeSatClauseCommunicator::isDestructible() {
-    if (_current_session) return false;
+    if (!_active_sessions.empty()) return false;
     if (_cross_sharing_session) return false;
     for (auto& session : _cancelled_sessions) if (!session->isDestructible()) return false;
     if (!_deferred_sharing_initiation_msgs.empty()) return false;
@@ -15,6 +15,7 @@
 #include "data/job_transfer.hpp"
 #include "app/job.hpp"
 #include "comm/job_tree_basic_all_reduction.hpp"
+#include "clause_sharing_pipeline.hpp"
 #include "clause_sharing_session.hpp"
 #include "app/sat/proof/proof_producer.hpp"
 #include "app/sat/job/historic_clause_storage.hpp"
@@ -31,12 +32,15 @@ private:
 
     std::unique_ptr<HistoricClauseStorage> _cls_history;
 
-    std::unique_ptr<ClauseSharingSession> _current_session;
     std::list<std::unique_ptr<ClauseSharingSession>> _cancelled_sessions;
 
     std::unique_ptr<InterJobClauseSharer> _cross_job_clause_sharer;
     std::unique_ptr<ClauseSharingSession> _cross_sharing_session;
 
+    // Sessions in flight, ordered by epoch. Contains at most one session
+    // unless pipelined sharing (-cspd > 1) is enabled.
+    ClauseSharingPipeline<ClauseSharingSession> _active_sessions;
+
     int _current_epoch = 0;
     float _time_of_last_epoch_initiation = 0;
     float _time_of_last_epoch_conclusion = 0;
@@ -82,6 +86,8 @@ private:
     void initiateCrossSharing(JobMessage& msg, int source, bool fromDeferredQueue);
     void feedLocalClausesIntoCrossSharing(std::vector<int>& clauses, ClauseSharingSession* session);
     void tryActivateDeferredSharingInitiation();
+    void advanceActiveSessions();
+    bool canBeginNextSession() const;
     
     void checkCertifiedUnsatReadyMsg();
     void setupProofProducer(JobMessage& msg);
@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include "app/sat/job/import_utility_controller.hpp"
 #include "comm/binary_tree_buffer_limit.hpp"
 #include "data/checksum.hpp"
 #include "util/logger.hpp"
@@ -28,8 +29,18 @@ protected:
     size_t _total_desired {0};
     size_t _total_shared {0};
 
+    // Adaptation to the utility of imported clauses (-aiu): the controller
+    // is only effective at the root; the limits are broadcast to all nodes.
+    ImportUtilityController _import_utility;
+    float _import_utility_volume_factor {1};
+    int _import_utility_quality_length_limit;
+    int _import_utility_quality_lbd_limit;
+
 public:
-    ClauseSharingActor(const Parameters& params) : _cs_params(params) {}
+    ClauseSharingActor(const Parameters& params) : _cs_params(params),
+        _import_utility(params.minImportUtilityVolumeFactor(), params.qualityClauseLengthLimit(), params.qualityLbdLimit()),
+        _import_utility_quality_length_limit(params.qualityClauseLengthLimit()),
+        _import_utility_quality_lbd_limit(params.qualityLbdLimit()) {}
 
     virtual int getActorJobId() const = 0;
     virtual int getActorContextId() const = 0;
@@ -50,6 +61,9 @@ public:
     virtual void digestHistoricClauses(int epochBegin, int epochEnd, std::vector<int>&& clauses) = 0;
 
     virtual int getLastAdmittedNumLits() = 0;
+    // Number of delivered clauses kept by the local solvers and total number
+    // of delivered clauses since the last call
+    virtual void fetchImportUtilitySample(int& nbKept, int& nbDelivered) = 0;
     virtual long long getBestFoundObjectiveCost() = 0;
     virtual void setClauseBufferRevision(int revision) = 0;
     virtual void updateBestFoundSolutionCost(long long bestFoundSolutionCost) = 0;
@@ -111,6 +125,9 @@ public:
 
         return _compensation_factor;
     }
+    float getSharingCompensationFactor() const {
+        return _compensation_factor;
+    }
     int setSharingCompensationFactorAndUpdateExportLimit(float factor) {
         _compensation_factor = factor;
         _clsbuf_export_limit = getBufferLimit(1, true);
@@ -121,10 +138,28 @@ public:
         if (_estimate_incoming_lits <= 0) _estimate_incoming_lits = numInputLits;
     }
 
+    void updateImportUtility(int nbKept, int nbDelivered) {
+        if (_cs_params.adaptiveImportUtility()) _import_utility.update(nbKept, nbDelivered);
+    }
+    const ImportUtilityController& getImportUtilityController() const {
+        return _import_utility;
+    }
+    void setImportUtilityLimits(float volumeFactor, int qualityLengthLimit, int qualityLbdLimit) {
+        _import_utility_volume_factor = volumeFactor;
+        _import_utility_quality_length_limit = qualityLengthLimit;
+        _import_utility_quality_lbd_limit = qualityLbdLimit;
+    }
+    void applyImportUtilityLimits(Parameters& params) const {
+        if (!_cs_params.adaptiveImportUtility()) return;
+        params.qualityClauseLengthLimit.set(_import_utility_quality_length_limit);
+        params.qualityLbdLimit.set(_import_utility_quality_lbd_limit);
+    }
+
     virtual size_t getBufferLimit(int numAggregatedNodes, bool selfOnly) {
         int exportVolumeMultiplier = getExportVolumeMultiplier();
-        if (selfOnly) return _compensation_factor * _cs_params.exportVolumePerThread() * exportVolumeMultiplier;
-        return _compensation_factor * BinaryTreeBufferLimit::getLimit(numAggregatedNodes,
+        const float factor = _compensation_factor * _import_utility_volume_factor;
+        if (selfOnly) return factor * _cs_params.exportVolumePerThread() * exportVolumeMultiplier;
+        return factor * BinaryTreeBufferLimit::getLimit(numAggregatedNodes,
             _cs_params.exportVolumePerThread() * exportVolumeMultiplier, _cs_params.clauseBufferLimitParam(),
             BinaryTreeBufferLimit::BufferQueryMode(_cs_params.clauseBufferLimitMode()));
     }
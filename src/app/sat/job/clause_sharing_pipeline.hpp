@@ -0,0 +1,75 @@
+
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <memory>
+
+// Sessions of successive clause sharing epochs which are in flight, ordered by epoch.
+// Without pipelining (max. one session in flight), a new epoch can only begin once the
+// previous epoch is done. With pipelining, a new epoch's aggregation may begin as soon as
+// the latest epoch has sent its aggregated clauses upwards. In any case, the results are
+// digested strictly in the order of epochs: only the earliest session in flight may digest.
+template <typename Session>
+class ClauseSharingPipeline {
+
+private:
+    const size_t _max_in_flight;
+    std::list<std::unique_ptr<Session>> _sessions;
+
+    // Number of concluded sessions, in total and at the last update of the sharing limits
+    int _nb_concluded {0};
+    int _nb_concluded_at_limits_update {0};
+
+public:
+    ClauseSharingPipeline(int maxInFlight) : _max_in_flight(std::max(1, maxInFlight)) {}
+
+    bool canBeginNext() const {
+        if (_sessions.empty()) return true;
+        if (_sessions.size() >= _max_in_flight) return false;
+        // The next epoch's aggregation may only begin once the latest epoch
+        // has sent its own aggregated clauses upwards
+        return _sessions.back()->hasConcludedClauseAggregation();
+    }
+
+    void add(Session* session) {
+        // An earlier epoch is still in flight: only digest this epoch's result after it
+        session->setDigestionDeferred(!_sessions.empty());
+        _sessions.emplace_back(session);
+    }
+
+    // Advances all sessions in flight. Each session which is done is removed
+    // and handed to onConcluded, in the order of epochs.
+    template <typename Callback>
+    void advance(Callback onConcluded) {
+        while (!_sessions.empty()) {
+            auto& session = _sessions.front();
+            session->setDigestionDeferred(false);
+            session->advanceSharing();
+            if (!session->isDone()) break;
+            _nb_concluded++;
+            onConcluded(std::move(session));
+            _sessions.pop_front();
+        }
+        // Later sessions can still advance their aggregation
+        if (_sessions.size() <= 1) return;
+        for (auto it = std::next(_sessions.begin()); it != _sessions.end(); ++it) {
+            (*it)->advanceSharing();
+        }
+    }
+
+    // Whether the sharing limits (e.g., the compensation factor) should be updated for a new
+    // epoch. The limits are derived from the results of the most recently digested epoch, so
+    // they are updated once for each digested epoch (or if no epoch is in flight). A new epoch
+    // which begins while the previous one is still undigested re-uses the current limits.
+    bool shouldUpdateSharingLimits() {
+        const bool newlyConcluded = _nb_concluded != _nb_concluded_at_limits_update;
+        _nb_concluded_at_limits_update = _nb_concluded;
+        return newlyConcluded || _sessions.empty();
+    }
+
+    bool empty() const {return _sessions.empty();}
+    size_t size() const {return _sessions.size();}
+    typename std::list<std::unique_ptr<Session>>::iterator begin() {return _sessions.begin();}
+    typename std::list<std::unique_ptr<Session>>::iterator end() {return _sessions.end();}
+};
@@ -17,6 +17,7 @@
 #include "app/sat/sharing/filter/in_place_clause_filtering.hpp"
 #include "util/random.hpp"
 #include "inplace_sharing_aggregation.hpp"
+#include "host_local_clause_buffer.hpp"
 #include <cstdint>
 
 class ClauseSharingSession {
@@ -52,6 +53,15 @@ private:
     std::unique_ptr<StaticClauseStore<false>> _merge_store;
     bool _priority_based_buffer_merging = false;
 
+    // If the parent node resides on the same host, the aggregated clauses
+    // are handed to it via shared memory instead of MPI.
+    bool _host_local_parent {false};
+    std::unique_ptr<HostLocalClauseBuffer> _host_local_contribution;
+
+    // With pipelined sharing, an epoch's result must not be digested
+    // before all earlier epochs have been fully concluded.
+    bool _digestion_deferred {false};
+
 public:
     ClauseSharingSession(const Parameters& params, ClauseSharingActor* actor, const JobTreeSnapshot& snapshot,
             HistoricClauseStorage* clsHistory, int epoch, float compensationFactor) : 
@@ -82,6 +92,20 @@ public:
             );
         }
 
+        _host_local_parent = _params.hostLocalClauseAggregation() && snapshot.index > 0
+            && MyMpi::isOnSameHost(snapshot.parentNodeRank);
+        if (_host_local_parent) {
+            // Deposit the aggregated element in shared memory and only send a reference to it
+            _allreduce_clauses.setTransformationBeforeSending([&](std::vector<int>&& elem) {
+                HostLocalClauseBuffer::releaseExpired();
+                _host_local_contribution.reset(new HostLocalClauseBuffer(
+                    _job->getActorJobId(), _job->getActorContextId(), _epoch, elem));
+                if (_host_local_contribution->valid()) return _host_local_contribution->getReference();
+                _host_local_contribution.reset();
+                return std::move(elem);
+            });
+        }
+
         LOG(V5_DEBG, "%s CS OPEN e=%i\n", _job->getLabel(), _epoch);
         _local_export_limit = _job->setSharingCompensationFactorAndUpdateExportLimit(compensationFactor);
         if (!_job->hasPreparedSharing()) _job->prepareSharing();
@@ -108,16 +132,23 @@ public:
                 int numLits;
                 auto clauses = _job->getPreparedClauses(checksum, successfulSolverId, numLits);
                 LOG(V4_VVER, "%s CS produced cls size=%lu lits=%i/%i\n", _job->getLabel(), clauses.size(), numLits, _local_export_limit);
+                int numKeptImports, numDeliveredImports;
+                _job->fetchImportUtilitySample(numKeptImports, numDeliveredImports);
                 auto agg = InplaceClauseAggregation::prepareRawBuffer(clauses,
                     _job->getClausesRevision(), numLits, 1, successfulSolverId,
-                    _job->getBestFoundObjectiveCost());
+                    _job->getBestFoundObjectiveCost(), numKeptImports, numDeliveredImports);
                 return clauses;
             });
 
             _stage = AGGREGATING_CLAUSES;
         }
 
-        if (_stage == AGGREGATING_CLAUSES && _allreduce_clauses.advance().hasResult()) {
+        // The epoch's result arrived, so the parent has consumed our host-local contribution
+        if (_host_local_contribution && _stage == AGGREGATING_CLAUSES && _allreduce_clauses.advance().hasResult()) {
+            _host_local_contribution.reset();
+        }
+
+        if (_stage == AGGREGATING_CLAUSES && _allreduce_clauses.advance().hasResult() && !_digestion_deferred) {
 
             // Some clauses may have been left behind during merge
             if (_excess_clauses_from_merge.size() > 4) {
@@ -148,6 +179,7 @@ public:
             int winningSolverId = aggregation.successfulSolver();
             assert(winningSolverId >= -1 || log_return_false("Winning solver ID = %i\n", winningSolverId));
             _job->setNumInputLitsOfLastSharing(aggregation.numInputLiterals());
+            _job->updateImportUtility(aggregation.numKeptImports(), aggregation.numDeliveredImports());
             _job->setClauseBufferRevision(aggregation.maxRevision());
             _job->updateBestFoundSolutionCost(_best_found_solution_cost);
 
@@ -224,6 +256,23 @@ public:
         return _stage == DONE;
     }
 
+    // Whether this session's upward aggregation of clauses has been concluded locally,
+    // i.e., the next epoch's aggregation may begin without interfering with this one.
+    bool hasConcludedClauseAggregation() const {
+        return _stage > PRODUCING_CLAUSES
+            && (_allreduce_clauses.isReductionLocallyDone() || !_allreduce_clauses.isValid());
+    }
+
+    // Defer (or allow) digesting the result of this epoch. Used for pipelined sharing
+    // to enforce that results are digested (and added to the history) in order of epochs.
+    void setDigestionDeferred(bool deferred) {
+        _digestion_deferred = deferred;
+    }
+
+    int getEpoch() const {
+        return _epoch;
+    }
+
     bool isDestructible() {
         return _allreduce_clauses.isDestructible() && 
             (!_allreduce_filter || _allreduce_filter->isDestructible());
@@ -239,6 +288,8 @@ public:
         _allreduce_clauses.cancel();
         // If not done producing, will send empty filter upwards
         if (_allreduce_filter) _allreduce_filter->cancel();
+        // Consumption by the parent not confirmed: keep the contribution for a while
+        if (_host_local_contribution) HostLocalClauseBuffer::retain(std::move(_host_local_contribution));
     }
 
 private:
@@ -254,12 +305,19 @@ private:
     
     std::vector<int> mergeClauseBuffersDuringAggregation(std::list<std::vector<int>>& elems) {
 
+        // fetch contributions deposited in shared memory by children on this host
+        for (auto& elem : elems) {
+            if (HostLocalClauseBuffer::isReference(elem)) HostLocalClauseBuffer::resolve(elem);
+        }
+
         // aggregate metadata
         int maxRevision = -1;
         int numAggregated = 0;
         int numInputLits = 0;
         int successfulSolverId = -1;
         long long bestFoundSolutionCost = LLONG_MAX;
+        long long numKeptImports = 0;
+        long long numDeliveredImports = 0;
         for (auto& elem : elems) {
             assert(elem.size() >= InplaceClauseAggregation::numMetadataInts()
                 || log_return_false("[ERROR] Clause buffer has size %ld!\n", elem.size()));
@@ -271,6 +329,8 @@ private:
             numInputLits += agg.numInputLiterals();
             maxRevision = std::max(maxRevision, agg.maxRevision());
             bestFoundSolutionCost = std::min(bestFoundSolutionCost, agg.bestFoundSolutionCost());
+            numKeptImports += agg.numKeptImports();
+            numDeliveredImports += agg.numDeliveredImports();
             agg.stripToRawBuffer();
         }
         int buflim = _job->getBufferLimit(numAggregated, false);
@@ -301,7 +361,8 @@ private:
             _job->getLabel(), numAggregated, maxRevision, numInputLits, time, merged.size());
         InplaceClauseAggregation::prepareRawBuffer(merged,
             maxRevision, numInputLits, numAggregated, successfulSolverId,
-            bestFoundSolutionCost);
+            bestFoundSolutionCost, std::min(numKeptImports, (long long) INT32_MAX),
+            std::min(numDeliveredImports, (long long) INT32_MAX));
         return merged;
     }
 
@@ -339,6 +400,7 @@ private:
     void initMergeClauseStore() {
         if (_merge_store) return;
         auto params = _job->getClauseStoreParams();
+        _job->applyImportUtilityLimits(params);
         _merge_store.reset(new StaticClauseStore<false>(params, false, 256, true, INT32_MAX));
         _priority_based_buffer_merging = params.priorityBasedBufferMerging();
     }
@@ -8,11 +8,13 @@
 
 #include "app/app_message_subscription.hpp"
 #include "app/sat/job/sat_process_config_builder.hpp"
+#include "app/sat/job/sat_process_pool.hpp"
 #include "app/sat/proof/palrup_caller.hpp"
 #include "data/job_interrupt_reason.hpp"
 #include "interface/api/api_registry.hpp"
 #include "scheduling/core_allocator.hpp"
 #include "util/static_store.hpp"
+#include "util/sys/fileutils.hpp"
 #include "util/sys/shmem_cache.hpp"
 #include "util/logger.hpp"
 #include "util/sys/timer.hpp"
@@ -22,6 +24,7 @@
 #include "util/sys/thread_pool.hpp"
 #include "app/job_tree.hpp"
 #include "app/sat/data/clause_metadata.hpp"
+#include "app/sat/data/sat_checkpoint.hpp"
 #include "app/sat/execution/solving_state.hpp"
 #include "app/sat/job/base_sat_job.hpp"
 #include "app/sat/job/sat_constants.h"
@@ -41,6 +44,7 @@ std::atomic_int ForkedSatJob::_static_subprocess_index = 1;
 ForkedSatJob::ForkedSatJob(const Parameters& params, const JobSetup& setup, AppMessageTable& table) : 
         BaseSatJob(params, setup, table) {
     _subproc_idx = _static_subprocess_index.fetch_add(1, std::memory_order_relaxed);
+    SatProcessPool::init(params);
 }
 
 void ForkedSatJob::appl_start() {
@@ -147,6 +151,15 @@ void ForkedSatJob::appl_resume() {
 }
 
 void ForkedSatJob::appl_terminate() {
+    if (!_preempted && _params.checkpointSuspendedJobs()) {
+        // The job has ended: its checkpoints (if any) are of no use anymore
+        const std::string dir = SatCheckpoint::getDirectory(_params);
+        FileUtils::rm(SatCheckpoint::getPath(dir, getId(), getIndex()));
+        if (getJobTree().isRoot()) {
+            for (auto& path : FileUtils::glob(SatCheckpoint::getPathPattern(dir, getId())))
+                FileUtils::rm(path);
+        }
+    }
     if (!_initialized) return;
 
     _core_alloc.returnAllCores();
@@ -341,6 +354,14 @@ void ForkedSatJob::appl_memoryPanic() {
     //_solver->crash();
 }
 
+void ForkedSatJob::appl_preempt() {
+    _preempted = true;
+    if (!_initialized || _done_locally || !_params.checkpointSuspendedJobs()) return;
+    if (ClauseMetadata::enabled()) return; // clause IDs cannot be carried over to another process
+    LOG(V3_VERB, "%s : preempted - checkpointing solvers\n", toStr());
+    _solver->requestCheckpoint();
+}
+
 void ForkedSatJob::appl_communicate() {
     if (!_clause_comm) return;
     _clause_comm->communicate();
@@ -395,6 +416,12 @@ int ForkedSatJob::getLastAdmittedNumLits() {
     if (!_initialized) return 0;
     return _solver->getLastAdmittedNumLits();
 }
+void ForkedSatJob::fetchImportUtilitySample(int& nbKept, int& nbDelivered) {
+    nbKept = 0;
+    nbDelivered = 0;
+    if (!_initialized) return;
+    _solver->fetchImportUtilitySample(nbKept, nbDelivered);
+}
 long long ForkedSatJob::getBestFoundObjectiveCost() {
     if (!_initialized) return 0;
     return _solver->getBestFoundObjectiveCost();
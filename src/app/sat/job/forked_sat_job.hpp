@@ -45,6 +45,7 @@ private:
 
     std::atomic_bool _done_locally = false;
     bool _assembling_proof = false;
+    bool _preempted = false; // dropped from this worker while suspended (may checkpoint)
     JobResult _internal_result;
 
     int _sharing_max_size {0};
@@ -74,6 +75,7 @@ public:
     void appl_dumpStats() override;
     bool appl_isDestructible() override;
     void appl_memoryPanic() override;
+    void appl_preempt() override;
 
     int getDemand() const override;
 
@@ -87,6 +89,7 @@ public:
     bool hasPreparedSharing() override;
     std::vector<int> getPreparedClauses(Checksum& checksum, int& successfulSolverId, int& numLits) override;
     int getLastAdmittedNumLits() override;
+    void fetchImportUtilitySample(int& nbKept, int& nbDelivered) override;
     long long getBestFoundObjectiveCost() override;
     virtual void setClauseBufferRevision(int revision) override;
     virtual void updateBestFoundSolutionCost(long long bestFoundSolutionCost) override;
@@ -28,17 +28,22 @@
 #include "util/sys/threading.hpp"
 #include "app/job_tree.hpp"
 #include "app/sat/sharing/buffer/buffer_builder.hpp"
+#include "app/sat/sharing/buffer/buffer_merger.hpp"
 #include "app/sat/sharing/buffer/buffer_reader.hpp"
+#include "util/categorized_external_memory.hpp"
 #include "util/sys/background_worker.hpp"
+#include "util/sys/fileutils.hpp"
 
 bool areIntervalsOverlapping(int begin1, int end1, int begin2, int end2);
 
 class HistoricClauseStorage {
 
-private:
+// The background worker and its tasks are exposed for unit testing.
+public:
     struct StorageDiagnostics {
         int numLitsInStorage;
         int numClausesInStorage;
+        size_t numLitsOnDisk;
         std::string slotLayout;
     };
 
@@ -76,6 +81,31 @@ private:
         std::unique_ptr<GenericClauseStore> _filter_store; // really only a dummy required for the filter
         std::unique_ptr<ExactClauseFilter> _filter;
 
+        // Older ("cold") slots are spilled to disk if more than _max_hot_slots slots are present.
+        // A cold slot consists of one or several clause buffers ("segments") on disk,
+        // so that merging cold slots is lossless. Cold clauses are not covered by the filter.
+        int _max_hot_slots;
+        struct ColdSlot {
+            int epochBegin;
+            int epochEnd;
+            std::vector<size_t> addresses;
+            size_t numInts {0};
+        };
+        std::list<ColdSlot> _cold_list;
+        std::string _disk_file;
+        std::unique_ptr<CategorizedExternalMemory<int>> _disk;
+        size_t _next_disk_address {0};
+        std::vector<size_t> _free_disk_addresses;
+        size_t _num_ints_on_disk {0};
+
+        // Cold slot which a catching-up child is expected to request next
+        struct PrefetchedSlot {
+            int epochBegin {-1};
+            int epochEnd {-1};
+            std::vector<int> clauses;
+        } _prefetched;
+        int _epoch_to_prefetch {-1};
+
         ConditionVariable _cond_var_bg_tasks;
         Mutex _mtx_bg_tasks;
         std::list<BackgroundTask> _bg_tasks;
@@ -84,9 +114,10 @@ private:
         int _num_open_tasks {0};
 
     public:
-        Worker(const AdaptiveClauseStore::Setup& setup) : _setup(setup),
+        Worker(const AdaptiveClauseStore::Setup& setup, int maxHotSlots, const std::string& diskFile) : _setup(setup),
                 _filter_store(new AdaptiveClauseStore(_setup)),
-                _filter(new ExactClauseFilter(*_filter_store, std::numeric_limits<int>::max(), _setup.maxEffectiveClauseLength)) {
+                _filter(new ExactClauseFilter(*_filter_store, std::numeric_limits<int>::max(), _setup.maxEffectiveClauseLength)),
+                _max_hot_slots(maxHotSlots), _disk_file(diskFile) {
             _bg_worker.run([this]() {runBackgroundWorker();});
         }
 
@@ -122,6 +153,11 @@ private:
                 _bg_worker.stopWithoutWaiting();
             }
             _cond_var_bg_tasks.notify();
+            _bg_worker.join();
+            if (_disk) {
+                _disk.reset();
+                FileUtils::rm(_disk_file);
+            }
         }
 
     private:
@@ -151,11 +187,31 @@ private:
                 }
                 addStorageDiagnosticsToTask(task);
                 task.finished = true;
+
+                // Use the idle time to load the cold slot a catching-up child will request next
+                prefetchColdSlot();
             }
         }
 
         void processRequestTask(BackgroundTask& task) {
 
+            if (areIntervalsOverlapping(_prefetched.epochBegin, _prefetched.epochEnd, task.epochBegin, task.epochEnd)) {
+                task.epochBegin = _prefetched.epochBegin;
+                task.epochEnd = _prefetched.epochEnd;
+                task.clauses = std::move(_prefetched.clauses);
+                _prefetched = PrefetchedSlot();
+                _epoch_to_prefetch = task.epochEnd;
+                return;
+            }
+            for (auto& slot : _cold_list) {
+                if (areIntervalsOverlapping(slot.epochBegin, slot.epochEnd, task.epochBegin, task.epochEnd)) {
+                    task.epochBegin = slot.epochBegin;
+                    task.epochEnd = slot.epochEnd;
+                    task.clauses = restoreColdSlot(slot);
+                    _epoch_to_prefetch = task.epochEnd;
+                    return;
+                }
+            }
             for (auto& slot : _storage_list) {
                 if (areIntervalsOverlapping(slot.epochBegin, slot.epochEnd, task.epochBegin, task.epochEnd)) {
                     // Pretend the task is for this exact slot
@@ -186,6 +242,16 @@ private:
                         break;
                     }
                 }
+                for (auto& slot : _cold_list) {
+                    if (success) break;
+                    if (areIntervalsOverlapping(slot.epochBegin, slot.epochEnd, task.epochBegin, task.epochEnd)) {
+                        // cold clauses are not filtered: append all clauses as a new segment
+                        // and forward all of them to the solvers, which filter duplicates themselves
+                        appendSegmentToColdSlot(slot, task.clauses);
+                        if (slot.epochBegin == _prefetched.epochBegin) _prefetched = PrefetchedSlot();
+                        success = true;
+                    }
+                }
                 if (!success) task.clauses.clear(); // no clauses to import to the solver
 
             } else {
@@ -202,7 +268,95 @@ private:
                 //LOG(V4_VVER, "Added %i/%i cls to HCS\n", accepted, total);
 
                 // Repair invariant of having at most _max_same_breadth_slots slots of the same breadth.
-                mergeSlots();
+                mergeSlots(_storage_list, [&](Slot& into, Slot& from) {mergeDatabases(into.cdb, from.cdb);});
+
+                // Spill the oldest slots to disk as necessary
+                if (_max_hot_slots > 0 && _storage_list.size() > _max_hot_slots) {
+                    while (_storage_list.size() > _max_hot_slots) spillOldestSlot();
+                    mergeSlots(_cold_list, [&](ColdSlot& into, ColdSlot& from) {
+                        into.addresses.insert(into.addresses.end(), from.addresses.begin(), from.addresses.end());
+                        into.numInts += from.numInts;
+                    });
+                    _prefetched = PrefetchedSlot();
+                }
+            }
+        }
+
+        void spillOldestSlot() {
+            auto& slot = _storage_list.front();
+            auto clauses = slot.cdb.readBuffer();
+
+            // The clauses are not tracked in memory any more
+            BufferReader reader = slot.cdb.getBufferReader(clauses.data(), clauses.size());
+            Mallob::Clause cls = reader.getNextIncomingClause();
+            while (cls.begin != nullptr) {
+                _filter->erase(ProducedClauseCandidate(cls.begin, cls.size, cls.lbd, 0, -1));
+                cls = reader.getNextIncomingClause();
+            }
+
+            ColdSlot coldSlot;
+            coldSlot.epochBegin = slot.epochBegin;
+            coldSlot.epochEnd = slot.epochEnd;
+            appendSegmentToColdSlot(coldSlot, clauses);
+            _cold_list.push_back(std::move(coldSlot));
+            _storage_list.pop_front();
+        }
+
+        void appendSegmentToColdSlot(ColdSlot& slot, const std::vector<int>& clauses) {
+            if (!_disk) _disk.reset(new CategorizedExternalMemory<int>(_disk_file, 1<<16));
+            size_t address;
+            if (_free_disk_addresses.empty()) address = _next_disk_address++;
+            else {
+                address = _free_disk_addresses.back();
+                _free_disk_addresses.pop_back();
+            }
+            for (int lit : clauses) _disk->add(address, lit);
+            slot.addresses.push_back(address);
+            slot.numInts += clauses.size();
+            _num_ints_on_disk += clauses.size();
+        }
+
+        // Reads a cold slot back into memory. The blocks of its segments are freed on disk
+        // and the (merged) clauses are written back as a single segment, reusing these blocks.
+        std::vector<int> restoreColdSlot(ColdSlot& slot) {
+            std::vector<std::vector<int>> segments(slot.addresses.size());
+            for (size_t i = 0; i < slot.addresses.size(); i++) {
+                _disk->fetchAndRemove(slot.addresses[i], segments[i]);
+                _free_disk_addresses.push_back(slot.addresses[i]);
+            }
+            _num_ints_on_disk -= slot.numInts;
+            slot.addresses.clear();
+            slot.numInts = 0;
+
+            std::vector<int> clauses;
+            if (segments.size() == 1) clauses = std::move(segments.front());
+            else {
+                // Several segments: merge them into a single buffer without any size limit
+                BufferMerger merger(INT32_MAX, _setup.maxEffectiveClauseLength, 0, _setup.slotsForSumOfLengthAndLbd);
+                for (auto& segment : segments) {
+                    merger.add(_filter_store->getBufferReader(segment.data(), segment.size()));
+                }
+                clauses = merger.mergeDiscardingExcess();
+            }
+            appendSegmentToColdSlot(slot, clauses);
+            return clauses;
+        }
+
+        void prefetchColdSlot() {
+            if (_epoch_to_prefetch < 0) return;
+            int epoch = _epoch_to_prefetch;
+            _epoch_to_prefetch = -1;
+            {
+                // Do not delay any pending tasks
+                auto lock = _mtx_bg_tasks.getLock();
+                if (!_bg_tasks.empty() && !_bg_tasks.back().finished) return;
+            }
+            for (auto& slot : _cold_list) {
+                if (slot.epochBegin != epoch) continue;
+                _prefetched.epochBegin = slot.epochBegin;
+                _prefetched.epochEnd = slot.epochEnd;
+                _prefetched.clauses = restoreColdSlot(slot);
+                return;
             }
         }
 
@@ -214,19 +368,21 @@ private:
             }
             task.storageDiagnostics.numClausesInStorage = _filter->size(0);
             task.storageDiagnostics.numLitsInStorage = numStoredLits;
+            task.storageDiagnostics.numLitsOnDisk = _num_ints_on_disk;
             if (_storage_list.back().epochEnd < 80)
                 task.storageDiagnostics.slotLayout = reportSlots();
             else
                 task.storageDiagnostics.slotLayout = "...";
         }
 
-        void mergeSlots() {
+        template <typename S, typename F>
+        void mergeSlots(std::list<S>& list, F mergeInto) {
 
-            if (_storage_list.empty()) return;
+            if (list.empty()) return;
 
             //LOG(V4_VVER, "HCS SLOTS %s\n", reportSlots().c_str());
 
-            auto it = _storage_list.end(); --it;
+            auto it = list.end(); --it;
             int lastBreadth = 1;
             int numSlotsThisBreadth = 0;
             while (true) {
@@ -245,24 +401,24 @@ private:
                 if (numSlotsThisBreadth <= _max_same_breadth_slots) {
                     // all ok
                     // finish or go to next
-                    if (it == _storage_list.begin()) break;
+                    if (it == list.begin()) break;
                     --it;
                     continue;
                 }
 
                 // One too many slots of this breadth: Repair by merging.
                 // The iterator "it" will point to the first ("leftmost") slot of this breadth
-                assert(it != _storage_list.end());
+                assert(it != list.end());
                 auto itAfter = std::next(it);
-                assert(itAfter != _storage_list.end());
+                assert(itAfter != list.end());
                 auto& slotAfter = *itAfter;
 
                 // Update slot breadth
                 slot.epochEnd = slotAfter.epochEnd;
-                // Merge the two clause databases
-                mergeDatabases(slot.cdb, slotAfter.cdb);
+                // Merge the two slots' contents
+                mergeInto(slot, slotAfter);
                 // Delete old slot
-                it = _storage_list.erase(itAfter);
+                it = list.erase(itAfter);
                 --it; // visit the merged slot again
             }
         }
@@ -329,6 +485,9 @@ private:
         std::string reportSlots() const {
 
             std::string out;
+            for (auto& slot : _cold_list) {
+                for (int i = 0; i < slot.epochEnd-slot.epochBegin; i++) out += "#";
+            }
             std::string marker = "·";
             for (auto& slot : _storage_list) {
                 //LOG(V4_VVER, "SLOT [%i,%i) #lits=%i\n", slot.epochBegin, slot.epochEnd, slot.cdb.getCurrentlyUsedLiterals());
@@ -349,8 +508,9 @@ private:
     std::vector<std::pair<int, int>> _missing_epoch_intervals;
 
 public:
-    HistoricClauseStorage(const AdaptiveClauseStore::Setup& setup, BaseSatJob* job) : 
-        _job(job), _worker(setup)  {}
+    HistoricClauseStorage(const AdaptiveClauseStore::Setup& setup, BaseSatJob* job,
+            int maxHotSlots = 0, const std::string& diskFile = "") : 
+        _job(job), _worker(setup, maxHotSlots, diskFile)  {}
 
     void importSharing(int epoch, std::vector<int>&& clauses) {
         
@@ -419,9 +579,9 @@ public:
                 LOG(V4_VVER, "HCS digest historic clauses, buflen=%i\n", task.clauses.size());
                 _job->digestHistoricClauses(task.epochBegin, task.epochEnd, std::move(task.clauses));
             }
-            LOG(V4_VVER, "HCS %i cls / %i lits, layout %s\n",
+            LOG(V4_VVER, "HCS %i cls / %i lits (+%lu on disk), layout %s\n",
                 task.storageDiagnostics.numClausesInStorage, task.storageDiagnostics.numLitsInStorage, 
-                task.storageDiagnostics.slotLayout.c_str());
+                task.storageDiagnostics.numLitsOnDisk, task.storageDiagnostics.slotLayout.c_str());
         }
     }
 
@@ -0,0 +1,104 @@
+
+#pragma once
+
+#include <climits>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "app/sat/job/inplace_sharing_aggregation.hpp"
+#include "util/logger.hpp"
+#include "util/sys/shared_memory.hpp"
+#include "util/sys/timer.hpp"
+
+// Hands an aggregated clause buffer from a job node to its parent node
+// if the parent resides on the same host. The buffer is deposited in shared memory
+// and only a small reference is sent over MPI, which the parent resolves
+// when it merges the incoming buffers. As a consequence, only the topmost node
+// of each host-local part of the job tree sends actual clauses over the network.
+// The depositing node owns the shared memory segment and keeps it until the parent
+// has confirmed its consumption: the result of the epoch, broadcast from the root, can only
+// arrive after the parent has merged the buffer. If the epoch ends without this result,
+// the segment is retained for a grace period (see retain()).
+// Buffers are deposited and released by the main thread only.
+class HostLocalClauseBuffer {
+
+private:
+    // A regular clause buffer ends with the ID of the successful solver, which is >= -1.
+    static constexpr int REFERENCE_MARKER = INT_MIN + 0x484c;
+    static constexpr int REFERENCE_SIZE = 5;
+    // Seconds an unconfirmed buffer remains available after its epoch ended
+    static constexpr float RETENTION_PERIOD = 10;
+
+    std::string _shmem_id;
+    int _job_id;
+    int _context_id;
+    int _epoch;
+    void* _data {nullptr};
+    size_t _size {0};
+
+public:
+    HostLocalClauseBuffer(int jobId, int contextId, int epoch, const std::vector<int>& buffer) :
+            _shmem_id(getShmemId(jobId, contextId, epoch)), _job_id(jobId), _context_id(contextId), _epoch(epoch),
+            _size(buffer.size() * sizeof(int)) {
+        _data = SharedMemory::create(_shmem_id, _size);
+        if (_data) memcpy(_data, buffer.data(), _size);
+        else LOG(V1_WARN, "[WARN] Could not create host-local clause buffer %s\n", _shmem_id.c_str());
+    }
+    ~HostLocalClauseBuffer() {
+        if (_data) SharedMemory::free(_shmem_id, (char*) _data, _size);
+    }
+
+    bool valid() const {return _data != nullptr;}
+
+    std::vector<int> getReference() const {
+        return {(int) (_size / sizeof(int)), _job_id, _context_id, _epoch, REFERENCE_MARKER};
+    }
+
+    // Keep a buffer whose consumption by the parent has not been confirmed (e.g., because
+    // the epoch was cancelled) available for the parent during a grace period.
+    static void retain(std::unique_ptr<HostLocalClauseBuffer>&& buffer) {
+        releaseExpired();
+        getRetained().push_back({Timer::elapsedSeconds() + RETENTION_PERIOD, std::move(buffer)});
+    }
+    static void releaseExpired() {
+        auto& retained = getRetained();
+        const float time = Timer::elapsedSeconds();
+        while (!retained.empty() && retained.front().first <= time) retained.pop_front();
+    }
+
+    static bool isReference(const std::vector<int>& elem) {
+        return elem.size() == REFERENCE_SIZE && elem.back() == REFERENCE_MARKER;
+    }
+
+    // Replace the provided reference with a copy of the referenced clause buffer.
+    // If the buffer is not available (any more), the reference is replaced with
+    // a neutral element and false is returned.
+    static bool resolve(std::vector<int>& elem) {
+        const int nbInts = elem[0];
+        const std::string shmemId = getShmemId(elem[1], elem[2], elem[3]);
+        const size_t size = nbInts * sizeof(int);
+        int* data = (int*) SharedMemory::access(shmemId, size, SharedMemory::READONLY);
+        if (!data) {
+            LOG(V1_WARN, "[WARN] Host-local clause buffer %s not available\n", shmemId.c_str());
+            elem = InplaceClauseAggregation::neutralElem();
+            return false;
+        }
+        elem.assign(data, data + nbInts);
+        SharedMemory::close((char*) data, size);
+        return true;
+    }
+
+private:
+    static std::list<std::pair<float, std::unique_ptr<HostLocalClauseBuffer>>>& getRetained() {
+        static std::list<std::pair<float, std::unique_ptr<HostLocalClauseBuffer>>> retained;
+        return retained;
+    }
+
+    static std::string getShmemId(int jobId, int contextId, int epoch) {
+        return "/edu.kit.iti.mallob.hostlocalcls." + std::to_string(jobId) + "."
+            + std::to_string(contextId) + "." + std::to_string(epoch);
+    }
+};
@@ -0,0 +1,62 @@
+
+#pragma once
+
+#include <algorithm>
+
+#include "util/logger.hpp"
+
+// Adapts the clause sharing volume and the quality limits for clause prioritization
+// to the utility of shared clauses, i.e., the (global) fraction of delivered clauses
+// which the solvers actually kept at import rather than discarding them.
+// The controller is run at the root of the job tree; its output is broadcast
+// to all job nodes with the initiation of each sharing epoch.
+class ImportUtilityController {
+
+private:
+    static constexpr int minSampleSize = 100; // min. number of delivered clauses for an update
+    static constexpr float estimateRatio = 0.7; // higher means slower estimate updates
+    static constexpr float lowUtility = 0.3; // below: share fewer and better clauses
+    static constexpr float highUtility = 0.6; // above: relax volume and quality limits again
+    static constexpr float shrinkFactor = 0.9;
+    static constexpr float growFactor = 1.1;
+    static constexpr int minQualityLimit = 2;
+
+    const float _min_volume_factor;
+    const int _max_quality_length_limit;
+    const int _max_quality_lbd_limit;
+
+    float _utility {-1};
+    float _volume_factor {1};
+    int _quality_length_limit;
+    int _quality_lbd_limit;
+
+public:
+    ImportUtilityController(float minVolumeFactor, int qualityLengthLimit, int qualityLbdLimit) :
+        _min_volume_factor(minVolumeFactor), _max_quality_length_limit(qualityLengthLimit),
+        _max_quality_lbd_limit(qualityLbdLimit), _quality_length_limit(qualityLengthLimit),
+        _quality_lbd_limit(qualityLbdLimit) {}
+
+    void update(int nbKept, int nbDelivered) {
+        if (nbDelivered < minSampleSize) return;
+        const float utility = nbKept / (float) nbDelivered;
+        _utility = _utility < 0 ? utility : estimateRatio * _utility + (1-estimateRatio) * utility;
+
+        if (_utility < lowUtility) {
+            _volume_factor = std::max(_min_volume_factor, shrinkFactor * _volume_factor);
+            _quality_length_limit = std::max(minQualityLimit, (int) (shrinkFactor * _quality_length_limit));
+            _quality_lbd_limit = std::max(minQualityLimit, (int) (shrinkFactor * _quality_lbd_limit));
+        } else if (_utility > highUtility) {
+            _volume_factor = std::min(1.f, growFactor * _volume_factor);
+            _quality_length_limit = std::min(_max_quality_length_limit,
+                std::max(_quality_length_limit+1, (int) (growFactor * _quality_length_limit)));
+            _quality_lbd_limit = std::min(_max_quality_lbd_limit,
+                std::max(_quality_lbd_limit+1, (int) (growFactor * _quality_lbd_limit)));
+        }
+        LOG(V4_VVER, "CS import utility %i/%i est=%.3f ~> vf=%.3f qcll=%i qlbdl=%i\n", nbKept, nbDelivered,
+            _utility, _volume_factor, _quality_length_limit, _quality_lbd_limit);
+    }
+
+    float getVolumeFactor() const {return _volume_factor;}
+    int getQualityLengthLimit() const {return _quality_length_limit;}
+    int getQualityLbdLimit() const {return _quality_lbd_limit;}
+};
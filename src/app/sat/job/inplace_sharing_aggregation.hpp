@@ -13,18 +13,17 @@ struct InplaceClauseAggregation {
     InplaceClauseAggregation(std::vector<int>& buffer) : buffer(buffer) {}
 
     long long& bestFoundSolutionCost() {
-        return * (long long*) (buffer.data() + (buffer.size()-4-sizeof(long long)/sizeof(int)));
+        return * (long long*) (buffer.data() + (buffer.size()-6-sizeof(long long)/sizeof(int)));
     };
+    int& numDeliveredImports() {return buffer[buffer.size()-6];}
+    int& numKeptImports() {return buffer[buffer.size()-5];}
     int& maxRevision() {return buffer[buffer.size()-4];}
     int& numInputLiterals() {return buffer[buffer.size()-3];}
     int& numAggregatedNodes() {return buffer[buffer.size()-2];}
     int& successfulSolver() {return buffer[buffer.size()-1];}
 
     void stripToRawBuffer() {
-        buffer.pop_back();
-        buffer.pop_back();
-        buffer.pop_back();
-        buffer.pop_back();
+        for (int i = 0; i < 6; i++) buffer.pop_back();
         for (int i = 0; i < sizeof(long long)/sizeof(int); i++) buffer.pop_back();
     }
 
@@ -35,12 +34,14 @@ struct InplaceClauseAggregation {
         }
     }
 
-    static int numMetadataInts() {return 4 + sizeof(long long)/sizeof(int);}
+    static int numMetadataInts() {return 6 + sizeof(long long)/sizeof(int);}
     static InplaceClauseAggregation prepareRawBuffer(std::vector<int>& buffer,
             int maxRevision=-1, int numInputLits=0, int numAggregated=1, int winningSolverId=-1,
-            long long bestFoundObjectiveCost=LLONG_MAX) {
+            long long bestFoundObjectiveCost=LLONG_MAX, int numKeptImports=0, int numDeliveredImports=0) {
         for (int i = 0; i < sizeof(long long)/sizeof(int); i++)
             buffer.push_back(* (((int*) &bestFoundObjectiveCost) + i));
+        buffer.push_back(numDeliveredImports);
+        buffer.push_back(numKeptImports);
         buffer.push_back(maxRevision);
         buffer.push_back(numInputLits);
         buffer.push_back(numAggregated);
@@ -276,6 +276,10 @@ public:
     virtual int getLastAdmittedNumLits() override {
         return _last_num_admitted_cross_cls_to_import;
     }
+    virtual void fetchImportUtilitySample(int& nbKept, int& nbDelivered) override {
+        nbKept = 0;
+        nbDelivered = 0;
+    }
     long long getBestFoundObjectiveCost() override {
         return _best_found_solution_cost;
     }
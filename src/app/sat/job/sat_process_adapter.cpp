@@ -26,6 +26,7 @@
 #include "util/sys/terminator.hpp"
 #include "util/sys/thread_pool.hpp"
 #include "app/sat/job/sat_shared_memory.hpp"
+#include "app/sat/job/sat_process_pool.hpp"
 #include "util/option.hpp"
 #include "util/sys/tmpdir.hpp"
 #include "util/sys/watchdog.hpp"
@@ -59,7 +60,7 @@ SatProcessAdapter::SatProcessAdapter(Parameters&& params, SatProcessConfig&& con
 void SatProcessAdapter::doWriteRevisions() {
 
     if (_num_revisions_to_write.load(std::memory_order_relaxed) == 0) return;
-    if (!_initialized || _hsm->doTerminate || !_mtx_revisions.tryLock()) return;
+    if (!_initialized || SatSharedMemory::isSignalled(_hsm->doTerminate) || !_mtx_revisions.tryLock()) return;
 
     if (_bg_writer_running) {
         _mtx_revisions.unlock();
@@ -95,6 +96,7 @@ void SatProcessAdapter::doWriteRevisions() {
                 vecRev.push_back(desiredRev);
                 assert(revData.revision == _next_revision_to_write);
                 pipe.get()->writeData(std::move(vecRev), CLAUSE_PIPE_START_NEXT_REVISION);
+                _hsm->childEvent.notify();
                 LOG(V4_VVER, "DBG Done writing next revision %i\n", revData.revision);
                 _next_revision_to_write++;
                 break;
@@ -124,9 +126,12 @@ void SatProcessAdapter::doInitialize() {
         {pipeParentToChild, _hsm->pipeBufSize},
         {pipeChildToParent, _hsm->pipeBufSize}, true));
 
-    // Create SAT solving child process
-    Subprocess subproc(_params, "mallob_sat_process", true);
-    pid_t res = subproc.start();
+    // Create SAT solving child process (or take one from the pool of idle processes)
+    pid_t res = SatProcessPool::tryAssign(_params);
+    if (res < 0) {
+        Subprocess subproc(_params, "mallob_sat_process", true);
+        res = subproc.start();
+    }
 
     // Set up a watchdog
     auto thisTid = Proc::getTid();
@@ -138,9 +143,11 @@ void SatProcessAdapter::doInitialize() {
     watchdog.setAbortPeriod(10'000);
 
     // Wait until the process is properly initialized
-    while (!_hsm->didStart && !Process::didChildExit(res)) {
+    while (!SatSharedMemory::isSignalled(_hsm->didStart) && !Process::didChildExit(res)) {
         Process::resume(res);
-        usleep(1000 * 10); // 10 ms
+        int eventState = _hsm->parentEvent.state();
+        if (SatSharedMemory::isSignalled(_hsm->didStart)) break;
+        _hsm->parentEvent.wait(eventState, 10); // 10 ms at most
     }
 
     // Transfer first formula revision over pipe
@@ -152,6 +159,7 @@ void SatProcessAdapter::doInitialize() {
     }()); // currently (i.e., initially) desired revision
     assert(_next_revision_to_write == 0);
     _guard_pipe.lock().get()->writeData(std::move(rev0), CLAUSE_PIPE_START_NEXT_REVISION);
+    _hsm->childEvent.notify();
     _next_revision_to_write = 1;
 
     // Change adapter state
@@ -162,7 +170,7 @@ void SatProcessAdapter::doInitialize() {
 }
 
 bool SatProcessAdapter::isFullyInitialized() {
-    return _initialized && _hsm->isInitialized;
+    return _initialized && SatSharedMemory::isSignalled(_hsm->isInitialized);
 }
 
 void SatProcessAdapter::appendRevisions(const std::vector<RevisionData>& revisions, int desiredRevision, int nbThreads) {
@@ -205,7 +213,7 @@ void SatProcessAdapter::applySolvingState(bool initialize) {
 }
 
 void SatProcessAdapter::doTerminateInitializedProcess() {
-    _hsm->doTerminate = true; // Kindly ask child process to terminate.
+    _hsm->signalChild(_hsm->doTerminate); // Kindly ask child process to terminate.
 }
 
 void SatProcessAdapter::collectClauses(int maxSize) {
@@ -213,7 +221,7 @@ void SatProcessAdapter::collectClauses(int maxSize) {
         return;
     _guard_pipe.lock().get()->writeData({maxSize}, CLAUSE_PIPE_PREPARE_CLAUSES);
     _clause_collecting_stage = QUERIED;
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childEvent.notify();
 }
 bool SatProcessAdapter::hasCollectedClauses() {
     return !_initialized || _state != SolvingStates::ACTIVE || _clause_collecting_stage == RETURNED;
@@ -228,6 +236,13 @@ std::vector<int> SatProcessAdapter::getCollectedClauses(int& successfulSolverId,
 int SatProcessAdapter::getLastAdmittedNumLits() {
     return _last_admitted_nb_lits;
 }
+void SatProcessAdapter::fetchImportUtilitySample(int& nbKept, int& nbDelivered) {
+    // each sample is only reported once
+    nbKept = _nb_kept_imports;
+    nbDelivered = _nb_delivered_imports;
+    _nb_kept_imports = 0;
+    _nb_delivered_imports = 0;
+}
 long long SatProcessAdapter::getBestFoundObjectiveCost() const {
     return _best_found_objective_cost;
 }
@@ -236,6 +251,7 @@ void SatProcessAdapter::updateBestFoundSolutionCost(long long bestFoundSolutionC
     _guard_pipe.lock().get()->writeData(
         {(int*) &bestFoundSolutionCost, (int*) ((&bestFoundSolutionCost)+1)},
         CLAUSE_PIPE_UPDATE_BEST_FOUND_OBJECTIVE_COST);
+    _hsm->childEvent.notify();
 }
 
 void SatProcessAdapter::filterClauses(int epoch, std::vector<int>&& clauses) {
@@ -243,7 +259,7 @@ void SatProcessAdapter::filterClauses(int epoch, std::vector<int>&& clauses) {
     _guard_pipe.lock().get()->writeData(std::move(clauses), {epoch},
         CLAUSE_PIPE_FILTER_IMPORT);
     _epoch_of_export_buffer = epoch;
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childEvent.notify();
 }
 
 bool SatProcessAdapter::hasFilteredClauses(int epoch) {
@@ -272,24 +288,26 @@ void SatProcessAdapter::applyFilter(int epoch, std::vector<int>&& filter) {
     if (epoch != _epoch_of_export_buffer) return; // ignore filter if the corresponding clauses are not present
     auto pipe = _guard_pipe.lock();
     if (*pipe) pipe.get()->writeData(std::move(filter), {epoch}, CLAUSE_PIPE_DIGEST_IMPORT);
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childEvent.notify();
 }
 
 void SatProcessAdapter::digestClausesWithoutFilter(int epoch, std::vector<int>&& clauses, bool stateless) {
     if (!_initialized || _state != SolvingStates::ACTIVE) return;
     _guard_pipe.lock().get()->writeData(std::move(clauses), {epoch, stateless?1:0},
         CLAUSE_PIPE_DIGEST_IMPORT_WITHOUT_FILTER);
-    if (_hsm->isInitialized) Process::wakeUp(_child_pid);
+    _hsm->childEvent.notify();
 }
 
 void SatProcessAdapter::returnClauses(std::vector<int>&& clauses) {
     if (!_initialized || _state != SolvingStates::ACTIVE) return;
     _guard_pipe.lock().get()->writeData(std::move(clauses), {_clause_buffer_revision}, CLAUSE_PIPE_RETURN_CLAUSES);
+    _hsm->childEvent.notify();
 }
 
 void SatProcessAdapter::digestHistoricClauses(int epochBegin, int epochEnd, std::vector<int>&& clauses) {
     if (!_initialized || _state != SolvingStates::ACTIVE) return;
     _guard_pipe.lock().get()->writeData(std::move(clauses), {epochBegin, epochEnd, _clause_buffer_revision}, CLAUSE_PIPE_DIGEST_HISTORIC);
+    _hsm->childEvent.notify();
 }
 
 
@@ -303,8 +321,8 @@ SatProcessAdapter::SubprocessStatus SatProcessAdapter::check() {
     if (!_initialized) return NORMAL;
 
     int exitStatus = 0;
-    if (!_hsm->doTerminate && !Terminator::isTerminating()
-        && (_hsm->didTerminate ||
+    if (!SatSharedMemory::isSignalled(_hsm->doTerminate) && !Terminator::isTerminating()
+        && (SatSharedMemory::isSignalled(_hsm->didTerminate) ||
             (Process::didChildExit(_child_pid, &exitStatus) && exitStatus != 0))) {
         // Child has exited without being told to.
         if (exitStatus == SIGUSR2) {
@@ -362,7 +380,10 @@ SatProcessAdapter::SubprocessStatus SatProcessAdapter::check() {
             int epoch = filter.back(); filter.pop_back();
             _filters_by_epoch[epoch] = std::move(filter);
         } else if (c == CLAUSE_PIPE_DIGEST_IMPORT) {
-            _last_admitted_nb_lits = pipe.get()->readData(c).front();
+            auto admitted = pipe.get()->readData(c);
+            _last_admitted_nb_lits = admitted[0];
+            _nb_kept_imports += admitted[1];
+            _nb_delivered_imports += admitted[2];
         } else if (c == CLAUSE_PIPE_SOLUTION) {
             std::vector<int> solution = pipe.get()->readData(c);
             pipe.unlock();
@@ -386,6 +407,7 @@ SatProcessAdapter::SubprocessStatus SatProcessAdapter::check() {
         }
         if (_thread_count_update && pipe.get()->hasSpaceForWriting()) {
             pipe.get()->writeData({_nb_threads}, CLAUSE_PIPE_SET_THREAD_COUNT);
+            _hsm->childEvent.notify();
             _thread_count_update = false;
         }
     }
@@ -405,7 +427,9 @@ void SatProcessAdapter::waitUntilChildExited() {
     doTerminateInitializedProcess(); // make sure that the process receives a terminate signal
     while (!Process::didChildExit(_child_pid)) {
         Process::resume(_child_pid); // make sure that the process isn't frozen
-        usleep(10*1000); // 10ms
+        int eventState = _hsm->parentEvent.state();
+        if (Process::didChildExit(_child_pid)) break;
+        _hsm->parentEvent.wait(eventState, 10); // 10 ms at most
     }
 }
 
@@ -458,16 +482,23 @@ void* SatProcessAdapter::createSharedMemoryBlock(std::string shmemSubId, size_t
 }
 
 void SatProcessAdapter::crash() {
-    _hsm->doCrash = true;
+    _hsm->signalChild(_hsm->doCrash);
+}
+
+void SatProcessAdapter::requestCheckpoint() {
+    // The child writes the checkpoint as soon as it is told to terminate
+    _hsm->signalChild(_hsm->doCheckpoint);
 }
 
 void SatProcessAdapter::reduceThreadCount() {
     if (!_initialized || _state != SolvingStates::ACTIVE) return;
     _guard_pipe.lock().get()->writeData({}, CLAUSE_PIPE_REDUCE_THREAD_COUNT);
+    _hsm->childEvent.notify();
 }
 void SatProcessAdapter::setThreadCount(int nbThreads) {
     if (!_initialized || _state != SolvingStates::ACTIVE) return;
     _guard_pipe.lock().get()->writeData({nbThreads}, CLAUSE_PIPE_SET_THREAD_COUNT);
+    _hsm->childEvent.notify();
 }
 
 SatProcessAdapter::~SatProcessAdapter() {
@@ -90,6 +90,8 @@ private:
     std::future<void> _bg_writer;
 
     int _last_admitted_nb_lits {0};
+    int _nb_kept_imports {0};
+    int _nb_delivered_imports {0};
     int _successful_solver_id {-1};
     int _nb_incoming_lits {0};
     enum ClauseCollectingStage {NONE, QUERIED, RETURNED} _clause_collecting_stage {NONE};
@@ -132,6 +134,7 @@ public:
     void setDesiredRevision(int desiredRevision) {_desired_revision = desiredRevision;}
     void preregisterShmemObject(ShmemObject&& obj);
     void crash();
+    void requestCheckpoint();
     void reduceThreadCount();
     void setThreadCount(int nbThreads);
 
@@ -145,6 +148,7 @@ public:
     bool hasCollectedClauses();
     std::vector<int> getCollectedClauses(int& successfulSolverId, int& numLits);
     int getLastAdmittedNumLits();
+    void fetchImportUtilitySample(int& nbKept, int& nbDelivered);
     long long getBestFoundObjectiveCost() const;
 
     void filterClauses(int epoch, std::vector<int>&& clauses);
@@ -0,0 +1,129 @@
+
+#include "sat_process_pool.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include "util/logger.hpp"
+#include "util/sys/futex.hpp"
+#include "util/sys/proc.hpp"
+#include "util/sys/process.hpp"
+#include "util/sys/shared_memory.hpp"
+#include "util/sys/thread_pool.hpp"
+
+#ifndef MALLOB_SUBPROC_DISPATCH_PATH
+#define MALLOB_SUBPROC_DISPATCH_PATH ""
+#endif
+#include "util/sys/subprocess.hpp"
+
+Mutex SatProcessPool::_mtx_pool;
+std::list<pid_t> SatProcessPool::_idle_processes;
+const Parameters* SatProcessPool::_params {nullptr};
+int SatProcessPool::_target_size {0};
+int SatProcessPool::_nb_spawning {0};
+
+void SatProcessPool::init(const Parameters& params) {
+    // A subprocess prefix (e.g., a profiler) is meant to wrap each individual job's process
+    if (params.satProcessPoolSize() == 0 || params.subprocessPrefix.isSet()) return;
+    {
+        auto lock = _mtx_pool.getLock();
+        if (_params) return;
+        _params = &params;
+        _target_size = params.satProcessPoolSize();
+    }
+    LOG(V3_VERB, "Filling pool of %i SAT processes\n", _target_size);
+    replenish();
+}
+
+pid_t SatProcessPool::tryAssign(const Parameters& params) {
+
+    // Serialize program options, separated by zeroes
+    std::string args;
+    for (auto& arg : params.getParamsAsStringList()) {
+        args += arg;
+        args.push_back('\0');
+    }
+    if (args.size() > Channel::ARGS_CAPACITY) return -1;
+
+    pid_t assigned = -1;
+    {
+        auto lock = _mtx_pool.getLock();
+        for (auto it = _idle_processes.begin(); it != _idle_processes.end(); ) {
+            const pid_t pid = *it;
+            if (Process::didChildExit(pid)) {
+                it = _idle_processes.erase(it);
+                continue;
+            }
+            auto channel = (Channel*) SharedMemory::access(getShmemId(pid), sizeof(Channel));
+            if (!channel) {++it; continue;} // not set up yet
+            if (__atomic_load_n(&channel->state, __ATOMIC_ACQUIRE) != Channel::WAITING) {
+                SharedMemory::close((char*) channel, sizeof(Channel));
+                ++it;
+                continue;
+            }
+            memcpy(channel->args, args.data(), args.size());
+            channel->argsLength = args.size();
+            __atomic_store_n(&channel->state, Channel::ASSIGNED, __ATOMIC_RELEASE);
+            Futex::wakeAll(&channel->state);
+            SharedMemory::close((char*) channel, sizeof(Channel));
+            _idle_processes.erase(it);
+            assigned = pid;
+            break;
+        }
+    }
+    if (assigned == -1) return -1;
+
+    LOG(V4_VVER, "Assigned pooled SAT process pid=%i\n", assigned);
+    replenish();
+    return assigned;
+}
+
+bool SatProcessPool::awaitAssignment(Parameters& params) {
+
+    const pid_t parentPid = Proc::getParentPid();
+    const std::string shmemId = getShmemId(Proc::getPid());
+    auto channel = (Channel*) SharedMemory::create(shmemId, sizeof(Channel));
+    if (!channel) return false;
+    __atomic_store_n(&channel->state, Channel::WAITING, __ATOMIC_RELEASE);
+
+    while (__atomic_load_n(&channel->state, __ATOMIC_ACQUIRE) != Channel::ASSIGNED) {
+        Futex::wait(&channel->state, Channel::WAITING, 1000);
+        // Exit if the parent is gone
+        if (Proc::getParentPid() != parentPid) {
+            SharedMemory::free(shmemId, (char*) channel, sizeof(Channel));
+            return false;
+        }
+    }
+
+    // Parse program options
+    std::vector<std::string> args;
+    size_t begin = 0;
+    for (size_t i = 0; i < (size_t) channel->argsLength; i++) {
+        if (channel->args[i] != '\0') continue;
+        args.emplace_back(channel->args+begin, i-begin);
+        begin = i+1;
+    }
+    SharedMemory::free(shmemId, (char*) channel, sizeof(Channel));
+    params.init(args);
+    return true;
+}
+
+void SatProcessPool::replenish() {
+    int nbToSpawn;
+    {
+        auto lock = _mtx_pool.getLock();
+        nbToSpawn = _target_size - _idle_processes.size() - _nb_spawning;
+        if (nbToSpawn <= 0) return;
+        _nb_spawning += nbToSpawn;
+    }
+    // Spawn processes off the caller's critical path
+    ProcessWideThreadPool::get().addTask([nbToSpawn]() {
+        for (int i = 0; i < nbToSpawn; i++) {
+            Subprocess subproc(*_params, "mallob_sat_process", POOLED_ARG, false);
+            pid_t pid = subproc.start();
+            auto lock = _mtx_pool.getLock();
+            _idle_processes.push_back(pid);
+            _nb_spawning--;
+        }
+    });
+}
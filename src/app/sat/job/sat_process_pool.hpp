@@ -0,0 +1,57 @@
+
+#pragma once
+
+#include <sys/types.h>
+#include <list>
+#include <string>
+
+#include "util/params.hpp"
+#include "util/sys/threading.hpp"
+
+// Pool of pre-spawned SAT subprocesses ("warm" processes) for a worker.
+// A pooled process is spawned via the usual dispatcher route, but without any
+// job-specific parameters. It waits on a futex within a small shared memory channel
+// until a job node assigns it the program options of an actual SAT engine,
+// and then proceeds just like a freshly spawned mallob_sat_process.
+// This takes process creation and program loading off the critical path
+// of starting a job node. Each pooled process is used for a single job;
+// the pool is replenished in the background after each assignment.
+class SatProcessPool {
+
+public:
+    // Command line argument which marks a pre-spawned SAT process
+    static constexpr const char* POOLED_ARG = "--pooled";
+
+private:
+    struct Channel {
+        static constexpr size_t ARGS_CAPACITY = 1<<18;
+        enum State {WAITING = 1, ASSIGNED = 2};
+        volatile int state;
+        int argsLength;
+        char args[ARGS_CAPACITY];
+    };
+
+    static Mutex _mtx_pool;
+    static std::list<pid_t> _idle_processes;
+    static const Parameters* _params;
+    static int _target_size;
+    static int _nb_spawning;
+
+public:
+    // [parent] Begin to fill the pool in the background (if enabled). Idempotent.
+    static void init(const Parameters& params);
+    // [parent] Hand the provided program options to an idle pooled process.
+    // Returns the PID of the process, or -1 if no pooled process is ready.
+    static pid_t tryAssign(const Parameters& params);
+
+    // [child] Block until the parent assigned a job to this pooled process,
+    // and then initialize the provided parameters accordingly.
+    // Returns false if the process should exit instead.
+    static bool awaitAssignment(Parameters& params);
+
+private:
+    static void replenish();
+    static std::string getShmemId(pid_t pid) {
+        return "/edu.kit.iti.mallob.satprocpool." + std::to_string(pid);
+    }
+};
@@ -2,11 +2,13 @@
 #pragma once
 
 #include <sys/types.h>
+#include <atomic>
 
 #include "../solvers/portfolio_solver_interface.hpp"
 #include "app/sat/execution/engine.hpp"
 #include "data/checksum.hpp"
 #include "sat_process_config.hpp"
+#include "util/sys/futex.hpp"
 
 struct SatSharedMemory {
 
@@ -16,20 +18,25 @@ struct SatSharedMemory {
     int fSize;
     Checksum chksum;
 
+    // Signals are written with release semantics and read with acquire semantics.
+    // Each signal is accompanied by a notification of the recipient's event,
+    // on which the recipient may sleep until something happens.
+
     // Signals parent->child
-    volatile bool doTerminate {false};
-    volatile bool doCrash {false};
-    //bool pipeChildReadyToWrite {false};
-    //bool pipeDoTerminate {false};
-    //bool pipeDidTerminate {false};
+    std::atomic_bool doTerminate {false};
+    std::atomic_bool doCrash {false};
+    std::atomic_bool doCheckpoint {false}; // write a checkpoint when terminating
+    // notified on each signal and each message written into the pipe
+    FutexEvent childEvent;
 
     // Signals child->parent
-    volatile bool didStart {false};
-    volatile bool didTerminate {false};
+    std::atomic_bool didStart {false};
+    std::atomic_bool didTerminate {false};
     
     // State alerts child->parent
-    volatile bool isInitialized {false};
-    
+    std::atomic_bool isInitialized {false};
+    FutexEvent parentEvent;
+
     // Clause buffers: parent->child
     int importBufferRevision {-1};
     Checksum importChecksum;
@@ -46,4 +53,18 @@ struct SatSharedMemory {
 
     // Pipe data buffer size for each direction
     size_t pipeBufSize {262144};
+
+    static_assert(std::atomic_bool::is_always_lock_free); // required for use across processes
+
+    void signalChild(std::atomic_bool& flag) {
+        flag.store(true, std::memory_order_release);
+        childEvent.notify();
+    }
+    void signalParent(std::atomic_bool& flag) {
+        flag.store(true, std::memory_order_release);
+        parentEvent.notify();
+    }
+    static bool isSignalled(const std::atomic_bool& flag) {
+        return flag.load(std::memory_order_acquire);
+    }
 };
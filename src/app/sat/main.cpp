@@ -14,6 +14,7 @@
 #include "execution/sat_process.hpp"
 #include "util/sys/tmpdir.hpp"
 #include "app/sat/job/sat_process_config.hpp"
+#include "app/sat/job/sat_process_pool.hpp"
 #include "util/option.hpp"
 #include "util/random.hpp"
 
@@ -24,7 +25,10 @@
 int main(int argc, char *argv[]) {
     
     Parameters params;
-    params.init(argc, argv);
+    if (argc == 2 && std::string(argv[1]) == SatProcessPool::POOLED_ARG) {
+        // Pre-spawned process: wait until a job is assigned to this process
+        if (!SatProcessPool::awaitAssignment(params)) return 0;
+    } else params.init(argc, argv);
     SatProcessConfig config(params.satEngineConfig());
 
     timespec t;
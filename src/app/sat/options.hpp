@@ -10,13 +10,18 @@
 OPTION_GROUP(grpAppSat, "app/sat", "SAT solving options")
  OPT_BOOL(abortNonincrementalSubprocess,    "ans", "abort-noninc-subproc",               false,                   
     "Abort (hence restart) each sub-process which works (partially) non-incrementally upon the arrival of a new revision")
+ OPT_INT(satProcessPoolSize,                "spps", "sat-process-pool-size", 0, 0, LARGE_INT, "Keep this many idle SAT subprocesses spawned ahead of time to reduce job start latency (0: disabled)")
+ OPT_BOOL(checkpointSuspendedJobs,          "cpsj", "checkpoint-suspended-jobs", false, "Write a checkpoint of a SAT job node's learned clauses when the suspended node is dropped from a worker; restore it when the node is started again")
+ OPT_STRING(checkpointDirectory,            "cpdir", "checkpoint-dir", "", "Directory for SAT job checkpoints (default: machine-local tmp directory); use a shared file system to restore checkpoints on other machines")
+ OPT_INT(checkpointLitsPerSolver,           "cplps", "checkpoint-lits-per-solver", 1000000, 0, LARGE_INT, "Max. number of literals of recently exported clauses each solver keeps for checkpointing")
+ OPT_BOOL(satNumaPlacement,                 "snp", "sat-numa-placement", false, "Pin SAT solver threads round robin to NUMA nodes and place their import buffers on their node")
  OPT_BOOL(restartSubprocessAtAbort,         "rspaa", "restart-subproc-at-abort", false, "Ignore abort() of a subprocess and just restart it rather than aborting yourself")
  OPT_STRING(satEngineConfig,                "sec", "sat-engine-config",                  "",                      
     "Supply config for SAT engine subprocess [internal option, do not use]")
  OPT_BOOL(copyFormulaeFromSharedMem,        "cpshm", "",                                           false,
     "Copy each formula + assumptions from shared memory to local memory before launching solvers")
  OPT_STRING(clauseLog,                      "clause-log", "",                            "",
-    "Log successfully shared clauses to the provided path")
+    "Log successfully shared clauses to the provided path (binary; convert with clause_log_decoder)")
  OPT_STRING(satProfilingDir,            "spd", "sat-profiling-dir", "", "Directory to write SAT thread profiling reports to")
  OPT_INT(satProfilingLevel,             "spl", "sat-profiling-level", -1, -1, 4, "Profiling level for SAT solvers (-1=none ... 4=all)")
  OPT_BOOL(compressFormula,                  "cf", "compress-formula", false, "Compress formula serialization (reorders clauses and literals in clauses)")
@@ -40,6 +45,16 @@ OPTION_GROUP(grpAppSatSharing, "app/sat/sharing", "Clause sharing configuration"
     "Set clear interval of clauses in solver filters (-1: never clear, 0: always clear")
  OPT_BOOL(collectClauseHistory,           "ch", "collect-clause-history",                false,
     "Employ clause history collection mechanism")
+ OPT_INT(clauseSharingPipelineDepth,       "cspd", "clause-sharing-pipeline-depth",     1,        1,   16,
+    "Max. number of clause sharing epochs in flight: with d>1, an epoch's aggregation may begin while up to d-1 earlier epochs are still being broadcast and digested (forced to 1 with proofs / deterministic solving)")
+ OPT_BOOL(hostLocalClauseAggregation,       "hlca", "host-local-clause-aggregation",     false,
+    "Hand clause buffers to parent job nodes on the same host via shared memory, so that only one node per host-local subtree sends clauses over the network")
+ OPT_INT(clauseHistoryHotSlots,            "chhs", "clause-history-hot-slots",          0,        0,   LARGE_INT,
+    "Max. number of clause history slots kept in RAM with -ch=1; older slots are spilled to -extmem-disk-dir (0: keep all slots in RAM)")
+ OPT_BOOL(adaptiveImportUtility,            "aiu", "adaptive-import-utility",            false,
+    "Scale sharing volume and quality limits (-qcll, -qlbdl) by the globally measured fraction of shared clauses which the solvers keep at import")
+ OPT_FLOAT(minImportUtilityVolumeFactor,    "miuvf", "min-import-utility-volume-factor", 0.25,     0.01, 1,
+    "Lowest factor to which -aiu=1 may scale down the sharing volume")
  OPT_BOOL(compensateUnusedSharingVolume,    "cusv", "compensate-unused-sharing-volume",  true,
     "Compensate for unused or filtered parts of clause buffer in the next sharings")
  OPT_INT(freeClauseLengthLimit, "fcll", "free-clause-length-limit", 1, 0, LARGE_INT, "Max. length of clauses which are considered \"free\" for sharing")
@@ -5,8 +5,10 @@
 #include "app/sat/proof/trusted/trusted_utils.hpp"
 #include "util/logger.hpp"
 #include <cstdint>
+#include <algorithm>
 #include <cstring>
 #include <memory>
+#include <vector>
 
 #define SERIALIZED_FORMULA_PARSER_BASE_CLS_CHKSUM 17
 
@@ -34,6 +36,9 @@ private:
 
     u8 _signature[SIG_SIZE_BYTES];
 
+    // only used for chunk-wise reading of compressed formulae
+    std::vector<int> _chunk_buffer;
+
 public:
     SerializedFormulaParser(Logger& logger, const int* data, size_t size, bool withSignature = false) : 
         _logger(logger), _payload(data), _size(size) {
@@ -84,6 +89,46 @@ public:
         return true; // success
     }
 
+    // Provides the next contiguous chunk of (at most maxChunkSize) clause literals,
+    // including separation zeroes. A chunk may end in the middle of a clause.
+    // Returns false if no clause literals are left.
+    bool getNextLiteralChunk(const int*& chunk, size_t& chunkSize, size_t maxChunkSize) {
+
+        if (_compressed) {
+            _chunk_buffer.resize(maxChunkSize);
+            chunkSize = 0;
+            while (chunkSize < maxChunkSize && _compr_view.getNextLit(_chunk_buffer[chunkSize]))
+                chunkSize++;
+            chunk = _chunk_buffer.data();
+            return chunkSize > 0;
+        }
+
+        if (_pos == _size || _parsing_assumptions) return false;
+
+        chunk = _payload + _pos;
+        const size_t end = std::min(_size, _pos + maxChunkSize);
+        size_t pos = _pos;
+        while (pos < end) {
+            const int lit = _payload[pos];
+            if (_last_lit_zero && lit == INT32_MAX) {
+                _parsing_assumptions = true;
+                break;
+            }
+            _last_lit_zero = lit == 0;
+            if (lit == 0) {
+                _chksum ^= _cls_chksum;
+                _cls_chksum = SERIALIZED_FORMULA_PARSER_BASE_CLS_CHKSUM;
+            } else {
+                _cls_chksum ^= lit;
+            }
+            pos++;
+        }
+        chunkSize = pos - _pos;
+        // skip the assumptions marker, as getNextLiteral does
+        _pos = _parsing_assumptions ? pos+1 : pos;
+        return chunkSize > 0;
+    }
+
     bool getNextAssumption(int& lit) {
 
         if (_compressed) {
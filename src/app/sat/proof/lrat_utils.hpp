@@ -22,6 +22,7 @@ namespace lrat_utils {
         BufferedFileWriter writer;
 
         WriteBuffer(std::ofstream& stream) : writer(stream) {}
+        WriteBuffer(std::vector<unsigned char>& vec) : writer(vec) {}
 
         void writeLineHeader() {
             writer.put('a');
@@ -3,8 +3,7 @@
 
 #include "app/sat/proof/lrat_line.hpp"
 #include "util/bloom_filter.hpp"
-#include "util/tsl/robin_map.h"
-#include "util/tsl/robin_set.h"
+#include "util/roaring_id_set.hpp"
 #include <memory>
 class ClauseIdFilter {
 
@@ -14,7 +13,9 @@ public:
 private:
     Mode _mode;
     std::unique_ptr<BloomFilter<LratClauseId>> _bloom_filter;
-    std::unique_ptr<tsl::robin_set<LratClauseId>> _exact_filter;
+    // LRAT IDs mostly come in dense ranges, so a compressed exact set
+    // tends to be much smaller than a hash set or even the Bloom filter
+    std::unique_ptr<RoaringIdSet> _exact_filter;
 
 public:
     ClauseIdFilter(Mode mode) : _mode(mode) {
@@ -23,7 +24,7 @@ public:
             _bloom_filter.reset(new BloomFilter<LratClauseId>(268435399, 4));
         }
         if (_mode == EXACT) {
-            _exact_filter.reset(new tsl::robin_set<LratClauseId>());
+            _exact_filter.reset(new RoaringIdSet());
         }
     }
 
@@ -32,10 +33,7 @@ public:
             return _bloom_filter->tryInsert(id);
         }
         if (_mode == EXACT) {
-            auto it = _exact_filter->find(id);
-            if (it != _exact_filter->end()) return false;
-            _exact_filter->insert(it, id);
-            return true;            
+            return _exact_filter->insert(id);
         }
         return false;
     }
@@ -21,6 +21,7 @@
 #include "app/sat/proof/lrat_utils.hpp"
 #include "app/sat/proof/reverse_binary_lrat_parser.hpp"
 #include "util/sys/buffered_io.hpp"
+#include "util/block_reversed_file_reader.hpp"
 #include "merge_message.hpp"
 #include "merge_child.hpp"
 #include "proof_writer.hpp"
@@ -61,6 +62,7 @@ private:
     // rank zero only
     std::string _output_filename;
     std::unique_ptr<ProofWriter> _proof_writer;
+    std::vector<size_t> _output_block_sizes;
     std::unique_ptr<ClauseIdFilter> _output_id_filter;
     std::future<void> _fut_root_prepare;
     bool _root_prepared = false;
@@ -98,7 +100,8 @@ public:
                 _output_filename = outputFileAtZero;
                 std::string reverseFilename = _output_filename + ".inv";
                 LOGGER(_log, V3_VERB, "Opening output file \"%s\"\n", reverseFilename.c_str());
-                _proof_writer.reset(new ProofWriter(reverseFilename, _binary_output));
+                // If the proof is uninverted afterwards, already write each block in forward order
+                _proof_writer.reset(new ProofWriter(reverseFilename, _binary_output, _params.uninvertProof()));
                 if (_params.addClauseDeletionStatements() > 0) {
                     _output_id_filter.reset(new ClauseIdFilter(
                         _params.addClauseDeletionStatements() == 1 ?
@@ -417,6 +420,7 @@ private:
         if (_is_root) {
             _proof_writer->markExhausted();
             while (!_proof_writer->isDone()) usleep(1000*10);
+            _output_block_sizes = _proof_writer->getBlockSizes();
             _proof_writer.reset(); // internally waits for writer to finish
         }
     }
@@ -439,49 +443,44 @@ private:
             return;
         }
 
-        if (_binary_output) {
-            // Read binary file in reverse order byte by byte, output lines into new file
-            std::ofstream ofs(_output_filename, std::ofstream::binary);
-            ReverseFileReader reader(inputFilename);
-
-            if (_params.compactProof() > 0) {
-                // Bring all LRAT IDs into a compact shape
-                // (may help efficiency of checking / prevents bugs in lrat-check)
-                LratCompactifier compactifier(_num_original_clauses, _params.compactProof() == 2);
-                lrat_utils::ReadBuffer readbuf(reader);
-                lrat_utils::WriteBuffer out(ofs);
-                SerializedLratLine line;
-                while (lrat_utils::readLine(readbuf, line)) {
-                    if (line.isDeletionStatement()) {
-                        // deletion
-                        auto [hints, nbHints] = line.getHints();
-                        int newNbHints = nbHints;
-                        if (!compactifier.handleClauseDeletion(newNbHints, hints))
-                            continue;
-                        lrat_utils::writeDeletionLine(out, 1, hints, nbHints, lrat_utils::NORMAL);
-                    } else {
-                        // addition
-                        if (!compactifier.handleClauseAddition(line))
-                            continue;
-                        lrat_utils::writeLine(out, line, lrat_utils::NORMAL);
-                    }
+        // The blocks of the written file each contain their lines in forward order,
+        // so the blocks only need to be concatenated in reverse order.
+        std::ofstream ofs(_output_filename, std::ofstream::binary);
+        BlockReversedFileReader reader(inputFilename, _output_block_sizes);
+
+        if (_binary_output && _params.compactProof() > 0) {
+            // Bring all LRAT IDs into a compact shape
+            // (may help efficiency of checking / prevents bugs in lrat-check)
+            LratCompactifier compactifier(_num_original_clauses, _params.compactProof() == 2);
+            lrat_utils::ReadBuffer readbuf(reader);
+            lrat_utils::WriteBuffer out(ofs);
+            SerializedLratLine line;
+            while (lrat_utils::readLine(readbuf, line)) {
+                if (line.isDeletionStatement()) {
+                    // deletion
+                    auto [hints, nbHints] = line.getHints();
+                    int newNbHints = nbHints;
+                    if (!compactifier.handleClauseDeletion(newNbHints, hints))
+                        continue;
+                    lrat_utils::writeDeletionLine(out, 1, hints, nbHints, lrat_utils::NORMAL);
+                } else {
+                    // addition
+                    if (!compactifier.handleClauseAddition(line))
+                        continue;
+                    lrat_utils::writeLine(out, line, lrat_utils::NORMAL);
                 }
-            } else {
-                // Just reverse the file byte by byte without interpreting anything
-                BufferedFileWriter writer(ofs);
-                char c;
-                while (reader.next(c)) {
-                    writer.put(c);
-                }
-                writer.flush();
             }
-            ofs.close();
         } else {
-            // Just "tac" the text file
-            std::string cmd = "tac " + inputFilename + " > " + _output_filename;
-            int result = system(cmd.c_str());
-            assert(result == 0);
+            // Just copy the blocks without interpreting anything
+            const char* block;
+            size_t blockSize;
+            while (reader.nextBlock(block, blockSize)) {
+                ofs.write(block, blockSize);
+            }
         }
+        ofs.close();
+        assert(reader.valid());
+
         // remove original (reversed) file
         int result = FileUtils::rm(inputFilename);
         assert(result == 0);
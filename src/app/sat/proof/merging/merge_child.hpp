@@ -42,6 +42,9 @@ public:
     size_t getCurrentSize() const override {
         return getNumLinesInBuffer();
     }
+    void markTerminated() override {
+        buffer.markTerminated();
+    }
 
     void conclude() {buffer.markExhausted();}
     void setRefillRequested(bool requested) {refillRequested = requested;}
@@ -1,10 +1,19 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "../lrat_utils.hpp"
 #include "util/spsc_blocking_ringbuffer.hpp"
 #include "util/sys/background_worker.hpp"
 
+// Writes the lines of an inverted proof (i.e., in reverse order) to a file.
+// Lines are passed to the writer thread in batches and are written in blocks
+// of roughly BLOCK_SIZE_BYTES. The concatenation of all blocks is the fully
+// inverted proof, as is required for reading it backwards. If reverseBlocks
+// is set, each block is instead reversed in memory before writing it, so that
+// it contains its lines in forward order and the forward proof is obtained
+// by concatenating the blocks in reverse order (see getBlockSizes()).
 class ProofWriter {
 
 public:
@@ -15,34 +24,42 @@ public:
         LratOutputLine(Type type, std::vector<uint8_t>&& data) : type(type), data(std::move(data)) {}
     };
 
+    static constexpr size_t LINES_PER_BATCH = 1024;
+    static constexpr size_t BLOCK_SIZE_BYTES = 1<<22;
+
 private:
     const std::string _filename;
     const bool _binary;
+    const bool _reverse_blocks;
     std::ofstream _ofs;
-    SPSCBlockingRingbuffer<LratOutputLine> _buffer;
+    std::vector<LratOutputLine> _batch;
+    SPSCBlockingRingbuffer<std::vector<LratOutputLine>> _buffer;
     BackgroundWorker _worker;
 
+    std::vector<size_t> _block_sizes;
+
     unsigned long _num_pushed_lines {0};
     unsigned long _num_written_lines {0};
-    bool _done {false};
+    volatile bool _done {false};
 
 public:
-    ProofWriter(const std::string& filename, bool binary) : _filename(filename), _binary(binary),
+    ProofWriter(const std::string& filename, bool binary, bool reverseBlocks = false) :
+        _filename(filename), _binary(binary), _reverse_blocks(reverseBlocks),
         _ofs([&](){
             if (_binary) {
                 return std::ofstream(_filename, std::ios::binary);
             } else {
                 return std::ofstream(_filename);
             }
-        }()), _buffer(131072) {
+        }()), _buffer(128) {
         
         runWriter();
     } 
 
     void pushAdditionBlocking(SerializedLratLine& line) {
-        LratOutputLine out(LratOutputLine::ADD, std::move(line.data()));
-        _buffer.pushBlocking(out);
+        _batch.emplace_back(LratOutputLine::ADD, std::move(line.data()));
         _num_pushed_lines++;
+        if (_batch.size() == LINES_PER_BATCH) pushBatchBlocking();
     }
 
     void pushDeletionBlocking(LratClauseId id, const std::vector<LratClauseId>& hintsToDelete) {
@@ -52,12 +69,13 @@ public:
         for (size_t i = 0; i < hintsToDelete.size(); i++) {
             memcpy(data.data()+(i+1)*sizeof(LratClauseId), hintsToDelete.data()+i, sizeof(LratClauseId));
         }
-        LratOutputLine out(LratOutputLine::DELETE, std::move(data));
-        _buffer.pushBlocking(out);
+        _batch.emplace_back(LratOutputLine::DELETE, std::move(data));
         _num_pushed_lines++;
+        if (_batch.size() == LINES_PER_BATCH) pushBatchBlocking();
     }
 
     void markExhausted() {
+        if (!_batch.empty()) pushBatchBlocking();
         LOG(V2_INFO, "Proof writer received full proof (%lu lines)\n", _num_pushed_lines);
         _buffer.markExhausted();
     }
@@ -66,63 +84,96 @@ public:
         return _done;
     }
 
+    // Sizes of the written blocks in file order (only valid if isDone())
+    const std::vector<size_t>& getBlockSizes() const {
+        return _block_sizes;
+    }
+
     void reportProgress() {
         LOG(V2_INFO, "Proof output: got %ld, wrote %ld lines\n", 
             _num_pushed_lines, _num_written_lines);
     }
 
     ~ProofWriter() {
+        // If the proof is incomplete, the writer may still wait for input
+        if (!_buffer.exhausted()) _buffer.markTerminated();
         _worker.stop();
-        LOG(V2_INFO, "Proof writer wrote %lu/%lu lines\n", _num_written_lines, _num_pushed_lines);
+        LOG(V2_INFO, "Proof writer wrote %lu/%lu lines in %lu blocks\n", _num_written_lines,
+            _num_pushed_lines, _block_sizes.size());
     }
 
 private:
+    void pushBatchBlocking() {
+        _buffer.pushBlocking(_batch);
+        _batch.clear(); // swapped with an already written batch
+    }
+
     void runWriter() {
         _worker.run([&]() {
 
-            LratOutputLine line;
+            std::vector<LratOutputLine> batch;
+            std::vector<unsigned char> block;
             SerializedLratLine sline;
             {
-                lrat_utils::WriteBuffer out(_ofs);
+                lrat_utils::WriteBuffer out(block);
 
-                while (_worker.continueRunning() && _buffer.pollBlocking(line)) {
-                    
-                    if (line.type == LratOutputLine::ADD) {
-                        // write ADD line
+                while (_worker.continueRunning() && _buffer.pollBlocking(batch)) {
 
-                        sline.data().swap(line.data);
-                        if (_binary) {
-                            lrat_utils::writeLine(out, sline, lrat_utils::REVERSED);
-                        } else {
-                            std::string output = sline.toStr();
-                            _ofs.write(output.c_str(), output.size());
-                        }
+                    for (auto& line : batch) {
+                        if (line.type == LratOutputLine::ADD) {
+                            // write ADD line
 
-                    } else {
-                        // write DELETE line
+                            sline.data().swap(line.data);
+                            if (_binary) {
+                                lrat_utils::writeLine(out, sline, lrat_utils::REVERSED);
+                            } else {
+                                appendTextLine(block, sline.toStr());
+                            }
 
-                        LratClauseId id = *((LratClauseId*) line.data.data());
-                        LratClauseId* hints = (LratClauseId*) (line.data.data() + sizeof(LratClauseId));
-                        int numHints = (line.data.size() / sizeof(LratClauseId)) - 1;
-
-                        if (_binary) {
-                            lrat_utils::writeDeletionLine(out, id, hints, numHints, lrat_utils::REVERSED);
                         } else {
-                            std::string delLine = std::to_string(id) + " d";
-                            for (int i = 0; i < numHints; i++) {
-                                delLine += " " + std::to_string(hints[i]);
-                            } 
-                            delLine += " 0\n";
-                            _ofs.write(delLine.c_str(), delLine.size());
+                            // write DELETE line
+
+                            LratClauseId id = *((LratClauseId*) line.data.data());
+                            LratClauseId* hints = (LratClauseId*) (line.data.data() + sizeof(LratClauseId));
+                            int numHints = (line.data.size() / sizeof(LratClauseId)) - 1;
+
+                            if (_binary) {
+                                lrat_utils::writeDeletionLine(out, id, hints, numHints, lrat_utils::REVERSED);
+                            } else {
+                                std::string delLine = std::to_string(id) + " d";
+                                for (int i = 0; i < numHints; i++) {
+                                    delLine += " " + std::to_string(hints[i]);
+                                } 
+                                delLine += " 0\n";
+                                appendTextLine(block, delLine);
+                            }
                         }
+                        _num_written_lines++;
                     }
 
-                    _num_written_lines++;
+                    out.writer.flush();
+                    if (block.size() >= BLOCK_SIZE_BYTES) writeBlock(block);
                 }
+                out.writer.flush();
             }
+            if (!block.empty()) writeBlock(block);
 
             _ofs.flush();
             _done = true;
         });
     }
+
+    void appendTextLine(std::vector<unsigned char>& block, const std::string& line) {
+        // Text lines are output in forward order in any case,
+        // so reverse them if the entire block will be reversed
+        if (_reverse_blocks) block.insert(block.end(), line.rbegin(), line.rend());
+        else block.insert(block.end(), line.begin(), line.end());
+    }
+
+    void writeBlock(std::vector<unsigned char>& block) {
+        if (_reverse_blocks) std::reverse(block.begin(), block.end());
+        _ofs.write((const char*) block.data(), block.size());
+        _block_sizes.push_back(block.size());
+        block.clear();
+    }
 };
@@ -4,7 +4,7 @@
 #include "proof_assembler.hpp"
 #include "merging/distributed_proof_merger.hpp"
 #include "merging/proof_merge_connector.hpp"
-#include "util/small_merger.hpp"
+#include "util/threaded_merge_tree.hpp"
 #include "comm/job_tree_basic_all_reduction.hpp"
 #include "app/sat/proof/merging/proof_merge_file_input.hpp"
 #include "comm/msg_queue/message_subscription.hpp"
@@ -38,7 +38,7 @@ private:
 
     std::unique_ptr<DistributedProofMerger> _file_merger;
     std::vector<std::unique_ptr<MergeSourceInterface<SerializedLratLine>>> _local_merge_inputs;
-    std::unique_ptr<SmallMerger<SerializedLratLine>> _local_merger;
+    std::unique_ptr<ThreadedMergeTree<SerializedLratLine>> _local_merger;
     std::vector<ProofMergeConnector*> _merge_connectors;
 
     float _reconstruction_time = 0;
@@ -156,10 +156,11 @@ private:
             }
         }
 
-        // Set up local merger: Merges together all local proof parts
+        // Set up local merger: Merges together all local proof parts,
+        // with groups of local parts being merged concurrently
         std::vector<MergeSourceInterface<SerializedLratLine>*> ptrs;
         for (auto& source : _local_merge_inputs) ptrs.push_back(source.get());
-        _local_merger.reset(new SmallMerger<SerializedLratLine>(ptrs));
+        _local_merger.reset(new ThreadedMergeTree<SerializedLratLine>(ptrs, /*fanIn=*/8, /*bufferSize=*/32768));
 
         // Set up distributed merge procedure
         _file_merger.reset(new DistributedProofMerger(_params, MPI_COMM_WORLD, /*branchingFactor=*/6, 
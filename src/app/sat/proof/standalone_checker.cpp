@@ -2,6 +2,7 @@
 #include <sys/prctl.h>
 #include <stdlib.h>
 #include <algorithm>
+#include <cstring>
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -47,6 +48,7 @@ int main(int argc, char** argv) {
     const char* proofInput = nullptr;
     enum ProofReadMode {NORMAL, REVERSED} proofReadMode = NORMAL;
     bool deduplicate {false};
+    unsigned long idStride {1}; // stride of the clause IDs of each solver (e.g., #solvers)
 
     for (int i = 1; i < argc; i++) {
         if (TrustedUtils::beginsWith(argv[i], "-reversed")
@@ -55,6 +57,9 @@ int main(int argc, char** argv) {
         else if (TrustedUtils::beginsWith(argv[i], "-deduplicate")
         || TrustedUtils::beginsWith(argv[i], "--deduplicate"))
             deduplicate = true;
+        else if (TrustedUtils::beginsWith(argv[i], "-id-stride=")
+        || TrustedUtils::beginsWith(argv[i], "--id-stride="))
+            idStride = std::max(1L, atol(strchr(argv[i], '=')+1));
         else if (!cnfInput) cnfInput = argv[i];
         else if (!proofInput) proofInput = argv[i];
         else {
@@ -62,7 +67,7 @@ int main(int argc, char** argv) {
         }
     }
     if (!cnfInput || !proofInput) {
-        LOG(V0_CRIT, "Usage: %s <cnf-file> <proof-file> [--reversed] [--deduplicate]\n", argv[0]);
+        LOG(V0_CRIT, "Usage: %s <cnf-file> <proof-file> [--reversed] [--deduplicate] [--id-stride=<n>]\n", argv[0]);
         exitUnverified();
     }
 
@@ -81,7 +86,7 @@ int main(int argc, char** argv) {
         cnfInput, reader.getNbVars(), reader.getNbClauses(), time);
 
     time = Timer::elapsedSeconds();
-    LratChecker chk(reader.getNbVars(), nullptr);
+    LratChecker chk(reader.getNbVars(), nullptr, idStride);
     ok = chk.loadOriginalClauses(desc->getFormulaPayload(0), desc->getFormulaPayloadSize(0));
     if (!ok) {
         LOG(V0_CRIT, "[ERROR] problem while loading CNF to LRAT checker! %s\n", chk.getErrorMessage());
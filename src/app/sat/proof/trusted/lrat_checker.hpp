@@ -3,43 +3,13 @@
 
 #include "siphash/siphash.hpp"
 #include "trusted_utils.hpp"
-#include "robin_map.h"
+#include "lrat_clause_table.hpp"
 
 class LratChecker {
 
 private:
-    // We represent each clause as a raw, owned, zero-terminated pointer to the literals.
-    // This minimizes the memory used by "empty" elements in the large hash table.
-    struct CompactClause {
-        int* data {nullptr};
-        CompactClause(const int* data, int nbLits) {
-            this->data = (int*) malloc((nbLits+1) * sizeof(int));
-            for (int i = 0; i < nbLits; i++) this->data[i] = data[i];
-            this->data[nbLits] = 0;
-        }
-        CompactClause(CompactClause&& moved) : data(moved.data) {
-            moved.data = nullptr;
-        }
-        CompactClause& operator=(CompactClause&& moved) {
-            data = moved.data;
-            moved.data = nullptr;
-            return *this;
-        }
-        ~CompactClause() {
-            if (data) free(data);
-        }
-    };
-
-    // Simple and fast hash function for clause IDs.
-    struct ClauseIdHasher {
-        std::size_t operator()(const u64& val) const {
-            return (0xcbf29ce484222325UL ^ val) * 0x00000100000001B3UL;
-        }
-    };
-
-    // The hash table where we keep all clauses and which uses most of our RAM.
-    // We still use a power-of-two growth policy since this makes lookups faster.
-    tsl::robin_map<u64, CompactClause, ClauseIdHasher> _clauses;
+    // The table where we keep all clauses and which uses most of our RAM.
+    LratClauseTable _clauses;
 
     std::vector<int8_t> _var_values;
     char _errmsg[512] = {0};
@@ -52,9 +22,8 @@ private:
     SipHash _siphash_builder;
 
 public:
-    LratChecker(int nbVars, const u8* sigKey128bit = nullptr) :
-        _clauses(1<<16),
-        _var_values(nbVars+1, 0), _siphash_builder(sigKey128bit) {}
+    LratChecker(int nbVars, const u8* sigKey128bit = nullptr, u64 idStride = 1) :
+        _clauses(idStride), _var_values(nbVars+1, 0), _siphash_builder(sigKey128bit) {}
 
     inline bool loadLiteral(int lit) {
         if (lit == 0) {
@@ -99,7 +68,7 @@ public:
     }
 
     inline bool addAxiomaticClause(u64 id, const int* lits, int nbLits) {
-        auto [it, ok] = _clauses.insert({id, CompactClause{lits, nbLits}});
+        bool ok = _clauses.insert(id, lits, nbLits);
         if (!ok) snprintf(_errmsg, 512, "Insertion of clause %lu unsuccessful - already present?", id);
         else if (nbLits == 0) _unsat_proven = true; // added top-level empty clause!
         return ok;
@@ -114,12 +83,10 @@ public:
         for (int i = 0; i < nbIds; i++) {
             auto id = ids[i];
             if (id == 0) continue;
-            auto it = _clauses.find(id);
-            if (it == _clauses.end()) {
+            if (!_clauses.erase(id)) {
                 snprintf(_errmsg, 512, "Clause deletion: ID %lu not found", id);
                 return false;
             }
-            _clauses.erase(it);
         }
         return true;
     }
@@ -158,19 +125,17 @@ private:
 
             // Find the clause for this hint
             auto hintId = hints[i];
-            auto hintClsIt = _clauses.find(hintId);
-            if (MALLOB_UNLIKELY(hintClsIt == _clauses.end())) {
+            const int* hintCls = _clauses.find(hintId);
+            if (MALLOB_UNLIKELY(!hintCls)) {
                 // ERROR - hint not found
                 snprintf(_errmsg, 512, "Derivation %lu: hint %lu not found", baseId, hintId);
                 ok = false; break;
             }
 
             // Interpret hint clause (should derive a new unit clause)
-            const auto& hintCls = hintClsIt->second;
-            TrustedUtils::doAssert(hintCls.data);
             int newUnit = 0;
             for (int litIdx = 0; ; litIdx++) { // for each literal ...
-                int lit = hintCls.data[litIdx];
+                int lit = hintCls[litIdx];
                 if (lit == 0) break;           // ... until termination zero
                 int var = abs(lit);
                 if (_var_values[var] == 0) {
@@ -0,0 +1,180 @@
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "trusted_utils.hpp"
+#include "robin_map.h"
+
+// Stores the live clauses of an LRAT checker by their IDs. LRAT proofs mostly
+// use consecutive, increasing IDs, so instead of hashing each ID we divide the
+// ID space into pages of PAGE_SIZE consecutive IDs. Each page holds a direct-mapped
+// array of 32-bit positions and an arena with the zero-terminated literals of
+// the page's clauses. This avoids one allocation per clause, keeps clauses with
+// nearby IDs close together in memory, and requires only a small hash table
+// for the pages actually in use. A page's arena is compacted as soon as most of
+// its literals belong to deleted clauses (and at least PAGE_SIZE of them, which
+// amortizes the cost of scanning the page), and an empty page is released.
+// The positions array of a page takes 4 KiB regardless of how many of its IDs are
+// used. If clause IDs are assigned with a fixed stride (e.g., one residue class per
+// solver in a distributed proof), only every stride-th entry of a page would be used;
+// given the stride, each residue class is therefore mapped to pages of its own, at
+// the cost of a division per access.
+class LratClauseTable {
+
+private:
+    static constexpr int PAGE_BITS = 10;
+    static constexpr u64 PAGE_SIZE = 1UL << PAGE_BITS;
+
+    struct Page {
+        u32 positions[PAGE_SIZE] {0}; // 1 + start of each clause in lits (0: no clause)
+        std::vector<int> lits;
+        u32 nbLive {0};
+        size_t nbDeadLits {0};
+        bool shrunk {false};
+    };
+
+    struct PageIdHasher {
+        std::size_t operator()(const u64& val) const {
+            return (0xcbf29ce484222325UL ^ val) * 0x00000100000001B3UL;
+        }
+    };
+    tsl::robin_map<u64, std::unique_ptr<Page>, PageIdHasher> _pages;
+
+    // Cache for the most recently accessed page (hints mostly refer to nearby IDs)
+    mutable u64 _cached_page_id {(u64) -1};
+    mutable Page* _cached_page {nullptr};
+    // Page to which a clause was most recently inserted
+    u64 _insert_page_id {(u64) -1};
+
+    size_t _size {0};
+    const u64 _id_stride;
+
+public:
+    LratClauseTable(u64 idStride = 1) : _pages(1<<10), _id_stride(std::max(1UL, idStride)) {}
+
+    // Returns false iff a clause with this ID is already present.
+    bool insert(u64 id, const int* lits, int nbLits) {
+        u64 pageId, slot;
+        locate(id, pageId, slot);
+        Page* page = getPage(pageId);
+        if (!page) {
+            page = new Page();
+            _pages[pageId].reset(page);
+            _cached_page_id = pageId;
+            _cached_page = page;
+        }
+        u32& pos = page->positions[slot];
+        if (pos != 0) return false;
+
+        if (pageId != _insert_page_id) {
+            // With increasing IDs, the page we inserted to before will (mostly)
+            // not grow any further: release its spare capacity (once)
+            const u64 prevPageId = _insert_page_id;
+            Page* prevPage = pageId > prevPageId ? getPage(prevPageId) : nullptr;
+            _insert_page_id = pageId;
+            if (prevPage && prevPage->nbLive == 0) {
+                releasePage(prevPageId, prevPage);
+            } else if (prevPage && !prevPage->shrunk) {
+                prevPage->lits.shrink_to_fit();
+                prevPage->shrunk = true;
+            }
+        }
+
+        TrustedUtils::doAssert(page->lits.size() + nbLits + 1 < (size_t) UINT32_MAX);
+        pos = 1 + page->lits.size();
+        page->lits.insert(page->lits.end(), lits, lits+nbLits);
+        page->lits.push_back(0);
+        page->nbLive++;
+        _size++;
+        return true;
+    }
+
+    // Returns the zero-terminated literals of the clause with this ID,
+    // or nullptr if no such clause is present.
+    inline const int* find(u64 id) const {
+        u64 pageId, slot;
+        locate(id, pageId, slot);
+        const Page* page = getPage(pageId);
+        if (MALLOB_UNLIKELY(!page)) return nullptr;
+        const u32 pos = page->positions[slot];
+        if (MALLOB_UNLIKELY(pos == 0)) return nullptr;
+        return page->lits.data() + (pos-1);
+    }
+
+    // Returns false iff no clause with this ID is present.
+    bool erase(u64 id) {
+        u64 pageId, slot;
+        locate(id, pageId, slot);
+        Page* page = getPage(pageId);
+        if (!page) return false;
+        u32& pos = page->positions[slot];
+        if (pos == 0) return false;
+
+        size_t nbLits = 0;
+        while (page->lits[pos-1+nbLits] != 0) nbLits++;
+        page->nbDeadLits += nbLits+1;
+        pos = 0;
+        page->nbLive--;
+        _size--;
+
+        if (page->nbLive == 0 && pageId != _insert_page_id) {
+            // Release the entire page (unless clauses are currently being added to it)
+            releasePage(pageId, page);
+        } else if (page->nbDeadLits > page->lits.size() / 2 && page->nbDeadLits >= PAGE_SIZE) {
+            compact(*page);
+        }
+        return true;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+private:
+    inline void locate(u64 id, u64& pageId, u64& slot) const {
+        if (MALLOB_LIKELY(_id_stride == 1)) {
+            pageId = id >> PAGE_BITS;
+            slot = id & (PAGE_SIZE-1);
+            return;
+        }
+        // id = q * stride + r: pages of consecutive q within each residue class r
+        const u64 q = id / _id_stride;
+        const u64 r = id - q * _id_stride;
+        pageId = (q >> PAGE_BITS) * _id_stride + r;
+        slot = q & (PAGE_SIZE-1);
+    }
+
+    inline Page* getPage(u64 pageId) const {
+        if (MALLOB_LIKELY(pageId == _cached_page_id)) return _cached_page;
+        auto it = _pages.find(pageId);
+        if (it == _pages.end()) return nullptr;
+        _cached_page_id = pageId;
+        _cached_page = it->second.get();
+        return _cached_page;
+    }
+
+    void releasePage(u64 pageId, Page* page) {
+        if (_cached_page == page) {
+            _cached_page_id = (u64) -1;
+            _cached_page = nullptr;
+        }
+        _pages.erase(pageId);
+    }
+
+    void compact(Page& page) {
+        std::vector<int> lits;
+        lits.reserve(page.lits.size() - page.nbDeadLits);
+        for (u64 i = 0; i < PAGE_SIZE; i++) {
+            u32& pos = page.positions[i];
+            if (pos == 0) continue;
+            const int* cls = page.lits.data() + (pos-1);
+            pos = 1 + lits.size();
+            do lits.push_back(*cls); while (*cls++ != 0);
+        }
+        page.lits.swap(lits);
+        page.nbDeadLits = 0;
+    }
+};
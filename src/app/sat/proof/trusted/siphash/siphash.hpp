@@ -68,7 +68,6 @@ private:
     u64 v3;
     u64 k0;
     u64 k1;
-    u64 m;
     int i;
     size_t inlen;
 
@@ -105,17 +104,27 @@ public:
     }
 
     SipHash& update(const unsigned char* data, size_t nbBytes) {
-        int datapos {0};
-        while (true) {
+        size_t datapos {0};
+        // Complete a partially filled block first
+        if (buflen > 0) {
             while (buflen < 8 && datapos < nbBytes) {
                 buf[buflen++] = data[datapos++];
             }
             if (buflen < 8) {
-                break;
-            } else {
-                processNextBlock();
-                buflen = 0;
+                inlen += nbBytes;
+                return *this;
             }
+            processBlock(U8TO64_LE(buf));
+            buflen = 0;
+        }
+        // Process all full blocks directly from the input
+        while (datapos + 8 <= nbBytes) {
+            processBlock(U8TO64_LE(data + datapos));
+            datapos += 8;
+        }
+        // Keep the remaining bytes for later
+        while (datapos < nbBytes) {
+            buf[buflen++] = data[datapos++];
         }
         inlen += nbBytes;
         return *this;
@@ -127,10 +136,9 @@ public:
     }
 
 private:
-    void processNextBlock() {
-        m = U8TO64_LE(buf);
+    inline void processBlock(u64 m) {
         v3 ^= m;
-        for (i = 0; i < cROUNDS; ++i)
+        for (int r = 0; r < cROUNDS; ++r)
             SIPROUND;
         v0 ^= m;
     }
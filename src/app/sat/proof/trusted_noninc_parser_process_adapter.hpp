@@ -2,6 +2,7 @@
 #pragma once
 
 #include <cstdlib>
+#include <fcntl.h>
 #include <string>
 #include <sys/stat.h>
 
@@ -53,6 +54,8 @@ public:
         _child_pid = _subproc->start();
 
         _f_parsed_formula = fopen(pathParsedFormula.c_str(), "r");
+        // A larger pipe lets the parser sign ahead while we copy out the data
+        fcntl(fileno(_f_parsed_formula), F_SETPIPE_SZ, 1<<20);
 
         // Parse # vars and # clauses
         ImpCheckIO io;
@@ -65,7 +68,7 @@ public:
         out.resize(out.size() + (_nb_cls*2*sizeof(int))/sizeof(T));
         size_t capacityBytes = out.size() * sizeof(T);
         const size_t outSizeBytesBefore = fSizeBytes;
-        const size_t maxBytesToRead = 1<<14;
+        const size_t maxBytesToRead = 1<<20;
         while (true) {
             if (fSizeBytes + maxBytesToRead > capacityBytes) {
                 capacityBytes = std::max((unsigned long) (1.25*capacityBytes), fSizeBytes+maxBytesToRead);
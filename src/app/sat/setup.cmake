@@ -6,7 +6,8 @@ set(SAT_SUBPROC_SOURCES src/app/sat/execution/engine.cpp src/app/sat/execution/s
     src/app/sat/execution/solving_state.cpp src/app/sat/sharing/buffer/buffer_merger.cpp 
     src/app/sat/sharing/buffer/buffer_reader.cpp src/app/sat/sharing/filter/clause_buffer_lbd_scrambler.cpp 
     src/app/sat/sharing/sharing_manager.cpp src/app/sat/solvers/portfolio_solver_interface.cpp 
-    src/app/sat/data/clause_metadata.cpp src/app/sat/proof/lrat_utils.cpp src/app/sat/solvers/solver_portfolio_config.cpp CACHE INTERNAL "")
+    src/app/sat/data/clause_metadata.cpp src/app/sat/proof/lrat_utils.cpp src/app/sat/solvers/solver_portfolio_config.cpp
+    src/app/sat/job/sat_process_pool.cpp CACHE INTERNAL "")
 
 # Add SAT-specific sources to main Mallob executable
 set(SAT_MALLOB_SOURCES src/app/sat/proof/incremental_trusted_parser_store.cpp src/app/sat/data/formula_compressor.cpp
@@ -15,7 +16,8 @@ set(SAT_MALLOB_SOURCES src/app/sat/proof/incremental_trusted_parser_store.cpp sr
     src/app/sat/job/sat_process_adapter.cpp src/app/sat/job/historic_clause_storage.cpp
     src/app/sat/sharing/buffer/buffer_merger.cpp src/app/sat/sharing/buffer/buffer_reader.cpp
     src/app/sat/sharing/filter/clause_buffer_lbd_scrambler.cpp src/app/sat/data/clause_metadata.cpp
-    src/app/sat/proof/lrat_utils.cpp src/app/sat/solvers/solver_portfolio_config.cpp)
+    src/app/sat/proof/lrat_utils.cpp src/app/sat/solvers/solver_portfolio_config.cpp
+    src/app/sat/job/sat_process_pool.cpp)
 set(MALLOB_COREPLUSCOMM_SOURCES ${MALLOB_COREPLUSCOMM_SOURCES} ${SAT_MALLOB_SOURCES} CACHE INTERNAL "")
 
 #message("commons+SAT sources: ${BASE_SOURCES}") # Use to debug
@@ -89,6 +91,12 @@ if(NOT MALLOB_BUILD_CHECKER EQUAL 0)
     target_link_libraries(standalone_lrat_checker mallob_corepluscomm)
 endif()
 
+# Executable converting binary clause logs to text
+add_executable(clause_log_decoder src/app/sat/sharing/clause_log_decoder.cpp)
+target_include_directories(clause_log_decoder PRIVATE ${BASE_INCLUDES})
+target_compile_options(clause_log_decoder PRIVATE ${BASE_COMPILEFLAGS})
+target_link_libraries(clause_log_decoder z)
+
 
 # Add unit tests
 new_test(hashing "${BASE_INCLUDES}" mallob_sat_subproc)
@@ -100,12 +108,18 @@ new_test(serialized_formula_parser "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(lrat_utils "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(priority_clause_buffer "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(clause_store_iteration "${BASE_INCLUDES}" mallob_sat_subproc)
-new_test(lrat_checker "${BASE_INCLUDES}" mallob_sat_subproc)
+new_test(lrat_checker "${BASE_INCLUDES}" mallob_corepluscomm)
 new_test(portfolio_sequence "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(theory_specification "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(model_string_compressor "${BASE_INCLUDES}" mallob_sat_subproc)
+new_test(clause_logger "${BASE_INCLUDES}" mallob_sat_subproc)
+new_test(historic_clause_storage "${BASE_INCLUDES}" mallob_corepluscomm)
+new_test(sat_checkpoint "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(sat_reader "${BASE_INCLUDES}" mallob_corepluscomm)
 new_test(job_description "${BASE_INCLUDES}" mallob_corepluscomm)
 new_test(distributed_file_merger "${BASE_INCLUDES}" mallob_corepluscomm)
+new_test(proof_writer "${BASE_INCLUDES}" mallob_sat_subproc)
 new_test(formula_compressor "${BASE_INCLUDES}" mallob_corepluscomm)
 new_test(solver_portfolio_config "${BASE_INCLUDES}" mallob_sat_subproc)
+new_test(clause_sharing_pipeline "${BASE_INCLUDES}" mallob_sat_subproc)
+new_test(host_local_clause_buffer "${BASE_INCLUDES}" mallob_corepluscomm)
@@ -45,7 +45,8 @@ public:
         *((size_t*) _out->data()) = 1;
         _counter_position = _out->size();
         _out->push_back(0); // counter for the first group
-        if (totalLiteralLimit > 0) _out->reserve(totalLiteralLimit);
+        // no up-front allocation for unlimited buffers (e.g., reading out an entire store)
+        if (totalLiteralLimit > 0 && totalLiteralLimit < INT32_MAX) _out->reserve(totalLiteralLimit);
     }
     ~BufferBuilder() {
         if (_owning_vector && _out != nullptr) delete _out;
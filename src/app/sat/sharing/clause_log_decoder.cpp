@@ -0,0 +1,57 @@
+
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+
+#include "app/sat/sharing/clause_log_format.hpp"
+
+// Converts a binary clause log (as written with -clause-log) into text:
+// one line per clause ("<lbd> [id=<id>] <lits...>") and an empty line after each epoch.
+int main(int argc, char** argv) {
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <clause-log> [<output-file>]\n", argv[0]);
+        return 1;
+    }
+    FILE* in = fopen(argv[1], "rb");
+    if (!in) {
+        fprintf(stderr, "Could not open %s\n", argv[1]);
+        return 1;
+    }
+    FILE* out = argc >= 3 ? fopen(argv[2], "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Could not open %s\n", argv[2]);
+        return 1;
+    }
+
+    int nbMetadataInts;
+    if (!ClauseLogFormat::readFileHeader(in, nbMetadataInts)) {
+        fprintf(stderr, "%s is not a valid clause log\n", argv[1]);
+        return 1;
+    }
+
+    ClauseLogFormat::BlockHeader header;
+    std::vector<ClauseLogFormat::Clause> clauses;
+    size_t nbEpochs = 0, nbClauses = 0;
+    while (ClauseLogFormat::readBlock(in, nbMetadataInts, header, clauses)) {
+        for (auto& cls : clauses) {
+            fprintf(out, "%i", cls.lbd);
+            if (nbMetadataInts >= 2) {
+                uint64_t id;
+                memcpy(&id, cls.metadata.data(), sizeof(uint64_t));
+                fprintf(out, " [id=%lu]", id);
+            }
+            for (int lit : cls.lits) fprintf(out, " %i", lit);
+            fprintf(out, "\n");
+        }
+        fprintf(out, "\n");
+        nbEpochs++;
+        nbClauses += clauses.size();
+    }
+    if (!feof(in)) fprintf(stderr, "Stopped at truncated or corrupted block after epoch %lu\n", nbEpochs);
+    fprintf(stderr, "Decoded %lu clauses in %lu epochs\n", nbClauses, nbEpochs);
+
+    fclose(in);
+    if (out != stdout) fclose(out);
+    return 0;
+}
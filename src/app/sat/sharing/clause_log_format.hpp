@@ -0,0 +1,126 @@
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+// Binary, append-only format of the clause log written by ClauseLogger.
+// A log consists of a file header followed by one block per sharing epoch:
+//
+//   file header:  magic (4 bytes) | version (int32) | #metadata ints per clause (int32)
+//   block header: epoch (int32) | #clauses (int32) | raw size (int32) | compressed size (int32)
+//   block data:   zlib-compressed payload of (raw size) bytes
+//
+// The raw payload contains, for each clause, the number of literals, the LBD,
+// each metadata integer (all as unsigned varints) and then each literal
+// as a zigzag-encoded varint. Blocks can be decoded independently.
+struct ClauseLogFormat {
+
+    static constexpr char MAGIC[4] = {'M', 'C', 'L', 'G'};
+    static constexpr int VERSION = 1;
+    static constexpr int FILE_HEADER_SIZE = 4 + 2*sizeof(int32_t);
+    static constexpr int BLOCK_HEADER_SIZE = 4*sizeof(int32_t);
+
+    struct BlockHeader {
+        int32_t epoch;
+        int32_t nbClauses;
+        int32_t rawSize;
+        int32_t compressedSize;
+    };
+
+    struct Clause {
+        int lbd;
+        std::vector<int> metadata;
+        std::vector<int> lits;
+    };
+
+    static void writeFileHeader(FILE* f, int nbMetadataInts) {
+        int32_t fields[2] = {VERSION, nbMetadataInts};
+        fwrite(MAGIC, 1, 4, f);
+        fwrite(fields, sizeof(int32_t), 2, f);
+    }
+    static bool readFileHeader(FILE* f, int& nbMetadataInts) {
+        char magic[4];
+        int32_t fields[2];
+        if (fread(magic, 1, 4, f) != 4 || memcmp(magic, MAGIC, 4) != 0) return false;
+        if (fread(fields, sizeof(int32_t), 2, f) != 2 || fields[0] != VERSION) return false;
+        nbMetadataInts = fields[1];
+        return true;
+    }
+
+    static inline void writeUnsigned(uint32_t val, std::vector<uint8_t>& out) {
+        while (val >= 0x80) {
+            out.push_back((uint8_t) (val | 0x80));
+            val >>= 7;
+        }
+        out.push_back((uint8_t) val);
+    }
+    static inline uint32_t readUnsigned(const uint8_t*& in) {
+        uint32_t val = 0;
+        int shift = 0;
+        while (*in & 0x80) {
+            val |= ((uint32_t) (*in++ & 0x7f)) << shift;
+            shift += 7;
+        }
+        val |= ((uint32_t) *in++) << shift;
+        return val;
+    }
+    static inline void writeLiteral(int lit, std::vector<uint8_t>& out) {
+        writeUnsigned((((uint32_t) lit) << 1) ^ (uint32_t) (lit >> 31), out);
+    }
+    static inline int readLiteral(const uint8_t*& in) {
+        uint32_t val = readUnsigned(in);
+        return (int) (val >> 1) ^ -(int) (val & 1);
+    }
+
+    // Appends the encoding of one clause (metadata ints followed by literals) to the raw payload.
+    static void encodeClause(const int* data, int size, int lbd, int nbMetadataInts, std::vector<uint8_t>& out) {
+        writeUnsigned(size - nbMetadataInts, out);
+        writeUnsigned(lbd, out);
+        for (int i = 0; i < nbMetadataInts; i++) writeUnsigned(data[i], out);
+        for (int i = nbMetadataInts; i < size; i++) writeLiteral(data[i], out);
+    }
+
+    // Compresses the raw payload of an epoch and writes the resulting block to the file.
+    static bool writeBlock(FILE* f, int epoch, int nbClauses, const std::vector<uint8_t>& raw,
+            std::vector<uint8_t>& compressionBuffer) {
+        uLongf compressedSize = compressBound(raw.size());
+        compressionBuffer.resize(compressedSize);
+        if (compress2(compressionBuffer.data(), &compressedSize, raw.data(), raw.size(), Z_BEST_SPEED) != Z_OK)
+            return false;
+        BlockHeader header {epoch, nbClauses, (int32_t) raw.size(), (int32_t) compressedSize};
+        fwrite(&header, sizeof(BlockHeader), 1, f);
+        fwrite(compressionBuffer.data(), 1, compressedSize, f);
+        return true;
+    }
+
+    // Reads and decodes the next block of the file. Returns false at the end of the file
+    // or if the block is truncated or corrupted.
+    static bool readBlock(FILE* f, int nbMetadataInts, BlockHeader& header, std::vector<Clause>& clauses) {
+        if (fread(&header, sizeof(BlockHeader), 1, f) != 1) return false;
+        if (header.rawSize < 0 || header.compressedSize < 0) return false;
+        std::vector<uint8_t> compressed(header.compressedSize);
+        if (fread(compressed.data(), 1, compressed.size(), f) != compressed.size()) return false;
+        std::vector<uint8_t> raw(header.rawSize + 1); // padding to keep pointer valid
+        uLongf rawSize = header.rawSize;
+        if (uncompress(raw.data(), &rawSize, compressed.data(), compressed.size()) != Z_OK
+            || rawSize != (uLongf) header.rawSize) return false;
+
+        clauses.resize(header.nbClauses);
+        const uint8_t* in = raw.data();
+        for (auto& cls : clauses) {
+            const int nbLits = readUnsigned(in);
+            cls.lbd = readUnsigned(in);
+            cls.metadata.resize(nbMetadataInts);
+            for (auto& m : cls.metadata) m = readUnsigned(in);
+            cls.lits.resize(nbLits);
+            for (auto& lit : cls.lits) lit = readLiteral(in);
+            if (in > raw.data() + header.rawSize) return false;
+        }
+        return in == raw.data() + header.rawSize;
+    }
+};
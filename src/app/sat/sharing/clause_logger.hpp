@@ -3,68 +3,113 @@
 
 #include "app/sat/data/clause.hpp"
 #include "app/sat/data/clause_metadata.hpp"
+#include "app/sat/sharing/clause_log_format.hpp"
+#include "util/logger.hpp"
+#include "util/spsc_blocking_ringbuffer.hpp"
 #include "util/sys/background_worker.hpp"
-#include "util/sys/threading.hpp"
-#include <fstream>
+#include <cstdio>
 #include <vector>
 
+// Writes all successfully shared clauses to a binary log (see ClauseLogFormat)
+// which can be converted to text with the clause_log_decoder tool.
+// The clauses are appended to a flat buffer owned by the (single) sharing thread,
+// without any locking or allocation per clause. At the end of each epoch, this buffer
+// is handed to a background worker via a ringbuffer; the worker encodes and compresses
+// the clauses and writes them to disk. If the worker falls behind, the buffer is kept
+// and handed over at a later epoch instead of blocking the sharing thread. If the kept
+// buffer grows beyond a fixed bound, further epochs are dropped (and counted) until
+// the worker has caught up.
 class ClauseLogger {
 
 private:
+    // Within a flat buffer, each clause is stored as (size, lbd, data...).
+    // A zero size marks the end of an epoch and is followed by the epoch's index.
+    static constexpr int END_OF_EPOCH = 0;
+    // Max. number of ints kept in the local buffer while the worker is behind
+    static constexpr size_t MAX_PENDING_INTS = 1<<24;
+
+    FILE* _file;
+    int _nb_metadata_ints;
+    std::vector<int> _local_buffer;
+    size_t _epoch_begin {0}; // position in _local_buffer where the current epoch begins
+    int _nb_skipped_epochs {0};
+    SPSCBlockingRingbuffer<std::vector<int>> _handoff;
     BackgroundWorker _bg_worker;
-    std::ofstream _ofs;
-    Mutex _mtx_parcelled_clauses;
-    ConditionVariable _cond_var;
-    std::vector<std::vector<int>> _parcelled_clauses;
 
 public:
-    ClauseLogger(const std::string& outputPath) : _ofs(outputPath) {
+    ClauseLogger(const std::string& outputPath) : _file(fopen(outputPath.c_str(), "wb")),
+            _nb_metadata_ints(ClauseMetadata::numInts()), _handoff(16) {
+        if (!_file) {
+            LOG(V1_WARN, "[WARN] Could not open clause log %s\n", outputPath.c_str());
+            return;
+        }
+        ClauseLogFormat::writeFileHeader(_file, _nb_metadata_ints);
         _bg_worker.run([&]() {run();});
     }
+    ~ClauseLogger() {
+        if (!_file) return;
+        _local_buffer.resize(_epoch_begin); // discard unpublished clauses
+        if (!_local_buffer.empty()) _handoff.pushBlocking(_local_buffer);
+        _handoff.markExhausted();
+        _bg_worker.join();
+        fclose(_file);
+        if (_nb_skipped_epochs > 0)
+            LOG(V1_WARN, "[WARN] Clause log skipped %i epochs\n", _nb_skipped_epochs);
+    }
 
     void append(const Mallob::Clause& clause) {
-        std::vector<int> vec(clause.size+1);
-        vec[0] = clause.lbd;
-        for (size_t i = 0; i < clause.size; i++) vec[i+1] = clause.begin[i];
-        {
-            auto lock = _mtx_parcelled_clauses.getLock();
-            _parcelled_clauses.push_back(std::move(vec));
-        }
+        if (!_file) return;
+        _local_buffer.push_back(clause.size);
+        _local_buffer.push_back(clause.lbd);
+        _local_buffer.insert(_local_buffer.end(), clause.begin, clause.begin+clause.size);
     }
 
-    void publish() {
-        {
-            auto lock = _mtx_parcelled_clauses.getLock();
-            _parcelled_clauses.emplace_back();
+    void publish(int epoch) {
+        if (!_file) return;
+        if (_handoff.full() && _local_buffer.size() > MAX_PENDING_INTS) {
+            // worker is too far behind: drop this epoch's clauses
+            _local_buffer.resize(_epoch_begin);
+            _nb_skipped_epochs++;
+            return;
         }
-        _cond_var.notify();
+        _local_buffer.push_back(END_OF_EPOCH);
+        _local_buffer.push_back(epoch);
+        _epoch_begin = _local_buffer.size();
+        if (_handoff.full()) return;
+        _handoff.pushBlocking(_local_buffer);
+        _local_buffer.clear();
+        _epoch_begin = 0;
     }
 
+    int getNbSkippedEpochs() const {
+        return _nb_skipped_epochs;
+    }
+
+private:
     void run() {
-        std::vector<std::vector<int>> outClauses;
-        while (true) {
-            {
-                auto lock = _mtx_parcelled_clauses.getLock();
-                _cond_var.waitWithLockedMutex(lock, [&]() {
-                    return !_bg_worker.continueRunning() || !_parcelled_clauses.empty();
-                });
-                if (!_bg_worker.continueRunning()) break;
-                outClauses = std::move(_parcelled_clauses);
-            }
-            for (auto& vec : outClauses) if (!vec.empty()) {
-                _ofs << vec[0];
-                if (ClauseMetadata::enabled()) {
-                    uint64_t id = ClauseMetadata::readUnsignedLong(vec.data()+1);
-                    _ofs << " [id=" << id << "]";
+        std::vector<int> buffer;
+        std::vector<uint8_t> raw;
+        std::vector<uint8_t> compressed;
+        int nbClauses = 0;
+        while (_handoff.pollBlocking(buffer)) {
+            size_t pos = 0;
+            while (pos < buffer.size()) {
+                const int size = buffer[pos++];
+                if (size == END_OF_EPOCH) {
+                    const int epoch = buffer[pos++];
+                    if (!ClauseLogFormat::writeBlock(_file, epoch, nbClauses, raw, compressed))
+                        LOG(V1_WARN, "[WARN] Could not compress clause log block of epoch %i\n", epoch);
+                    nbClauses = 0;
+                    raw.clear();
+                    continue;
                 }
-                for (size_t i = 1+ClauseMetadata::numInts(); i < vec.size(); i++)
-                    _ofs << " " << vec[i];
-                _ofs << std::endl;
+                const int lbd = buffer[pos++];
+                ClauseLogFormat::encodeClause(buffer.data()+pos, size, lbd, _nb_metadata_ints, raw);
+                pos += size;
+                nbClauses++;
             }
-            outClauses.clear();
-            _ofs << std::endl;
-            _ofs.flush();
+            buffer.clear();
+            fflush(_file);
         }
-        _ofs.close();
     }
 };
@@ -400,7 +400,7 @@ std::vector<int> SharingManager::filterSharing(std::vector<int>& clauseBuf) {
 	});
 }
 
-void SharingManager::digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>* filter) {
+void SharingManager::digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>* filter, int epoch) {
 	int verb = _job_index == 0 ? V3_VERB : V5_DEBG;
 
 	float time = Timer::elapsedSeconds();
@@ -417,6 +417,15 @@ void SharingManager::digestSharingWithFilter(std::vector<int>& clauseBuf, std::v
 		importingSolvers.emplace_back(solver->getGlobalId(), solver->getLocalId(), _solver_stats[i], _id_alignment.get());
 	}
 
+	// Sample how many of the clauses delivered since the last digestion were kept by the solvers
+	unsigned long nbKept = 0, nbDelivered = 0;
+	for (auto& slv : importingSolvers) {
+		if (_solvers[slv.localId]->writeImportStatistics(*_solver_stats[slv.localId]))
+			_solver_stats[slv.localId]->sampleImportUtility(nbKept, nbDelivered);
+	}
+	_last_num_kept_imports = std::min(nbKept, (unsigned long) INT32_MAX);
+	_last_num_delivered_imports = std::min(nbDelivered, (unsigned long) INT32_MAX);
+
 	_last_num_cls_to_import = 0;
 	_last_num_admitted_cls_to_import = 0;
 	_last_num_admitted_lits_to_import = 0;
@@ -435,6 +444,9 @@ void SharingManager::digestSharingWithFilter(std::vector<int>& clauseBuf, std::v
 
 	_logger.log(verb+2, "DG import\n");
 
+	// Only clauses of an actual sharing epoch are logged (not historic ones)
+	const bool logClauses = _clause_logger && epoch >= 0;
+
 	// For each incoming clause (which was not filtered out)
 	int filterSizeBeingLocked = -1;
 	auto clause = reader.getNextIncomingClause();
@@ -446,7 +458,7 @@ void SharingManager::digestSharingWithFilter(std::vector<int>& clauseBuf, std::v
 			memcpy(&id, clause.begin, sizeof(uint64_t));
 		}
 
-		if (_clause_logger) _clause_logger->append(clause);
+		if (logClauses) _clause_logger->append(clause);
 
 		if (filterSizeBeingLocked != clause.size) {
 			if (filterSizeBeingLocked != -1) _clause_filter->releaseLock(filterSizeBeingLocked);
@@ -496,7 +508,7 @@ void SharingManager::digestSharingWithFilter(std::vector<int>& clauseBuf, std::v
 	// Signal next garbage collection
 	_gc_pending = true;
 	_sharing_op_ongoing = false;
-	if (_clause_logger) _clause_logger->publish();
+	if (logClauses) _clause_logger->publish(epoch);
 }
 
 void SharingManager::applyFilterToBuffer(std::vector<int>& clauseBuf, std::vector<int>* filter) {
@@ -519,9 +531,9 @@ void SharingManager::applyFilterToBuffer(std::vector<int>& clauseBuf, std::vecto
 	_last_num_admitted_cls_to_import += filtering.getNumAdmittedClauses();
 }
 
-void SharingManager::digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless) {
+void SharingManager::digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless, int epoch) {
 	bool sharingOpOngoing = _sharing_op_ongoing;
-	digestSharingWithFilter(clauseBuf, nullptr);
+	digestSharingWithFilter(clauseBuf, nullptr, epoch);
 	if (stateless) _sharing_op_ongoing = sharingOpOngoing;
 }
 
@@ -71,6 +71,9 @@ protected:
 	int _last_num_cls_to_import = 0;
 	int _last_num_admitted_cls_to_import = 0;
 	int _last_num_admitted_lits_to_import = 0;
+	// import utility sampled from the solvers during the last digestion
+	int _last_num_kept_imports = 0;
+	int _last_num_delivered_imports = 0;
 
 	ClauseHistogram _hist_produced;
 	ClauseHistogram _hist_returned_to_db;
@@ -114,8 +117,9 @@ public:
 	void addSharingEpoch(int epoch) {_digested_epochs.insert(epoch);}
 	std::vector<int> prepareSharing(int totalLiteralLimit, int& outSuccessfulSolverId, int& outNbLits);
 	std::vector<int> filterSharing(std::vector<int>& clauseBuf);
-	void digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>* filter);
-	void digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless);
+	// epoch: global sharing epoch of the clauses, or -1 if not applicable (e.g., historic clauses)
+	void digestSharingWithFilter(std::vector<int>& clauseBuf, std::vector<int>* filter, int epoch = -1);
+	void digestSharingWithoutFilter(std::vector<int>& clauseBuf, bool stateless, int epoch = -1);
 	void returnClauses(std::vector<int>& clauseBuf);
 	void digestHistoricClauses(int epochBegin, int epochEnd, std::vector<int>& clauseBuf);
 	void collectGarbageInFilter();
@@ -132,6 +136,8 @@ public:
 	int getLastNumClausesToImport() const {return _last_num_cls_to_import;}
 	int getLastNumAdmittedClausesToImport() const {return _last_num_admitted_cls_to_import;}
 	int getLastNumAdmittedLitsToImport() const {return _last_num_admitted_lits_to_import;}
+	int getLastNumKeptImports() const {return _last_num_kept_imports;}
+	int getLastNumDeliveredImports() const {return _last_num_delivered_imports;}
 
 	unsigned long getGlobalStartOfSuccessEpoch() {
 		return !_id_alignment ? 0 : _id_alignment->getGlobalStartOfSuccessEpoch();
@@ -132,6 +132,10 @@ void Cadical::addLiteral(int lit) {
 	solver->add(lit);
 }
 
+void Cadical::addClauses(const int* lits, size_t n) {
+	for (size_t i = 0; i < n; i++) solver->add(lits[i]);
+}
+
 void Cadical::diversify(int seed) {
 
 	if (seedSet) return;
@@ -292,6 +296,14 @@ void Cadical::writeStatistics(SolverStatistics& stats) {
         s.r_el, s.r_fx, s.r_wit);
 }
 
+bool Cadical::writeImportStatistics(SolverStatistics& stats) {
+	if (!solver) return false;
+	CaDiCaL::Solver::Statistics s = solver->get_stats();
+	stats.imported = s.imported;
+	stats.discarded = s.discarded;
+	return true;
+}
+
 void Cadical::cleanUp() {
 
 	// Clean up proof output pipeline *while the solver may still be running*
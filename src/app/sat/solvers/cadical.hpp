@@ -49,6 +49,7 @@ public:
 
 	// Add a (list of) permanent clause(s) to the formula
 	void addLiteral(int lit) override;
+	void addClauses(const int* lits, size_t n) override;
 
 	void diversify(int seed) override;
 	void addConfigurationSetting(Setting setting) override;
@@ -80,6 +81,7 @@ public:
 
 	// Get solver statistics
 	void writeStatistics(SolverStatistics& stats) override;
+	bool writeImportStatistics(SolverStatistics& stats) override;
 
 	bool supportsIncrementalSat() override {return true;}
 	bool exportsConditionalClauses() override {return false;}
@@ -49,6 +49,26 @@ void MGlucose::addLiteral(int lit) {
 	}
 }
 
+void MGlucose::addClauses(const int* lits, size_t n) {
+	if (incremental) {
+		// variables must be frozen one by one as they appear
+		for (size_t i = 0; i < n; i++) MGlucose::addLiteral(lits[i]);
+		return;
+	}
+	resetMaps();
+	nomodel = true;
+	for (size_t i = 0; i < n; i++) {
+		const int lit = lits[i];
+		if (lit != 0) {
+			clause.push(encodeLit(lit));
+			maxvar = std::max(maxvar, abs(lit));
+		} else {
+			addClause(clause);
+			clause.clear();
+		}
+	}
+}
+
 /*
  * This method uses some of the diversification from SolverConfiguration::configureSAT14().
  */
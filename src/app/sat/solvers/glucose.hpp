@@ -40,6 +40,7 @@ public:
 
 	// Add a (list of) permanent clause(s) to the formula
 	void addLiteral(int lit) override;
+	void addClauses(const int* lits, size_t n) override;
 
 	void diversify(int seed) override;
 	void setPhase(const int var, const bool phase) override;
@@ -89,6 +89,15 @@ void Kissat::addLiteral(int lit) {
     numVars = std::max(numVars, std::abs(lit));
 }
 
+void Kissat::addClauses(const int* lits, size_t n) {
+    int maxVar = numVars;
+    for (size_t i = 0; i < n; i++) {
+        kissat_add(solver, lits[i]);
+        maxVar = std::max(maxVar, std::abs(lits[i]));
+    }
+    numVars = maxVar;
+}
+
 void Kissat::diversify(int seed) {
 
     if (seedSet) return;
@@ -138,6 +147,10 @@ void Kissat::addConfigurationSetting(Setting setting) {
     }
 }
 
+std::string Kissat::getVersion() {
+    return kissat_signature();
+}
+
 int Kissat::getNumOriginalDiversifications() {
     return _setup.flavour == PortfolioSequence::SAT ? 4 : 11;
 }
@@ -292,6 +305,14 @@ void Kissat::writeStatistics(SolverStatistics& stats) {
         kstats.r_ee, kstats.r_ed, kstats.r_pb, kstats.r_ss, kstats.r_sw, kstats.r_tr, kstats.r_fx, kstats.r_ia, kstats.r_tl);
 }
 
+bool Kissat::writeImportStatistics(SolverStatistics& stats) {
+    if (!solver) return false;
+    kissat_statistics kstats = kissat_get_statistics(solver);
+    stats.imported = kstats.imported;
+    stats.discarded = kstats.discarded;
+    return true;
+}
+
 bool Kissat::isPreprocessingAcceptable(int nbVars, int nbClauses) {
     bool accept = nbVars != _setup.numVars || nbClauses != _setup.numOriginalClauses;
     if (accept) {
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "app/sat/proof/lrat_op.hpp"
@@ -43,8 +44,12 @@ public:
 	Kissat(const SolverSetup& setup);
 	 ~Kissat();
 
+	// Version of the linked Kissat library
+	static std::string getVersion();
+
 	// Add a (list of) permanent clause(s) to the formula
 	void addLiteral(int lit) override;
+	void addClauses(const int* lits, size_t n) override;
 
 	void diversify(int seed) override;
 	void addConfigurationSetting(Setting setting) override;
@@ -72,6 +77,7 @@ public:
 
 	// Get solver statistics
 	void writeStatistics(SolverStatistics& stats) override;
+	bool writeImportStatistics(SolverStatistics& stats) override;
 
 	bool supportsIncrementalSat() override {return false;}
 	bool exportsConditionalClauses() override {return false;}
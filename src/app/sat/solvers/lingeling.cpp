@@ -98,6 +98,20 @@ void Lingeling::addLiteral(int lit) {
 	lgladd(solver, lit);
 }
 
+void Lingeling::addClauses(const int* lits, size_t n) {
+	if (incremental) {
+		// variables must be frozen one by one as they appear
+		for (size_t i = 0; i < n; i++) Lingeling::addLiteral(lits[i]);
+		return;
+	}
+	int maxLit = 0;
+	for (size_t i = 0; i < n; i++) {
+		maxLit = std::max(maxLit, std::abs(lits[i]));
+		lgladd(solver, lits[i]);
+	}
+	if (maxLit != 0) updateMaxVar(maxLit);
+}
+
 void Lingeling::updateMaxVar(int lit) {
 	lit = abs(lit);
 	assert(lit <= 134217723); // lingeling internal literal limit
@@ -287,6 +301,10 @@ int Lingeling::getVariablesCount() {
 	return maxvar;
 }
 
+std::string Lingeling::getVersion() {
+	return lglversion();
+}
+
 int Lingeling::getNumOriginalDiversifications() {
 	return numDiversifications;
 }
@@ -55,8 +55,12 @@ public:
 	Lingeling(const SolverSetup& setup);
 	 ~Lingeling() override;
 
+	// Version of the linked Lingeling library
+	static std::string getVersion();
+
 	// Add a (list of) permanent clause(s) to the formula
 	void addLiteral(int lit) override;
+	void addClauses(const int* lits, size_t n) override;
 
 	void diversify(int seed) override;
 	void addConfigurationSetting(Setting setting) override;
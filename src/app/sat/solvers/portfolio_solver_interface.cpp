@@ -148,6 +148,10 @@ PortfolioSolverInterface::PortfolioSolverInterface(const SolverSetup& setup)
 
 	});
 
+	if (_setup.checkpointReservoirSize > 0) {
+		_checkpoint_reservoir.reset(new LearnedClauseReservoir(_setup.checkpointReservoirSize));
+	}
+
 	if (!_setup.objectiveFunction.empty()) {
 		_optimizer.reset(new OptimizingPropagator(_setup.objectiveFunction, _setup.numVars));
 	}
@@ -169,6 +173,7 @@ void PortfolioSolverInterface::setTerminate() {
 void PortfolioSolverInterface::setExtLearnedClauseCallback(const ExtLearnedClauseCallback& callback) {
 	auto cb = ([callback, this](const Mallob::Clause& c, int solverId) {
 		if (_terminated || !_setup.exportClauses) return;
+		if (_checkpoint_reservoir) _checkpoint_reservoir->add(c.begin, c.size, c.lbd, _conditional_lits);
 		callback(c, solverId, getSolverSetup().solverRevision, _conditional_lits);
 	});
 	setLearnedClauseCallback(cb);
@@ -10,6 +10,7 @@
 #include <string>
 
 #include "app/sat/data/definitions.hpp"
+#include "app/sat/data/sat_checkpoint.hpp"
 #include "app/sat/data/solver_statistics.hpp"
 #include "app/sat/execution/solver_setup.hpp"
 #include "app/sat/sharing/generic_import_manager.hpp"
@@ -20,6 +21,7 @@
 #include "util/random.hpp"
 #include "util/logger.hpp"
 #include "util/string_utils.hpp"
+#include "util/sys/numa.hpp"
 
 class BufferReader;
 namespace Mallob {
@@ -75,6 +77,12 @@ public:
 
 	// Add a permanent literal to the formula (zero for clause separator)
 	virtual void addLiteral(int lit) = 0;
+	// Add a chunk of permanent literals with zeroes as clause separators.
+	// The chunk may begin and/or end in the middle of a clause.
+	// The literals have already been validated by the caller.
+	virtual void addClauses(const int* lits, size_t n) {
+		for (size_t i = 0; i < n; i++) addLiteral(lits[i]);
+	}
 
 	// Set a function that should be called for each learned clause
 	virtual void setLearnedClauseCallback(const LearnedClauseCallback& callback) = 0;
@@ -85,6 +93,9 @@ public:
 
 	// Get solver statistics
 	virtual void writeStatistics(SolverStatistics& stats) = 0;
+	// Only update the counters of imported and discarded clauses (sampled at each
+	// sharing epoch). Returns false if the solver does not track these counters.
+	virtual bool writeImportStatistics(SolverStatistics& stats) {return false;}
 
 	// Diversify your parameters (seeds, heuristics, etc.) according to the seed
 	// and the individual diversification index given by getDiversificationIndex().
@@ -186,6 +197,8 @@ public:
 	void addLearnedClause(const Mallob::Clause& c);
 	void addLearnedClauses(BufferReader& reader, int revision) {
 		if (!_clause_import_enabled) return;
+		// Let the calling (sharing) thread fault in new buffer memory on this solver's node
+		NumaPreferredNodeScope numaScope(_setup.numaNode);
 		_import_manager->setImportedRevision(revision);
 		_import_manager->performImport(reader);
 	}
@@ -219,6 +232,11 @@ public:
 	OptimizingPropagator* getOptimizer() {
 		return _optimizer.get();
 	}
+	// Clauses recently exported by this solver as (size, lbd, lits...) for a checkpoint
+	std::vector<int> extractCheckpointClauses() {
+		if (!_checkpoint_reservoir) return {};
+		return _checkpoint_reservoir->extract();
+	}
 	SolvingReplay& getReplay() {
 		return _replay;
 	}
@@ -234,6 +252,7 @@ private:
 
 	SolverStatistics _stats;
 	std::unique_ptr<GenericImportManager> _import_manager;
+	std::unique_ptr<LearnedClauseReservoir> _checkpoint_reservoir;
 
 	SplitMix64Rng _rng;
 };
@@ -4,18 +4,27 @@
 #include "app/incsat/inc_sat_controller.hpp"
 #include "app/sat/data/definitions.hpp"
 #include "app/sat/solvers/cadical.hpp"
+#include "comm/msg_queue/message_subscription.hpp"
+#include "comm/msgtags.h"
 #include "core/dtask_tracker.hpp"
 #include "data/job_description.hpp"
 #include "data/job_result.hpp"
+#include "data/job_transfer.hpp"
 #include "interface/api/api_registry.hpp"
 #include "mpi.h"
 #include "util/logger.hpp"
 #include "util/params.hpp"
 #include "util/random.hpp"
 #include "util/sys/terminator.hpp"
+#include "util/sys/threading.hpp"
+#include "util/sys/thread_pool.hpp"
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cfloat>
 #include <cmath>
+#include <future>
+#include <list>
 #include <memory>
 #include <vector>
 
@@ -28,18 +37,64 @@ private:
 
     float _start_time;
     int _status {0};
+    std::vector<int> _solution; // found during cube generation if _status == SAT
 
     enum CubingMode {VAR_OCCURRENCE, LOOKAHEAD_CADICAL} _cubing_mode {LOOKAHEAD_CADICAL};
 
     DTaskTracker _dtask_tracker;
 
+    // All job streams of this CnC job form a job group, which allows them to
+    // share learned clauses via cross-job clause sharing (-cjc). The clauses
+    // shared within the group are additionally reported to this client.
+    std::string _group_name;
+    int _group_id {-1};
+    int _max_var {0};
+    MessageSubscription _sub_xtcs_incoming_clauses;
+    Mutex _mtx_incoming_messages;
+    std::list<MessageHandle> _incoming_messages;
+    int _nb_forwarded_clause_buffers {0};
+
+    struct Cube {
+        std::vector<int> lits;
+        int nbSplits {0}; // how often this cube's ancestors have been split
+        bool splittable {true};
+    };
+    // A job stream together with the cube it is currently solving.
+    struct CubeSlot {
+        std::atomic<float> deadline {FLT_MAX}; // time at which the current cube is interrupted
+        std::unique_ptr<IncSatController> incsat;
+        Cube cube;
+        float startTime {0};
+    };
+    // The concurrent splitting of a cube which exceeded its budget.
+    struct PendingSplit {
+        Cube cube;
+        std::vector<Cube> subcubes;
+        int status {0};
+        std::vector<int> solution; // found by the lookahead if status == SAT
+        std::atomic<bool> interrupted {false}; // set to abandon the splitting
+        std::future<void> future;
+    };
+
+    // Runtimes of all cubes which were solved or interrupted so far.
+    std::vector<float> _cube_runtimes;
+    int _nb_split_cubes {0};
+
 public:
-    CncController(const Parameters& params, JobDescription& desc) : _params(params), _desc(desc), _dtask_tracker(_params) {
+    CncController(const Parameters& params, JobDescription& desc) : _params(params), _desc(desc), _dtask_tracker(_params),
+            _group_name("cnc-" + std::to_string(_desc.getId())),
+            _sub_xtcs_incoming_clauses(MSG_SEND_APP_DATA_TO_CLIENT_JOB, [&](MessageHandle& h) {
+                auto lock = _mtx_incoming_messages.getLock();
+                _incoming_messages.push_back(h);
+            }) {
         // Extract the base formula to solve.
         _base_formula.insert(_base_formula.end(),
             _desc.getFormulaPayload(0),
             _desc.getFormulaPayload(0)+_desc.getFormulaPayloadSize(0));
+        for (int lit : _base_formula) _max_var = std::max(_max_var, std::abs(lit));
         LOG(V2_INFO, "CNC formula: %s\n", StringUtils::getSummary(_base_formula, 20).c_str());
+        if (_params.cncShareClauses() && !_params.crossJobCommunication())
+            LOG(V2_INFO, "[WARN] CNC clause sharing across streams requires -cjc=1\n");
     }
 
     // Solves the provided SAT formula by means of Cube-and-Conquer.
@@ -54,38 +109,84 @@ public:
 
         // Generate a set of cubes
         SplitMix64Rng rng(_params.seed());
-        int depth = 10; // 2^10 = 1024 cubes
+        int depth = _params.cncCubingDepth();
         LOG(V2_INFO, "CNC generating cubes with depth %i\n", depth);
-        std::vector<std::vector<int>> cubes = getCubes(depth);
+        std::vector<Cube> cubes;
+        for (auto& lits : getCubes(depth)) cubes.push_back(Cube{std::move(lits)});
         ::random_shuffle(cubes.data(), cubes.size(), rng); // shuffle randomly
         int nbGeneratedCubes = cubes.size();
         int nbUnsatCubes = 0; // track number of cubes found UNSAT so far
-        LOG(V2_INFO, "CNC generated %i cubes, status=%i\n", nbGeneratedCubes, _status);
+        int nbOpenCubes = nbGeneratedCubes; // cubes which are queued, being solved, or being split
+        LOG(V2_INFO, "CNC generated %i cubes in %.3fs, status=%i\n", nbGeneratedCubes,
+            Timer::elapsedSeconds() - _start_time, _status);
         if (_status != 0) {
             res.result = _status;
+            if (_status == SAT) res.setSolution(std::move(_solution));
             LOG(V2_INFO, "CNC CONCLUDE %s\n", _status==10 ? "SAT" : "UNSAT");
             return res;
         }
 
         // Set up up to four SAT job streams, but no more than the global number of processes
-        std::vector<std::unique_ptr<IncSatController>> incsats;
+        std::vector<std::unique_ptr<CubeSlot>> slots;
         int jobSlots = _params.jobSlots() > 0 ? _params.jobSlots() : MyMpi::size(MPI_COMM_WORLD);
         int numConcStreams = std::min(jobSlots, MyMpi::size(MPI_COMM_WORLD));
         for (int i = 0; i < numConcStreams; i++)
-            incsats.push_back(addJobStream());
+            slots.push_back(addCubeSlot());
+        const bool splitCubes = _params.cncCubeTimeBudget() > 0;
+        std::vector<std::unique_ptr<PendingSplit>> pendingSplits;
 
         // Repeatedly loop over all your streams, submitting cubes and fetching results,
-        // until a stopping criterion is reached.
+        // until a stopping criterion is reached. All idle streams pull their next cube
+        // from the shared queue of cubes. If a cube exceeds its time budget, it is split
+        // into a number of smaller cubes, which are appended to the queue.
         bool stop = false;
         while (!stop && !isTimeoutHit()) {
-            if (nbUnsatCubes == nbGeneratedCubes) {
+            if (nbOpenCubes == 0) {
                 // All cubes found UNSAT. We are done!
                 LOG(V2_INFO, "CNC CONCLUDE UNSAT\n");
                 res.result = UNSAT;
                 stop = true;
                 break;
             }
-            for (auto& incsat : incsats) {
+            // Forward clauses shared within the group to streams which did not take part
+            forwardIncomingSharedClauses(slots);
+            // Integrate the results of finished cube splittings
+            for (size_t i = 0; i < pendingSplits.size(); i++) {
+                auto& split = *pendingSplits[i];
+                if (split.future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) continue;
+                nbOpenCubes--;
+                if (split.status == SAT) {
+                    // Lookahead satisfied the cube! We are done!
+                    LOG(V2_INFO, "CNC Cube SAT during splitting\n");
+                    LOG(V2_INFO, "CNC CONCLUDE SAT\n");
+                    res.result = SAT;
+                    res.setSolution(std::move(split.solution));
+                    stop = true;
+                    break;
+                } else if (split.status == UNSAT) {
+                    // Lookahead refuted the cube
+                    nbUnsatCubes++;
+                    LOG(V2_INFO, "CNC Cube UNSAT (%i/%i) during splitting\n", nbUnsatCubes, nbGeneratedCubes);
+                } else if (split.subcubes.size() <= 1) {
+                    // Cube could not be split: solve it without any budget
+                    split.cube.splittable = false;
+                    cubes.push_back(std::move(split.cube));
+                    nbOpenCubes++;
+                } else {
+                    LOG(V3_VERB, "CNC split cube of size %lu into %lu cubes\n",
+                        split.cube.lits.size(), split.subcubes.size());
+                    nbGeneratedCubes += split.subcubes.size();
+                    nbOpenCubes += split.subcubes.size();
+                    for (auto& subcube : split.subcubes) cubes.push_back(std::move(subcube));
+                    _nb_split_cubes++;
+                }
+                pendingSplits.erase(pendingSplits.begin()+i);
+                i--;
+            }
+            if (stop) break;
+            for (auto& slotPtr : slots) {
+                auto& slot = *slotPtr;
+                auto& incsat = slot.incsat;
                 // already cleaning up this stream?
                 if (!incsat->hasStream()) continue;
                 auto& stream = incsat->getStream();
@@ -94,6 +195,8 @@ public:
                 if (!stream.isIdle() && !stream.isNonblockingSolvePending()) {
                     // -- yes - retrieve it
                     auto [code, witness] = stream.getNonblockingSolveResult();
+                    const float time = Timer::elapsedSeconds();
+                    _cube_runtimes.push_back(time - slot.startTime);
                     if (code == SAT) {
                         // Cube was found satisfiable! We are done!
                         LOG(V2_INFO, "CNC Cube SAT\n");
@@ -105,7 +208,13 @@ public:
                     } else if (code == UNSAT) {
                         // Cube was found unsatisfiable.
                         nbUnsatCubes++;
+                        nbOpenCubes--;
                         LOG(V2_INFO, "CNC Cube UNSAT (%i/%i)\n", nbUnsatCubes, nbGeneratedCubes);
+                    } else if (time >= slot.deadline.load(std::memory_order_relaxed) && !isTimeoutHit()) {
+                        // Cube exceeded its budget: split it further (concurrently)
+                        LOG(V3_VERB, "CNC Cube of size %lu exceeded budget after %.3fs\n",
+                            slot.cube.lits.size(), time - slot.startTime);
+                        pendingSplits.push_back(splitCubeAsync(std::move(slot.cube)));
                     } else {
                         // Cube solving returned UNKNOWN: something has gone wrong
                         // or an internal limit was reached (timeout, interrupt, etc.)
@@ -117,6 +226,8 @@ public:
                 if (stream.isIdle()) {
                     // Try to submit next cube
                     if (cubes.empty()) {
+                        // If other cubes may still be split, keep this stream around
+                        if (splitCubes && nbOpenCubes > 0) continue;
                         // No cubes left to submit - yield this stream
                         // TODO finalize can sometimes take longer - do concurrently instead?
                         LOG(V3_VERB, "CNC finalizing stream\n");
@@ -125,16 +236,21 @@ public:
                         continue;
                     }
                     // Remove next cube and submit it
-                    auto cube = cubes.back(); cubes.pop_back();
-                    submitCube(cube, *incsat);
+                    slot.cube = std::move(cubes.back()); cubes.pop_back();
+                    submitCube(slot);
                     assert(!stream.isIdle());
                 }
             }
         }
 
+        reportCubeRuntimes();
+
         // RAII should take care of cleaning up all of the remaining job streams
         // and their associated resources.
-        incsats.clear();
+        slots.clear();
+        // Interrupt all cube splittings which are still running
+        for (auto& split : pendingSplits) split->interrupted.store(true, std::memory_order_relaxed);
+        for (auto& split : pendingSplits) split->future.wait();
 
         return res;
     }
@@ -160,26 +276,100 @@ private:
         }
 
         if (_cubing_mode == LOOKAHEAD_CADICAL) {
-            SolverSetup setup;
-            setup.logger = &Logger::getMainInstance();
-            setup.solverType = 'C';
-            setup.isJobIncremental = true;
-            setup.exportClauses = false;
-            setup.baseSeed = 0;
-            std::unique_ptr<Cadical> solver;
-            solver.reset(new Cadical(setup));
-            solver->setLearnedClauseCallback([&](const Mallob::Clause&, int) {});
-            solver->getTerminator().setExternalTerminator([&]() {return false;});
-            solver->diversify(0);
-            for (int lit : _base_formula) solver->addLiteral(lit);
-
-            std::vector<std::vector<int>> cubes = solver->cube(depth, _status);
+            // Perform the first levels of splitting sequentially
+            const int parLevels = std::min(_params.cncParallelCubingLevels(), depth);
+            std::vector<std::vector<int>> prefixes = lookahead({}, parLevels == 0 ? depth : parLevels, _status,
+                &_solution);
+            if (parLevels == 0 || parLevels == depth || _status != 0) return prefixes;
+
+            // Continue the lookahead for each partial cube in parallel
+            std::vector<std::vector<std::vector<int>>> subcubes(prefixes.size());
+            std::vector<int> statuses(prefixes.size(), 0);
+            std::vector<std::vector<int>> solutions(prefixes.size());
+            std::vector<std::future<void>> futures;
+            for (size_t i = 0; i < prefixes.size(); i++) {
+                futures.push_back(ProcessWideThreadPool::get().addTask([&, i]() {
+                    subcubes[i] = lookahead(prefixes[i], depth - parLevels, statuses[i], &solutions[i]);
+                }));
+            }
+            for (auto& fut : futures) fut.wait();
+
+            std::vector<std::vector<int>> cubes;
+            for (size_t i = 0; i < prefixes.size(); i++) {
+                if (statuses[i] == SAT) {
+                    // partial cube satisfied: the formula is satisfiable
+                    _status = SAT;
+                    _solution = std::move(solutions[i]);
+                    return {};
+                }
+                if (statuses[i] == UNSAT) continue; // partial cube refuted
+                if (subcubes[i].empty()) {
+                    cubes.push_back(std::move(prefixes[i]));
+                    continue;
+                }
+                for (auto& subcube : subcubes[i]) {
+                    subcube.insert(subcube.begin(), prefixes[i].begin(), prefixes[i].end());
+                    cubes.push_back(std::move(subcube));
+                }
+            }
+            if (cubes.empty()) _status = UNSAT; // all partial cubes refuted
             return cubes;
         }
 
         return {};
     }
 
+    // Generate cubes of the provided depth via CaDiCaL's lookahead
+    // for the base formula under the provided (partial) cube.
+    // The returned cubes do not contain the literals of the provided cube.
+    // If the lookahead finds the formula to be satisfiable under the cube, status is set to SAT
+    // and a satisfying assignment is written to `solution`.
+    // If an interrupt flag is provided, the lookahead stops as soon as it is set.
+    std::vector<std::vector<int>> lookahead(const std::vector<int>& cube, int depth, int& status,
+            std::vector<int>* solution, const std::atomic<bool>* interrupt = nullptr) const {
+        SolverSetup setup;
+        setup.logger = &Logger::getMainInstance();
+        setup.solverType = 'C';
+        setup.isJobIncremental = true;
+        setup.exportClauses = false;
+        setup.baseSeed = 0;
+        std::unique_ptr<Cadical> solver;
+        solver.reset(new Cadical(setup));
+        solver->setLearnedClauseCallback([&](const Mallob::Clause&, int) {});
+        solver->getTerminator().setExternalTerminator([interrupt]() {
+            return interrupt && interrupt->load(std::memory_order_relaxed);
+        });
+        solver->diversify(0);
+        for (int lit : _base_formula) solver->addLiteral(lit);
+        for (int lit : cube) {
+            solver->addLiteral(lit);
+            solver->addLiteral(0);
+        }
+        auto cubes = solver->cube(depth, status);
+        if (status == SAT) {
+            // Retrieve the assignment by solving the (now trivial) formula once more
+            if (solver->solve(0, nullptr) == SAT) *solution = solver->getSolution();
+            else status = 0; // interrupted: treat like an unsplittable cube
+        }
+        return cubes;
+    }
+
+    // Split the provided cube into smaller cubes in a separate thread.
+    std::unique_ptr<PendingSplit> splitCubeAsync(Cube&& cube) {
+        std::unique_ptr<PendingSplit> split(new PendingSplit());
+        split->cube = std::move(cube);
+        split->future = ProcessWideThreadPool::get().addTask([&, split = split.get()]() {
+            if (split->interrupted.load(std::memory_order_relaxed)) return;
+            auto cubes = lookahead(split->cube.lits, _params.cncSplitDepth(), split->status,
+                &split->solution, &split->interrupted);
+            for (auto& lits : cubes) {
+                lits.insert(lits.begin(), split->cube.lits.begin(), split->cube.lits.end());
+                split->subcubes.push_back(Cube{std::move(lits), split->cube.nbSplits+1});
+            }
+        });
+        return split;
+    }
+
     // Select a set to variables to branch over.
     std::vector<int> getSplittingVariables(int depth) {
 
@@ -213,20 +403,85 @@ private:
     }
 
     // A bit of boilerplate code to get an incremental SAT solving task in Mallob up and running.
-    std::unique_ptr<IncSatController> addJobStream() {
+    std::unique_ptr<CubeSlot> addCubeSlot() {
 
+        std::unique_ptr<CubeSlot> slot(new CubeSlot());
         // Create wrapper object for SAT job stream
-        std::unique_ptr<IncSatController> incsat(new IncSatController(_params, APIRegistry::get(), _desc, _dtask_tracker));
-        incsat->initInteractiveSolving();
-        incsat->getMallobProcessor()->setGroupId("cnc-" + std::to_string(_desc.getId()));
-        return incsat;
+        slot->incsat.reset(new IncSatController(_params, APIRegistry::get(), _desc, _dtask_tracker));
+        // Interrupt the current cube as soon as it exceeds its budget
+        slot->incsat->setInnerTerminator([deadline = &slot->deadline]() {
+            return Timer::elapsedSeconds() >= deadline->load(std::memory_order_relaxed);
+        }, false);
+        slot->incsat->initInteractiveSolving();
+        if (_params.cncShareClauses()) {
+            // All streams solve the same base formula without adding clauses,
+            // so each clause learned for one cube is valid for all other cubes.
+            // Only admit clauses over the base formula's variables.
+            slot->incsat->getMallobProcessor()->setGroupId(_group_name, 1, _max_var);
+            _group_id = APIRegistry::get().getJsonInterface().getJobDescriptionIdAllocator().getId(_group_name);
+        } else {
+            slot->incsat->getMallobProcessor()->setGroupId(_group_name);
+        }
+        return slot;
     }
 
-    // Submit a formula together with the specified cube to the specified (idle!) SatJobStream.
-    void submitCube(const std::vector<int>& cube, IncSatController& incsat) {
+    // Clauses which were shared across the group's active streams arrive here.
+    // Streams which are idle right now were not part of that exchange, so they
+    // receive the clauses directly (to be imported as soon as they are active again).
+    void forwardIncomingSharedClauses(std::vector<std::unique_ptr<CubeSlot>>& slots) {
+        auto lock = _mtx_incoming_messages.getLock();
+        while (!_incoming_messages.empty()) {
+            MessageHandle h = std::move(_incoming_messages.front());
+            _incoming_messages.pop_front();
+            JobMessage msg = Serializable::get<JobMessage>(h.getRecvData());
+            if (_group_id < 0 || msg.contextIdOfDestination != _group_id) continue;
+            int nbReceivers = 0;
+            for (auto& slot : slots) {
+                if (!slot->incsat->hasStream() || !slot->incsat->getStream().isIdle()) continue;
+                if (slot->incsat->getStream().getRevision() < 0) continue;
+                slot->incsat->forwardAsyncRedundantClauses(msg.payload);
+                nbReceivers++;
+            }
+            _nb_forwarded_clause_buffers++;
+            LOG(V4_VVER, "CNC XXS forwarded clause buffer of size %lu from [%i] to %i idle streams\n",
+                msg.payload.size(), h.source, nbReceivers);
+        }
+    }
+
+    // Submit a formula together with the slot's cube to the slot's (idle!) SatJobStream.
+    void submitCube(CubeSlot& slot) {
+        auto& incsat = *slot.incsat;
+        slot.startTime = Timer::elapsedSeconds();
+        float budget = _params.cncCubeTimeBudget() * std::pow(_params.cncCubeBudgetGrowth(), slot.cube.nbSplits);
+        slot.deadline.store(budget > 0 && slot.cube.splittable ? slot.startTime + budget : FLT_MAX,
+            std::memory_order_relaxed);
         std::vector<int> formula;
         if (incsat.getStream().getRevision() == -1) formula = _base_formula;
-        incsat.solveNextRevisionNonblocking(std::move(formula), std::vector<int>(cube));
+        incsat.solveNextRevisionNonblocking(std::move(formula), std::vector<int>(slot.cube.lits));
+    }
+
+    // Log a histogram of the runtimes of all cubes, with buckets doubling in width,
+    // and some quantiles to tune the tail latency of the cube solving.
+    void reportCubeRuntimes() {
+        if (_cube_runtimes.empty()) return;
+        std::sort(_cube_runtimes.begin(), _cube_runtimes.end());
+        const float minBucketTime = 0.01;
+        std::vector<int> buckets;
+        for (float time : _cube_runtimes) {
+            size_t b = time <= minBucketTime ? 0 : 1 + (size_t) std::log2(time / minBucketTime);
+            if (b >= buckets.size()) buckets.resize(b+1, 0);
+            buckets[b]++;
+        }
+        std::string hist;
+        for (size_t b = 0; b < buckets.size(); b++) {
+            hist += " <" + std::to_string(minBucketTime * (1 << b)).substr(0, 6) + "s:" + std::to_string(buckets[b]);
+        }
+        auto quantile = [&](float q) {return _cube_runtimes[(size_t) (q * (_cube_runtimes.size()-1))];};
+        LOG(V2_INFO, "CNC %lu cube runs, %i splits; runtimes median=%.3fs p90=%.3fs p99=%.3fs max=%.3fs\n",
+            _cube_runtimes.size(), _nb_split_cubes, quantile(0.5), quantile(0.9), quantile(0.99), _cube_runtimes.back());
+        LOG(V2_INFO, "CNC cube runtime histogram:%s\n", hist.c_str());
+        if (_params.cncShareClauses())
+            LOG(V2_INFO, "CNC %i cross-shared clause buffers received\n", _nb_forwarded_clause_buffers);
     }
 
     // Check whether this job should terminate right now.
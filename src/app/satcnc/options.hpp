@@ -8,3 +8,10 @@
 // memberName                               short option name, long option name          default   min  max
 
 OPTION_GROUP(grpAppSatCnc, "app/satcnc", "SAT solving via CnC options")
+
+OPT_INT(cncCubingDepth, "cnc-depth", "", 10, 1, 30, "Depth of the initial cube generation, i.e., generate up to 2^depth cubes")
+OPT_INT(cncParallelCubingLevels, "cnc-par-levels", "", 2, 0, 10, "Perform the first split levels of lookahead cubing sequentially and continue in parallel for each partial cube (0: fully sequential)")
+OPT_FLOAT(cncCubeTimeBudget, "cnc-cube-budget", "", 0, 0, LARGE_INT, "Seconds after which a cube being solved is interrupted and split further (0: never split cubes)")
+OPT_FLOAT(cncCubeBudgetGrowth, "cnc-cube-budget-growth", "", 2, 1, 100, "Factor by which the time budget of a cube grows with each split")
+OPT_INT(cncSplitDepth, "cnc-split-depth", "", 2, 1, 10, "Depth of the cube generation for splitting a cube that exceeded its budget")
+OPT_BOOL(cncShareClauses, "cnc-share", "", true, "Share learned clauses across the job streams solving the cubes (requires -cjc=1)")
@@ -41,6 +41,12 @@ private:
     volatile bool _simplification_achieved {false};
 
 public:
+    // The arguments of the Satsuma call determine its outcome
+    static constexpr const char* SATSUMA_ARGS = "fix --add-reduced-as-unit";
+    static std::string getSatsumaPath() {
+        return std::string(MALLOB_SUBPROC_DISPATCH_PATH"/satsuma");
+    }
+
     ExtSatsumaCaller(const Parameters& params, const JobDescription& desc, const std::string& name, std::vector<int>&& formula) :
         SatPreprocessActor(params, name, std::move(formula)) {
 
@@ -78,8 +84,7 @@ public:
         _fut_prepro = ProcessWideThreadPool::get().addTask([&]() {
             CoreAllocator::Allocation ca(1);
             std::string cmd = //"cat " + _in_path + " | " + 
-                std::string(MALLOB_SUBPROC_DISPATCH_PATH"/satsuma")
-                + " fix --add-reduced-as-unit --file " + _in_path
+                getSatsumaPath() + " " + SATSUMA_ARGS + " --file " + _in_path
                 + " --out-file " + _out_path
                 + " > " + (_params.logDirectory.isSet() ? (_params.logDirectory() + "/satsuma.txt") : "/dev/null")
                 + " 2>&1 & echo \"$! x\" > " + _pid_path;
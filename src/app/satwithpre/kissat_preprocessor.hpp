@@ -6,6 +6,7 @@
 #include "app/sat/execution/solver_setup.hpp"
 #include "app/sat/solvers/kissat.hpp"
 #include "app/sat/solvers/lingeling.hpp"
+#include "app/satwithpre/preprocessing_cache.hpp"
 #include "app/satwithpre/sat_preprocess_actor.hpp"
 #include "data/job_description.hpp"
 #include "scheduling/core_allocator.hpp"
@@ -20,32 +21,24 @@ class KissatPreprocessor : public SatPreprocessActor {
 
 private:
     std::unique_ptr<Kissat> _kissat;
+    size_t _cached_formula_hash {0};
+    bool _cached_result_rejected {false};
 
 public:
     KissatPreprocessor(const Parameters& params, const JobDescription& desc, const std::string& name, std::vector<int>&& formula) :
         SatPreprocessActor(params, name, std::move(formula)) {}
     ~KissatPreprocessor() {}
 
+    // Kissat is always run with the same fixed setup (see runKissat()),
+    // so its outcome only depends on the Kissat version.
+    static std::string getCacheConfig() {
+        return "kissat-" + Kissat::getVersion() + "-preprocess-seed0";
+    }
+
     void preprocessAsync() override {
         _fut_prepro = ProcessWideThreadPool::get().addTask([&]() {
             CoreAllocator::Allocation ca(1);
-
-            SolverSetup setup;
-            setup.logger = &Logger::getMainInstance();
-            setup.numVars = nbInputVars();
-            setup.numOriginalClauses = nbInputClauses();
-            setup.solverType = 'p';
-            setup.flavour = PortfolioSequence::PREPROCESS;
-            _kissat.reset(new Kissat(setup));
-
-            for (int i = 0; i+2 < _input_cnf.size(); i++) {
-                _kissat->addLiteral(_input_cnf[i]);
-            }
-            _kissat->diversify(0);
-
-            LOG(V2_INFO, "PREPRO running Kissat\n");
-            int res = _kissat->solve(0, nullptr);
-            LOG(V2_INFO, "PREPRO Kissat done, result %i\n", res);
+            int res = runKissat();
             if (res == 10) {
                 _model = _kissat->getSolution();
                 _result = SAT;
@@ -60,7 +53,85 @@ public:
         });
     }
 
+    void adoptCachedResult(PreprocessActorResult result, std::vector<int>&& formula, std::vector<int>&& model) override {
+        _cached_formula_hash = PreprocessingCache::hash(formula);
+        SatPreprocessActor::adoptCachedResult(result, std::move(formula), std::move(model));
+    }
+
+    // If the preprocessed formula was adopted from the cache, this call first replays Kissat's
+    // preprocessing synchronously, which takes about as long as the original preprocessing.
+    // If the replay does not reproduce the cached formula, the input formula is solved instead.
     void reconstructSolution(std::vector<int>& sol) override {
+        if (!_kissat && !replayPreprocessing()) {
+            _cached_result_rejected = true;
+            solveInputFormula(sol);
+            return;
+        }
         _kissat->reconstructSolutionFromPreprocessing(sol);
     }
+
+    bool hasRejectedCachedResult() const override {
+        return _cached_result_rejected;
+    }
+
+private:
+    int runKissat() {
+        SolverSetup setup;
+        setup.logger = &Logger::getMainInstance();
+        setup.numVars = nbInputVars();
+        setup.numOriginalClauses = nbInputClauses();
+        setup.solverType = 'p';
+        setup.flavour = PortfolioSequence::PREPROCESS;
+        _kissat.reset(new Kissat(setup));
+
+        for (int i = 0; i+2 < _input_cnf.size(); i++) {
+            _kissat->addLiteral(_input_cnf[i]);
+        }
+        _kissat->diversify(0);
+
+        LOG(V2_INFO, "PREPRO running Kissat\n");
+        int res = _kissat->solve(0, nullptr);
+        LOG(V2_INFO, "PREPRO Kissat done, result %i\n", res);
+        return res;
+    }
+
+    // The preprocessed formula was adopted from the cache, but Kissat's reconstruction
+    // stack is internal to the solver and cannot be cached. Since Kissat's preprocessing
+    // is deterministic, we rebuild the stack by preprocessing the input formula again.
+    bool replayPreprocessing() {
+        LOG(V3_VERB, "PREPRO %s replaying Kissat for reconstruction\n", getName());
+        CoreAllocator::Allocation ca(1);
+        int res = runKissat();
+        if (res != 0 || !_kissat->hasPreprocessedFormula()
+                || PreprocessingCache::hash(_kissat->extractPreprocessedFormula()) != _cached_formula_hash) {
+            LOG(V1_WARN, "[WARN] %s replayed preprocessing (result %i) does not match cached formula\n", getName(), res);
+            _kissat.reset();
+            return false;
+        }
+        return true;
+    }
+
+    // Fallback if a model cannot be reconstructed: finds a model of the input formula from scratch.
+    void solveInputFormula(std::vector<int>& sol) {
+        LOG(V2_INFO, "PREPRO %s solving input formula with Kissat\n", getName());
+        CoreAllocator::Allocation ca(1);
+        SolverSetup setup;
+        setup.logger = &Logger::getMainInstance();
+        setup.numVars = nbInputVars();
+        setup.numOriginalClauses = nbInputClauses();
+        setup.solverType = 'k';
+        Kissat kissat(setup);
+        for (int i = 0; i+2 < _input_cnf.size(); i++) {
+            kissat.addLiteral(_input_cnf[i]);
+        }
+        kissat.diversify(0);
+        int res = kissat.solve(0, nullptr);
+        if (res != 10) {
+            LOG(V0_CRIT, "[ERROR] %s input formula not solved (result %i)\n", getName(), res);
+            return;
+        }
+        sol = kissat.getSolution();
+        // variables which do not occur in the formula are set to false
+        for (int v = sol.size(); v <= nbInputVars(); v++) sol.push_back(-v);
+    }
 };
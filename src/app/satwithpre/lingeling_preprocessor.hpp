@@ -22,6 +22,12 @@ public:
         SatPreprocessActor(params, name, std::move(formula)) {}
     ~LingelingPreprocessor() {}
 
+    // Lingeling is always run with the same fixed setup,
+    // so its outcome only depends on the Lingeling version.
+    static std::string getCacheConfig() {
+        return "lingeling-" + Lingeling::getVersion() + "-preprocess-seed0";
+    }
+
     void preprocessAsync() override {
         _fut_prepro = ProcessWideThreadPool::get().addTask([&]() {
             CoreAllocator::Allocation ca(1);
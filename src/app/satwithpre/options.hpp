@@ -15,6 +15,8 @@ OPT_FLOAT(preprocessExpansionFactor, "pef", "preprocess-expansion-factor", 1.f,
 OPT_BOOL(preprocessLingeling, "pl", "preprocess-lingeling", true, "Additionally run Lingeling as a preprocessor")
 OPT_STRING(overrideSatOptions, "oso", "override-sat-options", "",
     "In each distributed SAT sub-task, override the SAT solver process configuration with these Mallob options")
+OPT_STRING(preprocessCacheDir, "pcd", "preprocess-cache-dir", "",
+    "Cache preprocessing results for recurring formulas in this (node-local) directory; empty: no caching")
 
 #if MALLOB_USE_SATSUMA
 OPT_BOOL(preprocessSatsuma, "presa", "preprocess-satsuma", false, "Run Satsuma instead of kissat")
@@ -0,0 +1,155 @@
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+#include <unistd.h>
+
+#include "app/satwithpre/sat_preprocess_actor.hpp"
+#include "data/checksum.hpp"
+#include "util/hashing.hpp"
+#include "util/logger.hpp"
+#include "util/sys/fileutils.hpp"
+#include "util/sys/proc.hpp"
+
+// Cache of preprocessing outcomes on node-local disk, such that recurring formulas
+// (e.g., from parameter sweeps) do not need to be preprocessed again. An entry is keyed
+// by a hash of the formula a preprocessor was run on together with a description of the
+// preprocessor, its version and its configuration. It contains the size and a checksum of
+// the input formula, which are compared on loading, the preprocessor's result, the
+// preprocessed formula (if any) and the model found (if any). Entries are written to a
+// temporary file first and then renamed, so concurrent processes never see partial entries.
+class PreprocessingCache {
+
+public:
+    struct Entry {
+        size_t inputSize {0}; // size of the formula the preprocessor was run on
+        Checksum inputChecksum; // checksum of this formula
+        SatPreprocessActor::PreprocessActorResult result;
+        std::vector<int> formula; // preprocessed formula, followed by #vars and #clauses
+        std::vector<int> model;
+    };
+
+private:
+    static constexpr int FORMAT_VERSION = 2;
+    std::string _dir;
+
+public:
+    PreprocessingCache(const std::string& dir) : _dir(dir) {
+        FileUtils::mkdir(_dir);
+    }
+
+    static size_t hash(const std::vector<int>& data, size_t seed = 1) {
+        size_t h = seed;
+        hash_combine(h, data.size());
+        for (int x : data) hash_combine(h, x);
+        return h;
+    }
+
+    static Checksum getChecksum(const std::vector<int>& data) {
+        Checksum chk;
+        for (int x : data) chk.combine(x);
+        return chk;
+    }
+
+    // Identifies the given file (e.g., a binary) by its size and modification time.
+    static std::string getFileIdentity(const std::string& path) {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) return "none";
+        return std::to_string(st.st_size) + "-" + std::to_string(st.st_mtime);
+    }
+
+    std::string getKey(const std::vector<int>& inputCnf, const std::string& config) const {
+        char buf[32];
+        snprintf(buf, 32, "%016lx", hash(inputCnf));
+        std::string key = std::string(buf) + "." + config;
+        for (char& c : key) if (c == '/' || c == ' ') c = '_';
+        return key;
+    }
+
+    // Loads the entry of the given key if it exists, is well-formed, and
+    // was computed on an input formula of the given size and checksum.
+    bool tryLoad(const std::string& key, size_t inputSize, const Checksum& inputChecksum, Entry& entry) const {
+        FILE* f = fopen(getPath(key).c_str(), "r");
+        if (!f) return false;
+        size_t remainingBytes = 0;
+        if (fseek(f, 0, SEEK_END) == 0) {
+            long fileSize = ftell(f);
+            if (fileSize > 0) remainingBytes = fileSize;
+            rewind(f);
+        }
+        int header[2];
+        size_t inputInfo[3];
+        bool ok = readData(f, header, 2, remainingBytes) && header[0] == FORMAT_VERSION
+            && readData(f, inputInfo, 3, remainingBytes);
+        if (ok) {
+            entry.inputSize = inputInfo[0];
+            entry.inputChecksum = Checksum(inputInfo[1], inputInfo[2]);
+            entry.result = (SatPreprocessActor::PreprocessActorResult) header[1];
+            ok = readVector(f, entry.formula, remainingBytes) && readVector(f, entry.model, remainingBytes)
+                && remainingBytes == 0;
+        }
+        fclose(f);
+        if (!ok) {
+            LOG(V1_WARN, "[WARN] SATWP Discarding malformed cache entry %s\n", key.c_str());
+            return false;
+        }
+        if (entry.inputSize != inputSize || entry.inputChecksum != inputChecksum) {
+            LOG(V1_WARN, "[WARN] SATWP Cache entry %s belongs to another formula - ignoring it\n", key.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void store(const std::string& key, const Entry& entry) const {
+        const std::string path = getPath(key);
+        const std::string tmpPath = path + ".tmp." + std::to_string(Proc::getPid())
+            + "." + std::to_string(Proc::getTid());
+        FILE* f = fopen(tmpPath.c_str(), "w");
+        if (!f) {
+            LOG(V1_WARN, "[WARN] SATWP Cannot write cache entry %s\n", tmpPath.c_str());
+            return;
+        }
+        int header[2] {FORMAT_VERSION, (int) entry.result};
+        size_t inputInfo[3] {entry.inputSize, entry.inputChecksum.count(), entry.inputChecksum.get()};
+        bool ok = fwrite(header, sizeof(int), 2, f) == 2 && fwrite(inputInfo, sizeof(size_t), 3, f) == 3
+            && writeVector(f, entry.formula) && writeVector(f, entry.model);
+        ok = (fclose(f) == 0) && ok;
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+            LOG(V1_WARN, "[WARN] SATWP Failed to write cache entry %s\n", path.c_str());
+            FileUtils::rm(tmpPath);
+        }
+    }
+
+    void remove(const std::string& key) const {
+        FileUtils::rm(getPath(key));
+    }
+
+    std::string getPath(const std::string& key) const {
+        return _dir + "/" + key + ".ppc";
+    }
+
+private:
+    template <typename T>
+    static bool readData(FILE* f, T* data, size_t nbElems, size_t& remainingBytes) {
+        if (nbElems > remainingBytes / sizeof(T)) return false;
+        if (fread(data, sizeof(T), nbElems, f) != nbElems) return false;
+        remainingBytes -= nbElems * sizeof(T);
+        return true;
+    }
+    static bool readVector(FILE* f, std::vector<int>& vec, size_t& remainingBytes) {
+        size_t size;
+        if (!readData(f, &size, 1, remainingBytes)) return false;
+        // reject sizes beyond the end of the file before allocating anything
+        if (size > remainingBytes / sizeof(int)) return false;
+        vec.resize(size);
+        return readData(f, vec.data(), size, remainingBytes);
+    }
+    static bool writeVector(FILE* f, const std::vector<int>& vec) {
+        size_t size = vec.size();
+        return fwrite(&size, sizeof(size_t), 1, f) == 1
+            && fwrite(vec.data(), sizeof(int), size, f) == size;
+    }
+};
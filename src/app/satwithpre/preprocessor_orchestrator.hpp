@@ -5,12 +5,15 @@
 #include "app/satwithpre/kissat_preprocessor.hpp"
 #include "app/satwithpre/lingeling_preprocessor.hpp"
 #include "app/satwithpre/mallobsat_preprocess_actor.hpp"
+#include "app/satwithpre/preprocessing_cache.hpp"
 #include "app/satwithpre/sat_preprocess_actor.hpp"
 #include "app/satwithpre/satsuma_preprocessor.hpp"
 #include "data/job_description.hpp"
 #include "interface/api/api_connector.hpp"
 #include "util/logger.hpp"
 #include "util/params.hpp"
+#include "util/sys/thread_pool.hpp"
+#include <future>
 #include <list>
 
 class PreprocessorOrchestrator {
@@ -32,6 +35,10 @@ private:
         std::vector<int> formula;
         std::vector<int> model;
         float timeOfSignalledDisplacement {0};
+        std::string cacheKey; // non-empty iff the actor's outcome is cacheable
+        size_t cacheInputSize {0};
+        Checksum cacheInputChecksum;
+        bool fromCache {false};
     };
     std::list<ActorContext> _actors;
     const std::vector<int> _base_cnf;
@@ -39,11 +46,16 @@ private:
     float _time_of_start;
     ActorContext* _winning_actor {nullptr};
 
+    std::unique_ptr<PreprocessingCache> _cache;
+    std::list<std::future<void>> _cache_writes;
+
 public:
     PreprocessorOrchestrator(const Parameters& params, const JobDescription& desc, APIConnector& api) : _params(params), _desc(desc), _api(api),
             _base_cnf(getCnfFromJobDescription()) {
 
         _time_of_start = Timer::elapsedSeconds();
+        if (_params.preprocessCacheDir.isSet())
+            _cache.reset(new PreprocessingCache(_params.preprocessCacheDir()));
 
         // Mallob on original instance
         _actors.push_back({PreprocessorOrchestrator::ActorContext::MALLOBSAT, nullptr});
@@ -109,8 +121,16 @@ public:
                     actor.actor.reset(new MallobSatPreprocessActor(_params, _desc, std::to_string(actorIdx) + ":MallobSat", _api, std::move(formula), _time_of_start));
                     break;
                 }
-                LOG(V2_INFO, "SATWP launch %s\n", actor.actor->getName());
-                actor.actor->preprocessAsync();
+                if (_cache && actor.type != ActorContext::MALLOBSAT) {
+                    actor.cacheKey = _cache->getKey(actor.actor->getInputCnf(), getCacheConfig(actor.type));
+                    actor.cacheInputSize = actor.actor->getInputCnf().size();
+                    actor.cacheInputChecksum = PreprocessingCache::getChecksum(actor.actor->getInputCnf());
+                    actor.fromCache = tryAdoptCachedResult(actor);
+                }
+                if (!actor.fromCache) {
+                    LOG(V2_INFO, "SATWP launch %s\n", actor.actor->getName());
+                    actor.actor->preprocessAsync();
+                }
                 actor.state = ActorContext::RUNNING;
 
                 // signal displacement to actors being displaced
@@ -143,6 +163,8 @@ public:
                 assert(actor.formula[actor.formula.size() - 1] >= 0); // # clauses
                 actor.result = res;
                 actor.state = ActorContext::FINISHED;
+                if (!actor.cacheKey.empty() && !actor.fromCache && res != SatPreprocessActor::ERROR)
+                    storeInCache(actor);
                 if (res == SatPreprocessActor::SAT) {
                     LOG(V2_INFO, "SATWP %s found SAT\n", actor.actor->getName());
                     _winning_actor = &actor;
@@ -183,6 +205,10 @@ public:
             actor = actor->prerequisite;
             if (!actor) break;
             actor->actor->reconstructSolution(model);
+            if (actor->fromCache && actor->actor->hasRejectedCachedResult()) {
+                LOG(V1_WARN, "[WARN] SATWP %s discarding rejected cache entry\n", actor->actor->getName());
+                _cache->remove(actor->cacheKey);
+            }
         }
         return model;
     }
@@ -194,7 +220,69 @@ public:
         }
     }
 
+    ~PreprocessorOrchestrator() {
+        for (auto& fut : _cache_writes) fut.get();
+    }
+
 private:
+    // Identifies a preprocessor together with its version and configuration. Preprocessors
+    // linked into Mallob are additionally identified by Mallob's binary, so that entries
+    // of another build are never adopted.
+    std::string getCacheConfig(ActorContext::ActorType type) const {
+        const std::string build = PreprocessingCache::getFileIdentity("/proc/self/exe");
+        switch (type) {
+        case ActorContext::SATSUMA_INT: return "satsuma-int-" + build;
+        case ActorContext::SATSUMA_EXT: return std::string("satsuma-ext-") + ExtSatsumaCaller::SATSUMA_ARGS
+            + "-" + PreprocessingCache::getFileIdentity(ExtSatsumaCaller::getSatsumaPath());
+        case ActorContext::KISSAT: return KissatPreprocessor::getCacheConfig() + "-" + build;
+        case ActorContext::LINGELING: return LingelingPreprocessor::getCacheConfig() + "-" + build;
+        default: return "";
+        }
+    }
+
+    bool tryAdoptCachedResult(ActorContext& actor) {
+        PreprocessingCache::Entry entry;
+        if (!_cache->tryLoad(actor.cacheKey, actor.cacheInputSize, actor.cacheInputChecksum, entry)) return false;
+        if (entry.result == SatPreprocessActor::SAT && !isModelOf(entry.model, actor.actor->getInputCnf())) {
+            LOG(V1_WARN, "[WARN] SATWP %s cached model is invalid - discarding cache entry\n", actor.actor->getName());
+            _cache->remove(actor.cacheKey);
+            return false;
+        }
+        LOG(V2_INFO, "SATWP %s adopt cached result\n", actor.actor->getName());
+        actor.actor->adoptCachedResult(entry.result, std::move(entry.formula), std::move(entry.model));
+        return true;
+    }
+
+    void storeInCache(const ActorContext& actor) {
+        if (actor.result == SatPreprocessActor::SAT && actor.model.empty()) return; // nothing to reuse
+        // copy the data since the actor's formula may still be handed to other actors
+        auto entry = std::make_shared<PreprocessingCache::Entry>();
+        entry->inputSize = actor.cacheInputSize;
+        entry->inputChecksum = actor.cacheInputChecksum;
+        entry->result = actor.result;
+        if (actor.result == SatPreprocessActor::SIMPLIFIED) entry->formula = actor.formula;
+        if (actor.result == SatPreprocessActor::SAT) entry->model = actor.model;
+        auto key = actor.cacheKey;
+        _cache_writes.push_back(ProcessWideThreadPool::get().addTask([&, key, entry]() {
+            _cache->store(key, *entry);
+        }));
+    }
+
+    static bool isModelOf(const std::vector<int>& model, const std::vector<int>& cnf) {
+        bool clauseSatisfied = false;
+        for (size_t i = 0; i+2 < cnf.size(); i++) {
+            int lit = cnf[i];
+            if (lit == 0) {
+                if (!clauseSatisfied) return false;
+                clauseSatisfied = false;
+                continue;
+            }
+            int var = std::abs(lit);
+            if (var < model.size() && model[var] == lit) clauseSatisfied = true;
+        }
+        return true;
+    }
+
     std::vector<int> getCnfFromJobDescription() {
 
         SerializedFormulaParser parser(Logger::getMainInstance(), _desc.getFormulaPayload(0),
@@ -33,9 +33,19 @@ public:
         return std::move(_model);
     }
 
+    // Adopt the outcome of an earlier run on the same input formula
+    // instead of preprocessing (again). Replaces a call to preprocessAsync().
+    virtual void adoptCachedResult(PreprocessActorResult result, std::vector<int>&& formula, std::vector<int>&& model) {
+        _output_cnf = std::move(formula);
+        _model = std::move(model);
+        _result = result;
+    }
+
     virtual void interrupt() {}
     virtual void join() {if (_fut_prepro.valid()) _fut_prepro.get();}
     virtual void reconstructSolution(std::vector<int>& sol) = 0;
+    // Whether reconstructing a solution revealed that the adopted cached result is unusable
+    virtual bool hasRejectedCachedResult() const {return false;}
 
     int nbInputVars() const {
         assert(_input_cnf.size() >= 2);
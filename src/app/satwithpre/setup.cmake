@@ -59,5 +59,5 @@ else()
 endif()
 
 # Add unit tests: for each $arg there must be a standalone cpp file under "test/test_${arg}.cpp".
-# ...
+new_test(preprocessing_cache "${BASE_INCLUDES}" mallob_core)
 
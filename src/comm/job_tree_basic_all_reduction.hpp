@@ -50,6 +50,9 @@ private:
     bool _has_transformation_at_root = false;
     std::function<AllReduceElement(const AllReduceElement&)> _transformation_at_root;
 
+    bool _has_transformation_before_sending = false;
+    std::function<AllReduceElement(AllReduceElement&&)> _transformation_before_sending;
+
     bool _has_contributed = false;
     bool _reduction_locally_done = false;
     bool _finished = false;
@@ -111,6 +114,13 @@ public:
         _has_transformation_at_root = true;
     }
 
+    // Set a function which transforms the aggregated element at a non-root node
+    // right before it is sent to the parent (not applied to neutral elements sent on cancellation).
+    void setTransformationBeforeSending(std::function<AllReduceElement(AllReduceElement&&)> transformation) {
+        _transformation_before_sending = transformation;
+        _has_transformation_before_sending = true;
+    }
+
     void enableBroadcast() {
         _broadcast_enabled = true;
     }
@@ -194,7 +204,9 @@ public:
                 }
             } else {
                 // Send to parent
-                _base_msg.payload = std::move(_aggregated_elem.value());
+                _base_msg.payload = _has_transformation_before_sending ?
+                    _transformation_before_sending(std::move(_aggregated_elem.value())) :
+                    std::move(_aggregated_elem.value());
                 _base_msg.treeIndexOfDestination = _parent_index;
                 _base_msg.contextIdOfDestination = _parent_ctx_id;
                 MyMpi::isend(_parent_rank, MSG_JOB_TREE_REDUCTION, _base_msg);
@@ -223,6 +235,10 @@ public:
     bool hasProducer() const {return _has_contributed;}
     bool isValid() const {return _valid;}
 
+    // Whether the local aggregation is complete, i.e., the aggregated element
+    // has been sent upwards (or has been received as the final element at the root).
+    bool isReductionLocallyDone() const {return _reduction_locally_done;}
+
     // Whether the final result to the all-reduction is present.
     bool hasResult() const {return _finished && _valid;}
     
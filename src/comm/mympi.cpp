@@ -17,6 +17,7 @@
 
 
 MessageQueue* MyMpi::_msg_queue;
+std::vector<int> MyMpi::_host_of_rank;
 
 void MyMpi::init() {
     int provided = -1;
@@ -33,6 +34,23 @@ void MyMpi::setOptions(const Parameters& params) {
     _msg_queue = new MessageQueue(params.messageBatchingThreshold());
 }
 
+void MyMpi::initHostLocality() {
+    // Identify each host by the smallest world rank residing on it
+    MPI_Comm hostComm;
+    int myRank = rank(MPI_COMM_WORLD);
+    MPICALL(MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, myRank, MPI_INFO_NULL, &hostComm), std::string("splitType"))
+    int hostId;
+    MPICALL(MPI_Allreduce(&myRank, &hostId, 1, MPI_INT, MPI_MIN, hostComm), std::string("allreduce"))
+    MPI_Comm_free(&hostComm);
+    _host_of_rank.resize(size(MPI_COMM_WORLD));
+    MPICALL(MPI_Allgather(&hostId, 1, MPI_INT, _host_of_rank.data(), 1, MPI_INT, MPI_COMM_WORLD), std::string("allgather"))
+}
+
+bool MyMpi::isOnSameHost(int worldRank) {
+    if (worldRank < 0 || worldRank >= (int) _host_of_rank.size()) return false;
+    return _host_of_rank[worldRank] == _host_of_rank[rank(MPI_COMM_WORLD)];
+}
+
 int MyMpi::isend(int recvRank, int tag, const Serializable& object, bool fromMainThread) {
     return _msg_queue->send(DataPtr(new std::vector<uint8_t>(object.serialize())), recvRank, tag, fromMainThread);
 }
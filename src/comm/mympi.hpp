@@ -25,9 +25,13 @@ public:
     static ConcurrentAllocator<RecvBundle> _alloc;
     */
     static MessageQueue* _msg_queue;
+    static std::vector<int> _host_of_rank;
 
     static void init();
     static void setOptions(const Parameters& params);
+    // Collective operation: determine which ranks of MPI_COMM_WORLD share a host.
+    static void initHostLocality();
+    static bool isOnSameHost(int worldRank);
 
     static int isend(int recvRank, int tag, const Serializable& object, bool fromMainThread = true);
     static int isend(int recvRank, int tag, std::vector<uint8_t>&& object, bool fromMainThread = true);
@@ -1293,9 +1293,17 @@ void SchedulingManager::tryAdoptPendingRootActivationRequest() {
 
 void SchedulingManager::forgetOldJobs() {
     _reactivation_scheduler.forgetInactives();
-    auto jobsToForget = _job_registry.findJobsToForget();
-    // Perform forgetting of jobs
-    for (int jobId : jobsToForget) eraseJobAndQueueForDeletion(get(jobId));
+    forgetJobs(_job_registry.findJobsToForget());
+}
+
+void SchedulingManager::forgetJobs(const std::vector<int>& jobIds) {
+    for (int jobId : jobIds) {
+        Job& job = get(jobId);
+        // A suspended job node may be started again later: preempt it,
+        // which lets it write a checkpoint (if enabled) before it terminates
+        if (job.getState() == SUSPENDED) job.appl_preempt();
+        eraseJobAndQueueForDeletion(job);
+    }
 }
 
 void SchedulingManager::eraseJobAndQueueForDeletion(Job& job) {
@@ -1324,10 +1332,16 @@ int SchedulingManager::getGlobalBalancingEpoch() const {
 }
 
 void SchedulingManager::triggerMemoryPanic() {
-    // Aggressively remove inactive cached jobs
+    // Aggressively remove cached jobs, including all eligible suspended job nodes.
+    // The frozen processes of suspended nodes still hold their memory; each of them
+    // is preempted and thus writes a checkpoint (if enabled) before it terminates.
+    _reactivation_scheduler.forgetInactives();
     _job_registry.setMemoryPanic(true);
-    forgetOldJobs();
+    auto jobsToForget = _job_registry.findJobsToForget();
     _job_registry.setMemoryPanic(false);
+    if (!jobsToForget.empty())
+        LOG(V3_VERB, "memory panic: dropping %lu cached job nodes\n", jobsToForget.size());
+    forgetJobs(jobsToForget);
     // Trigger memory panic in the active job
     if (_job_registry.hasActiveJob()) _job_registry.getActive().appl_memoryPanic();
 }
@@ -108,6 +108,7 @@ private:
     void resume(Job& job, const JobRequest& req, int source);
     void suspend(Job& job);
     void terminate(Job& job);
+    void forgetJobs(const std::vector<int>& jobIds);
     void eraseJobAndQueueForDeletion(Job& job);
 
     void preregisterJobInBalancer(Job& job);
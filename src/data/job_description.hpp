@@ -144,6 +144,15 @@ public:
         _f_size++;
         if (_use_checksums) _checksum.combine(data);
     }
+    // Appends a contiguous array of values to the raw data with a single copy
+    inline void addData(const float* data, size_t size) {
+        auto& vec = _data_per_revision[_revision];
+        const size_t offset = vec->size();
+        vec->resize(offset + size*sizeof(float));
+        memcpy(vec->data()+offset, data, size*sizeof(float));
+        _f_size += size;
+        if (_use_checksums) for (size_t i = 0; i < size; i++) _checksum.combine(data[i]);
+    }
     void setFSize(int fSize) {_f_size = fSize;}
     void endInitialization();
     void writeMetadata();
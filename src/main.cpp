@@ -9,6 +9,7 @@
 #include <exception>
 #include <initializer_list>
 #include <list>
+#include <random>
 #include <memory>
 #include <thread>
 #include <vector>
@@ -232,6 +233,7 @@ int main(int argc, char *argv[]) {
     longStartupWarnMsg(rank, "Init'd logger");
 
     MyMpi::setOptions(params);
+    if (params.hostLocalClauseAggregation()) MyMpi::initHostLocality();
 
     longStartupWarnMsg(rank, "Init'd message queue");
 
@@ -254,6 +256,14 @@ int main(int argc, char *argv[]) {
     // as well as to an individual randomness that differs among nodes
     Random::init(numNodes+params.seed(), rank+params.seed());
 
+    // Nonce shared by all processes of this run (and passed on to subprocesses via the options)
+    if (params.runNonce() == 0) {
+        int nonce = 0;
+        if (rank == 0) nonce = 1 + std::random_device()() % (MAX_INT-1);
+        MPI_Bcast(&nonce, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        params.runNonce.set(nonce);
+    }
+
     // Perform pre-execution cleanup of any previous runs
     if (params.preCleanup()) {
         LOG(V2_INFO, "Cleaning up pre-execution\n");
@@ -32,6 +32,7 @@ OPTION_GROUP(grpGeneral, "general", "General")
  OPT_INT(numJobs,                         "J", "jobs",                                 0,    0, LARGE_INT,      "Exit as soon as this number of jobs has been processed (set to 1 if -mono is used)")
  OPT_INT(numSuccessfulJobs,               "SJ", "successful-jobs",                     0,    0, LARGE_INT,      "Exit as soon as this number of jobs has been processed SUCCESSFULLY (i.e., not cancelled / aborted)")
  OPT_INT(seed,                            "seed", "",                                  0,    0, MAX_INT,        "Random seed")
+ OPT_INT(runNonce,                        "run-nonce", "",                             0,    0, MAX_INT,        "Nonce identifying this run, e.g., to recognize files left behind by other runs (0: draw at random)")
  OPT_FLOAT(timeLimit,                     "T", "time-limit",                           0,    0, LARGE_INT,      "Run entire system for at most this many seconds")
  OPT_BOOL(warmup,                         "warmup", "",                                false,                   "Do one explicit All-To-All warmup among all nodes in the beginning")
  OPT_INT(numClients,                      "c", "clients",                              1,    -1, LARGE_INT,     "Number of client PEs to initialize (counting backwards from last rank). -1: all PEs are clients")
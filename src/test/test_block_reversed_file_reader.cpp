@@ -0,0 +1,105 @@
+
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/block_reversed_file_reader.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+
+const std::string path = "test_block_reversed_file.bin";
+
+// Writes the given blocks to the file in reverse order and returns the block sizes
+// in file order, such that reading the blocks in reverse yields the original sequence.
+std::vector<size_t> writeBlocksReversed(const std::vector<std::string>& blocks) {
+    FILE* f = fopen(path.c_str(), "wb");
+    assert(f);
+    std::vector<size_t> sizes;
+    for (auto it = blocks.rbegin(); it != blocks.rend(); ++it) {
+        fwrite(it->data(), 1, it->size(), f);
+        sizes.push_back(it->size());
+    }
+    fclose(f);
+    return sizes;
+}
+
+std::vector<std::string> getRandomBlocks(int nbBlocks) {
+    std::vector<std::string> blocks;
+    for (int b = 0; b < nbBlocks; b++) {
+        // include some empty blocks
+        int size = Random::rand() < 0.2 ? 0 : (int) (Random::rand() * 10'000);
+        std::string block;
+        for (int i = 0; i < size; i++) block += (char) ('a' + (int) (Random::rand() * 26));
+        blocks.push_back(block);
+    }
+    return blocks;
+}
+
+void testCharacterwise() {
+    auto blocks = getRandomBlocks(50);
+    std::string expected;
+    for (auto& block : blocks) expected += block;
+    auto sizes = writeBlocksReversed(blocks);
+
+    BlockReversedFileReader reader(path, sizes);
+    assert(reader.valid());
+    std::string out;
+    char c;
+    while (reader.next(c)) out += c;
+    assert(reader.valid());
+    assert(reader.endOfFile());
+    assert(out == expected);
+    remove(path.c_str());
+    LOG(V2_INFO, "Read %lu chars characterwise\n", out.size());
+}
+
+void testBlockwise() {
+    auto blocks = getRandomBlocks(50);
+    auto sizes = writeBlocksReversed(blocks);
+
+    BlockReversedFileReader reader(path, sizes);
+    const char* data;
+    size_t size;
+    size_t b = 0;
+    while (reader.nextBlock(data, size)) {
+        while (blocks[b].empty()) b++; // empty blocks are skipped
+        assert(std::string(data, size) == blocks[b]);
+        b++;
+    }
+    while (b < blocks.size() && blocks[b].empty()) b++;
+    assert(b == blocks.size());
+    remove(path.c_str());
+    LOG(V2_INFO, "Read %lu blocks blockwise\n", blocks.size());
+}
+
+void testTruncatedFile() {
+    auto blocks = getRandomBlocks(10);
+    blocks[0] = "first"; // ensure that the last block in the file is non-empty
+    auto sizes = writeBlocksReversed(blocks);
+    size_t total = 0;
+    for (size_t size : sizes) total += size;
+    assert(truncate(path.c_str(), total-1) == 0);
+
+    BlockReversedFileReader reader(path, sizes);
+    char c;
+    while (reader.next(c)) {}
+    assert(!reader.valid());
+    remove(path.c_str());
+
+    BlockReversedFileReader missing(path, sizes);
+    assert(!missing.valid());
+    LOG(V2_INFO, "Truncated and missing file rejected\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    testCharacterwise();
+    testBlockwise();
+    testTruncatedFile();
+}
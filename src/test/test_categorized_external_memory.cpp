@@ -58,6 +58,30 @@ void testBasic() {
     }
 }
 
+void testFetchWithoutRemoval() {
+    auto blocksize = 4096;
+    CategorizedExternalMemory<int> ext("test.bin", blocksize);
+
+    // spans several blocks, the last of which is still in memory
+    for (int i = 0; i < 3000; i++) ext.add(2, i);
+    ext.add(5, -1);
+
+    for (int rep = 0; rep < 2; rep++) {
+        std::vector<int> data;
+        ext.fetch(2, data);
+        assert(data.size() == 3000);
+        for (int i = 0; i < 3000; i++) assert(data[i] == i);
+        assert(ext.size() == 3001);
+    }
+
+    std::vector<int> data;
+    ext.fetchAndRemove(2, data);
+    assert(data.size() == 3000);
+    data.clear(); ext.fetch(2, data); assert(data.empty());
+    ext.fetch(5, data);
+    assert(data.size() == 1 && data[0] == -1);
+}
+
 void testPerformance() {
     
     {
@@ -133,6 +157,7 @@ int main() {
     Timer::init();
 
     testBasic();
+    testFetchWithoutRemoval();
     testPerformance();
     testBuckets();
 }
@@ -0,0 +1,80 @@
+
+#include <cstdio>
+#include <vector>
+
+#include "app/sat/sharing/clause_logger.hpp"
+#include "app/sat/sharing/clause_log_format.hpp"
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+
+void testRoundtrip() {
+    const std::string path = "test_clause_log.bin";
+    const int nbEpochs = 50;
+    const int firstEpoch = 7; // logged epochs are the sharing epochs passed to publish()
+    std::vector<std::vector<std::vector<int>>> epochs(nbEpochs);
+    {
+        ClauseLogger logger(path);
+        for (int e = 0; e < nbEpochs; e++) {
+            int nbClauses = (int) (Random::rand() * 1000);
+            for (int c = 0; c < nbClauses; c++) {
+                std::vector<int> lits;
+                int size = 1 + (int) (Random::rand() * 30);
+                for (int i = 0; i < size; i++) {
+                    int var = 1 + (int) (Random::rand() * 1'000'000);
+                    lits.push_back(Random::rand() < 0.5 ? -var : var);
+                }
+                Mallob::Clause cls(lits.data(), lits.size(), std::min(size, 2 + c % 5));
+                logger.append(cls);
+                epochs[e].push_back(lits);
+                epochs[e].back().push_back(cls.lbd);
+            }
+            logger.publish(firstEpoch + 2*e);
+        }
+    }
+
+    FILE* f = fopen(path.c_str(), "rb");
+    assert(f);
+    int nbMetadataInts;
+    assert(ClauseLogFormat::readFileHeader(f, nbMetadataInts));
+    assert(nbMetadataInts == 0);
+    ClauseLogFormat::BlockHeader header;
+    std::vector<ClauseLogFormat::Clause> clauses;
+    int e = 0;
+    while (ClauseLogFormat::readBlock(f, nbMetadataInts, header, clauses)) {
+        assert(header.epoch == firstEpoch + 2*e);
+        assert(clauses.size() == epochs[e].size());
+        for (size_t c = 0; c < clauses.size(); c++) {
+            auto expected = epochs[e][c];
+            assert(clauses[c].lbd == expected.back());
+            expected.pop_back();
+            assert(clauses[c].lits == expected);
+        }
+        e++;
+    }
+    assert(e == nbEpochs);
+    fclose(f);
+    remove(path.c_str());
+    LOG(V2_INFO, "Roundtrip of %i epochs successful\n", nbEpochs);
+}
+
+void testUnopenableLog() {
+    // A logger without an output file must silently ignore all clauses
+    ClauseLogger logger("/nonexistent_dir/test_clause_log.bin");
+    std::vector<int> lits {1, -2, 3};
+    for (int e = 0; e < 10; e++) {
+        logger.append(Mallob::Clause(lits.data(), lits.size(), 2));
+        logger.publish(e);
+    }
+    assert(logger.getNbSkippedEpochs() == 0);
+    LOG(V2_INFO, "Unopenable log ignored\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+    testRoundtrip();
+    testUnopenableLog();
+}
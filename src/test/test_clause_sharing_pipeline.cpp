@@ -0,0 +1,174 @@
+
+#include <memory>
+#include <vector>
+
+#include "app/sat/job/clause_sharing_pipeline.hpp"
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+
+// Stand-in for a ClauseSharingSession whose stages are controlled by the test:
+// the aggregation concludes once "aggregated" is set, and the session is done
+// once "resultArrived" is set and its digestion is not deferred.
+struct FakeSession {
+    int epoch;
+    std::vector<int>* digestedEpochs;
+    bool aggregated {false};
+    bool resultArrived {false};
+    bool digestionDeferred {false};
+    bool digested {false};
+
+    FakeSession(int epoch, std::vector<int>* digestedEpochs) : epoch(epoch), digestedEpochs(digestedEpochs) {}
+
+    void setDigestionDeferred(bool deferred) {digestionDeferred = deferred;}
+    void advanceSharing() {
+        if (digested || !resultArrived || digestionDeferred) return;
+        digested = true;
+        digestedEpochs->push_back(epoch);
+    }
+    bool hasConcludedClauseAggregation() const {return aggregated;}
+    bool isDone() const {return digested;}
+};
+
+typedef ClauseSharingPipeline<FakeSession> Pipeline;
+
+// Begins a new epoch, like AnytimeSatClauseCommunicator::initiateClauseSharing does
+FakeSession* begin(Pipeline& pipeline, int& epoch, std::vector<int>& digestedEpochs, int& nbLimitsUpdates) {
+    assert(pipeline.canBeginNext());
+    if (pipeline.shouldUpdateSharingLimits()) nbLimitsUpdates++;
+    auto session = new FakeSession(epoch++, &digestedEpochs);
+    pipeline.add(session);
+    return session;
+}
+
+void testWithoutPipelining() {
+    Pipeline pipeline(1);
+    std::vector<int> digestedEpochs, concludedEpochs;
+    int epoch = 0, nbLimitsUpdates = 0;
+    auto onConcluded = [&](std::unique_ptr<FakeSession>&& s) {concludedEpochs.push_back(s->epoch);};
+
+    for (int i = 0; i < 3; i++) {
+        auto session = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+        assert(!session->digestionDeferred);
+        // No new epoch before the previous one is done, even if its aggregation concluded
+        session->aggregated = true;
+        pipeline.advance(onConcluded);
+        assert(!pipeline.canBeginNext());
+        session->resultArrived = true;
+        pipeline.advance(onConcluded);
+        assert(pipeline.empty());
+        assert(pipeline.canBeginNext());
+    }
+    assert(concludedEpochs == std::vector<int>({0, 1, 2}));
+    assert(digestedEpochs == concludedEpochs);
+    // Each epoch updates the limits from the results of the previous epoch
+    assert(nbLimitsUpdates == 3);
+    LOG(V2_INFO, "Sessions without pipelining processed one by one\n");
+}
+
+void testPipelining() {
+    const int depth = 3;
+    Pipeline pipeline(depth);
+    std::vector<int> digestedEpochs, concludedEpochs;
+    int epoch = 0, nbLimitsUpdates = 0;
+    auto onConcluded = [&](std::unique_ptr<FakeSession>&& s) {concludedEpochs.push_back(s->epoch);};
+
+    // A new epoch can only begin once the latest epoch's aggregation concluded
+    auto s0 = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+    assert(!s0->digestionDeferred);
+    pipeline.advance(onConcluded);
+    assert(!pipeline.canBeginNext());
+    s0->aggregated = true;
+    assert(pipeline.canBeginNext());
+    auto s1 = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+    assert(s1->digestionDeferred);
+    s1->aggregated = true;
+    auto s2 = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+    assert(s2->digestionDeferred);
+    s2->aggregated = true;
+    // At most "depth" sessions in flight
+    assert(pipeline.size() == depth);
+    assert(!pipeline.canBeginNext() || log_return_false("[ERROR] more than %i sessions in flight\n", depth));
+    // No epoch has been digested yet: the limits of epoch 0 must be re-used
+    assert(nbLimitsUpdates == 1 || log_return_false("[ERROR] %i limits updates\n", nbLimitsUpdates));
+
+    // Later results arrive first: they must not be digested before epoch 0
+    s2->resultArrived = true;
+    s1->resultArrived = true;
+    pipeline.advance(onConcluded);
+    assert(concludedEpochs.empty());
+    assert(digestedEpochs.empty() || log_return_false("[ERROR] epoch %i digested before epoch 0\n", digestedEpochs[0]));
+    assert(pipeline.size() == depth);
+
+    // Epoch 0 concludes, and the waiting epochs follow in order
+    s0->resultArrived = true;
+    pipeline.advance(onConcluded);
+    assert(concludedEpochs == std::vector<int>({0, 1, 2}));
+    assert(digestedEpochs == concludedEpochs);
+    assert(pipeline.empty());
+
+    // The next epoch updates the limits (once) from the digested results
+    auto s3 = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+    assert(nbLimitsUpdates == 2);
+    assert(!s3->digestionDeferred);
+
+    // Epochs conclude one after another while the pipeline stays full
+    s3->aggregated = true;
+    auto s4 = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+    assert(nbLimitsUpdates == 2);
+    s3->resultArrived = true;
+    pipeline.advance(onConcluded);
+    assert(concludedEpochs.back() == 3);
+    assert(!s4->digestionDeferred);
+    assert(!pipeline.canBeginNext()); // epoch 4 still aggregating
+    s4->aggregated = true;
+    auto s5 = begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+    assert(nbLimitsUpdates == 3);
+    assert(s5->digestionDeferred);
+    s5->resultArrived = true;
+    s4->resultArrived = true;
+    pipeline.advance(onConcluded);
+    assert(concludedEpochs == std::vector<int>({0, 1, 2, 3, 4, 5}));
+    assert(digestedEpochs == concludedEpochs);
+    assert(pipeline.empty());
+    LOG(V2_INFO, "Pipelined sessions with depth %i digested in order\n", depth);
+}
+
+// Random arrival order of aggregations and results for different depths
+void testRandomPipelining() {
+    for (int depth : {1, 2, 4}) {
+        Pipeline pipeline(depth);
+        std::vector<int> digestedEpochs, concludedEpochs;
+        int epoch = 0, nbLimitsUpdates = 0;
+        auto onConcluded = [&](std::unique_ptr<FakeSession>&& s) {concludedEpochs.push_back(s->epoch);};
+        for (int step = 0; step < 10000; step++) {
+            if (pipeline.canBeginNext() && Random::rand() < 0.3) {
+                begin(pipeline, epoch, digestedEpochs, nbLimitsUpdates);
+            }
+            for (auto& session : pipeline) {
+                if (Random::rand() < 0.2) session->aggregated = true;
+                if (session->aggregated && Random::rand() < 0.1) session->resultArrived = true;
+            }
+            pipeline.advance(onConcluded);
+            assert(pipeline.size() <= depth);
+            // Limits are never updated more often than epochs have been digested (+1 initially)
+            assert(nbLimitsUpdates <= concludedEpochs.size() + 1);
+        }
+        for (size_t i = 0; i < concludedEpochs.size(); i++) assert(concludedEpochs[i] == i);
+        assert(digestedEpochs == concludedEpochs);
+        assert(epoch > 100);
+        LOG(V2_INFO, "Depth %i: %i epochs begun, %i concluded, %i limits updates\n",
+            depth, epoch, (int) concludedEpochs.size(), nbLimitsUpdates);
+    }
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    testWithoutPipelining();
+    testPipelining();
+    testRandomPipelining();
+}
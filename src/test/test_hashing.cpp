@@ -6,6 +6,8 @@
 #include <vector>
 
 #include "util/hashing.hpp"
+#include "app/sat/proof/trusted/siphash/siphash.hpp"
+#include "util/SipHash/vectors.h"
 #include "app/sat/data/clause.hpp"
 #include "util/logger.hpp"
 #include "util/random.hpp"
@@ -77,7 +79,29 @@ void testNonCommutativeHashFunctionDistribution() {
     }
 }
 
+void testSipHash() {
+    // Compare with the reference test vectors for SipHash-2-4-128,
+    // feeding each message in pieces of different sizes
+    unsigned char key[16];
+    for (int i = 0; i < 16; i++) key[i] = i;
+    unsigned char msg[64];
+    for (int i = 0; i < 64; i++) msg[i] = i;
+    for (size_t pieceSize : {1, 3, 8, 13, 64}) {
+        SipHash siphash(key);
+        for (size_t len = 0; len < 64; len++) {
+            siphash.reset();
+            for (size_t pos = 0; pos < len; pos += pieceSize) {
+                siphash.update(msg+pos, std::min(pieceSize, len-pos));
+            }
+            auto out = siphash.digest();
+            for (int i = 0; i < 16; i++) assert(out[i] == vectors_sip128[len][i]);
+        }
+    }
+    LOG(V2_INFO, "SipHash test vectors OK\n");
+}
+
 int main() {
+    testSipHash();
     testCollisions();
     testNonCommutativeHashFunctionDistribution();
 }
@@ -1,5 +1,10 @@
 
-#include "app/sat/sharing/buffer/adaptive_clause_database.hpp"
+#include <set>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "app/sat/data/clause_metadata.hpp"
 #include "util/sys/process.hpp"
 #include "util/sys/thread_pool.hpp"
 #include "util/random.hpp"
@@ -7,34 +12,88 @@
 #include "util/sys/timer.hpp"
 #include "app/sat/job/historic_clause_storage.hpp"
 
-void testSimple() {
-
-    AdaptiveClauseDatabase::Setup setup;
-    setup.maxEffClauseLength = 20;
-    setup.slotsForSumOfLengthAndLbd = false;
-    setup.maxLbdPartitionedSize = 2;
-    setup.numLiterals = 1500;
-    setup.useChecksums = false;
-    HistoricClauseStorage storage(setup);
-
-    // for adding clauses
-    AdaptiveClauseDatabase cdb(setup);
-    Mallob::Clause clause;
-
-    for (int epoch = 0; epoch <= 100; epoch++) {
-        std::vector<int> clauses;
-        auto builder = cdb.getBufferBuilder(&clauses);
-        std::vector<int> lits((int) (2 + 6 * Random::rand()), epoch+1);
-        clause.begin = lits.data();
-        clause.size = lits.size();
-        clause.lbd = 2;
-        builder.append(clause);
-        storage.addSharingAndPrepareResharing(epoch, clauses);
-        while (!storage.hasPreparedResharing()); // busy waiting
-        auto resharing = storage.getResharing();
-        std::string litsOut;
-        for (int lit : resharing.clauses) litsOut += std::to_string(lit) + " ";
-        LOG(V2_INFO, "RESHARING e=%i: [%i,%i) %s\n", epoch, resharing.epochBegin, resharing.epochEnd, litsOut.c_str());
+typedef HistoricClauseStorage::BackgroundTask Task;
+
+// A single binary clause which is unique to the given epoch
+std::vector<int> getClauseOfEpoch(int epoch) {
+    std::vector<int> lits(ClauseMetadata::numInts(), 0);
+    lits.push_back(epoch+1);
+    lits.push_back(epoch+1001);
+    return lits;
+}
+
+std::vector<int> getBufferOfEpoch(AdaptiveClauseStore& store, int epoch) {
+    auto lits = getClauseOfEpoch(epoch);
+    BufferBuilder builder = store.getBufferBuilder(nullptr);
+    builder.append(Mallob::Clause(lits.data(), lits.size(), 2));
+    return builder.extractBuffer();
+}
+
+Task runTask(HistoricClauseStorage::Worker& worker, Task::Type type, int epochBegin, int epochEnd,
+        std::vector<int>&& clauses) {
+    worker.addTask(type, epochBegin, epochEnd, std::move(clauses), false);
+    while (!worker.hasFinishedTask()) usleep(100);
+    return worker.getFinishedTask();
+}
+
+std::set<int> getEpochsOfBuffer(AdaptiveClauseStore& store, std::vector<int>& buffer) {
+    std::set<int> epochs;
+    BufferReader reader = store.getBufferReader(buffer.data(), buffer.size());
+    Mallob::Clause cls = reader.getNextIncomingClause();
+    while (cls.begin != nullptr) {
+        const int* lits = cls.begin + ClauseMetadata::numInts();
+        assert(cls.size - ClauseMetadata::numInts() == 2);
+        assert(lits[1] == lits[0] + 1000);
+        epochs.insert(lits[0] - 1);
+        cls = reader.getNextIncomingClause();
+    }
+    return epochs;
+}
+
+size_t getFileSize(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return 0;
+    return st.st_size;
+}
+
+void testSpillAndRestore() {
+    LOG(V2_INFO, "Testing spill and restore of cold slots\n");
+
+    AdaptiveClauseStore::Setup setup;
+    setup.numLiterals = 10'000;
+    AdaptiveClauseStore store(setup);
+    const std::string diskFile = "/tmp/mallob_test_hcs." + std::to_string(Proc::getPid());
+    const int nbEpochs = 60;
+    const int maxHotSlots = 2;
+
+    HistoricClauseStorage::Worker worker(setup, maxHotSlots, diskFile);
+    Task task = runTask(worker, Task::INSERT, 0, 1, getBufferOfEpoch(store, 0));
+    for (int epoch = 1; epoch < nbEpochs; epoch++) {
+        task = runTask(worker, Task::INSERT, epoch, epoch+1, getBufferOfEpoch(store, epoch));
+    }
+    LOG(V2_INFO, "layout %s, %lu ints on disk\n", task.storageDiagnostics.slotLayout.c_str(),
+        task.storageDiagnostics.numLitsOnDisk);
+    assert(task.storageDiagnostics.numLitsOnDisk > 0);
+    const size_t numIntsOnDisk = task.storageDiagnostics.numLitsOnDisk;
+
+    size_t diskFileSize = 0;
+    for (int round = 0; round < 5; round++) {
+        // Request each epoch's slot; all clauses of the slot must be present (lossless)
+        int epoch = 0;
+        while (epoch < nbEpochs) {
+            task = runTask(worker, Task::REQUEST, epoch, epoch+1, std::vector<int>());
+            assert(task.epochBegin <= epoch && epoch < task.epochEnd);
+            auto epochs = getEpochsOfBuffer(store, task.clauses);
+            assert(epochs.size() == task.epochEnd - task.epochBegin
+                || log_return_false("[ERROR] slot [%i,%i) has %lu clauses\n", task.epochBegin, task.epochEnd, epochs.size()));
+            for (int e = task.epochBegin; e < task.epochEnd; e++) assert(epochs.count(e));
+            epoch = task.epochEnd;
+        }
+        // Restoring a cold slot frees its blocks on disk, which are then reused
+        assert(task.storageDiagnostics.numLitsOnDisk <= numIntsOnDisk);
+        if (round == 0) diskFileSize = getFileSize(diskFile);
+        else assert(getFileSize(diskFile) == diskFileSize
+            || log_return_false("[ERROR] disk file grew from %lu to %lu bytes\n", diskFileSize, getFileSize(diskFile)));
     }
 }
 
@@ -45,5 +104,5 @@ int main() {
     Process::init(0);
     ProcessWideThreadPool::init(1);
 
-    testSimple();
+    testSpillAndRestore();
 }
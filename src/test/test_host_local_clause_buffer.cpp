@@ -0,0 +1,74 @@
+
+#include <memory>
+#include <vector>
+
+#include "app/sat/job/host_local_clause_buffer.hpp"
+#include "app/sat/job/inplace_sharing_aggregation.hpp"
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/proc.hpp"
+#include "util/sys/timer.hpp"
+
+// Unique per process, such that concurrent runs do not collide in shared memory
+const int jobId = Proc::getPid();
+
+std::vector<int> getAggregatedBuffer(int nbClauses, int nbAggregated) {
+    std::vector<int> buffer;
+    for (int i = 0; i < nbClauses; i++) buffer.push_back(1 + (int) (Random::rand() * 1000));
+    InplaceClauseAggregation::prepareRawBuffer(buffer, 3, nbClauses, nbAggregated, -1);
+    return buffer;
+}
+
+void testDepositAndResolve() {
+    for (int nbClauses : {0, 1, 100, 100000}) {
+        auto buffer = getAggregatedBuffer(nbClauses, 3);
+        assert(!HostLocalClauseBuffer::isReference(buffer));
+        HostLocalClauseBuffer deposited(jobId, 2, nbClauses, buffer);
+        assert(deposited.valid());
+        auto elem = deposited.getReference();
+        assert(HostLocalClauseBuffer::isReference(elem));
+        // The parent may resolve the reference while the buffer is held by the child
+        assert(HostLocalClauseBuffer::resolve(elem));
+        assert(elem == buffer || log_return_false("[ERROR] resolved buffer of size %lu, expected %lu\n",
+            elem.size(), buffer.size()));
+        assert(InplaceClauseAggregation(elem).numAggregatedNodes() == 3);
+    }
+    LOG(V2_INFO, "Host-local clause buffers deposited and resolved\n");
+}
+
+void testReleaseAndRetain() {
+    auto buffer = getAggregatedBuffer(50, 2);
+
+    // A released buffer resolves to the neutral element
+    auto deposited = std::make_unique<HostLocalClauseBuffer>(jobId, 2, 100, buffer);
+    auto elem = deposited->getReference();
+    deposited.reset();
+    assert(!HostLocalClauseBuffer::resolve(elem));
+    assert(elem == InplaceClauseAggregation::neutralElem());
+
+    // A retained buffer remains available after its owner is gone
+    deposited.reset(new HostLocalClauseBuffer(jobId, 2, 101, buffer));
+    elem = deposited->getReference();
+    HostLocalClauseBuffer::retain(std::move(deposited));
+    HostLocalClauseBuffer::releaseExpired();
+    assert(HostLocalClauseBuffer::resolve(elem));
+    assert(elem == buffer);
+
+    // Buffers of other epochs do not collide
+    HostLocalClauseBuffer other(jobId, 2, 102, getAggregatedBuffer(10, 1));
+    assert(other.valid());
+    elem = other.getReference();
+    assert(HostLocalClauseBuffer::resolve(elem));
+    assert(elem != buffer);
+    LOG(V2_INFO, "Host-local clause buffers released and retained\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    testDepositAndResolve();
+    testReleaseAndRetain();
+}
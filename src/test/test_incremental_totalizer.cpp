@@ -0,0 +1,69 @@
+
+#include <cstdlib>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "app/maxsat/encoding/incremental_totalizer.hpp"
+
+// Checks whether the clauses, under the given assignment of the input variables
+// 1..nbInputs and the given assumptions, have a satisfying extension to all variables.
+bool hasExtension(const std::vector<std::vector<int>>& clauses, unsigned int nbVars,
+        int nbInputs, unsigned long inputBits, const std::vector<int>& assumptions) {
+    const int nbAux = nbVars - nbInputs;
+    for (unsigned long auxBits = 0; auxBits < (1UL << nbAux); auxBits++) {
+        auto value = [&](int lit) {
+            int var = std::abs(lit);
+            bool val = var <= nbInputs ? (inputBits >> (var-1)) & 1 : (auxBits >> (var-nbInputs-1)) & 1;
+            return lit > 0 ? val : !val;
+        };
+        bool ok = true;
+        for (int lit : assumptions) ok = ok && value(lit);
+        for (auto& clause : clauses) {
+            if (!ok) break;
+            bool sat = false;
+            for (int lit : clause) sat = sat || value(lit);
+            ok = sat;
+        }
+        if (ok) return true;
+    }
+    return false;
+}
+
+void testExhaustive(int nbInputs) {
+    LOG(V2_INFO, "Testing totalizer over %i inputs\n", nbInputs);
+    unsigned int nbVars = nbInputs;
+    std::vector<std::vector<int>> clauses(1);
+    std::vector<int> inputs;
+    for (int i = 1; i <= nbInputs; i++) inputs.push_back(i);
+    IncrementalTotalizer tot(inputs, nbVars, [&](int lit) {
+        if (lit == 0) clauses.emplace_back();
+        else clauses.back().push_back(lit);
+    });
+
+    // Request the outputs in increasing order, as in core-guided search
+    std::vector<int> outputs;
+    for (int k = 1; k <= nbInputs; k++) {
+        const int out = tot.getOutput(k);
+        outputs.push_back(out);
+        // Output literals stay the same when extending the encoding further
+        for (int j = 1; j <= k; j++) assert(tot.getOutput(j) == outputs[j-1]);
+        std::vector<std::vector<int>> cls(clauses.begin(), clauses.end()-1);
+        for (unsigned long inputBits = 0; inputBits < (1UL << nbInputs); inputBits++) {
+            const int count = __builtin_popcountl(inputBits);
+            // Assuming "fewer than k true inputs" must be possible iff count < k
+            assert(hasExtension(cls, nbVars, nbInputs, inputBits, {-out}) == (count < k)
+                || log_return_false("[ERROR] n=%i k=%i inputs=%lu\n", nbInputs, k, inputBits));
+        }
+    }
+}
+
+int main() {
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG);
+
+    for (int n = 1; n <= 6; n++) testExhaustive(n);
+}
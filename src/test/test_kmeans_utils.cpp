@@ -0,0 +1,169 @@
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "app/kmeans/kmeans_utils.hpp"
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+
+typedef KMeansUtils::Point Point;
+
+std::vector<float> getRandomPoints(int nbPoints, int dim) {
+    std::vector<float> points(nbPoints * dim);
+    for (auto& x : points) x = 20 * Random::rand() - 10;
+    return points;
+}
+
+bool approxEqual(float a, float b, float scale) {
+    return std::fabs(a - b) <= 1e-4f * (1 + scale);
+}
+
+// Compares the blocked distance kernel with a brute-force scan over the scalar distance
+void testNearestCenters(int nbPoints, int nbCenters, int dim) {
+    auto points = getRandomPoints(nbPoints, dim);
+    auto centerData = getRandomPoints(nbCenters, dim);
+    std::vector<Point> centers;
+    for (int c = 0; c < nbCenters; c++)
+        centers.emplace_back(centerData.begin() + c*dim, centerData.begin() + (c+1)*dim);
+    KMeansUtils::CenterMatrix matrix;
+    matrix.set(centers, dim);
+    assert(matrix.nbCentersPadded % KMeansUtils::CenterMatrix::CENTER_PADDING == 0);
+    assert(matrix.nbCentersPadded >= nbCenters);
+
+    std::vector<int> nearest(nbPoints, -1);
+    std::vector<float> sqDistances(nbPoints), secondSqDistances(nbPoints);
+    KMeansUtils::nearestCenters(points.data(), nbPoints, matrix, nearest.data(),
+        sqDistances.data(), secondSqDistances.data());
+    // The nearest centers alone must be the same
+    std::vector<int> nearestOnly(nbPoints, -1);
+    KMeansUtils::nearestCenters(points.data(), nbPoints, matrix, nearestOnly.data());
+    assert(nearestOnly == nearest);
+
+    float maxCenterSqNorm = 0;
+    for (int c = 0; c < nbCenters; c++) maxCenterSqNorm = std::max(maxCenterSqNorm, matrix.sqNorms[c]);
+
+    for (int p = 0; p < nbPoints; p++) {
+        const float* x = points.data() + p*dim;
+        // The kernel computes ||x||^2 - 2 x.c + ||c||^2, so its rounding error scales with the norms
+        float scale = maxCenterSqNorm;
+        for (int d = 0; d < dim; d++) scale += x[d] * x[d];
+        float best = std::numeric_limits<float>::infinity();
+        float secondBest = std::numeric_limits<float>::infinity();
+        for (int c = 0; c < nbCenters; c++) {
+            float dist = KMeansUtils::eukild(x, centers[c].data(), dim);
+            if (dist < best) {
+                secondBest = best;
+                best = dist;
+            } else if (dist < secondBest) {
+                secondBest = dist;
+            }
+        }
+        // A padding center must never be reported; in case of (near) ties,
+        // any of the nearest centers is fine
+        assert((nearest[p] >= 0 && nearest[p] < nbCenters)
+            || log_return_false("[ERROR] point %i: nearest center %i of %i\n", p, nearest[p], nbCenters));
+        const float distOfNearest = KMeansUtils::eukild(x, centers[nearest[p]].data(), dim);
+        assert(approxEqual(distOfNearest, best, scale)
+            || log_return_false("[ERROR] point %i: center %i at %.6f, best at %.6f\n", p, nearest[p], distOfNearest, best));
+        assert(approxEqual(sqDistances[p], best, scale)
+            || log_return_false("[ERROR] point %i: distance %.6f, expected %.6f\n", p, sqDistances[p], best));
+        if (nbCenters == 1) {
+            assert(std::isinf(secondSqDistances[p]));
+        } else {
+            assert(approxEqual(secondSqDistances[p], secondBest, scale)
+                || log_return_false("[ERROR] point %i: second distance %.6f, expected %.6f\n", p, secondSqDistances[p], secondBest));
+        }
+    }
+    LOG(V2_INFO, "nearestCenters matches scalar scan for n=%i k=%i d=%i\n", nbPoints, nbCenters, dim);
+}
+
+// Lloyd step: moves each center to the mean of its members
+void moveCenters(const std::vector<float>& points, int dim, const std::vector<int>& nearest, std::vector<Point>& centers) {
+    std::vector<Point> sums(centers.size(), Point(dim, 0));
+    std::vector<int> counts(centers.size(), 0);
+    for (size_t p = 0; p < nearest.size(); p++) {
+        counts[nearest[p]]++;
+        for (int d = 0; d < dim; d++) sums[nearest[p]][d] += points[p*dim + d];
+    }
+    for (size_t c = 0; c < centers.size(); c++) {
+        if (counts[c] == 0) continue;
+        for (int d = 0; d < dim; d++) centers[c][d] = sums[c][d] / counts[c];
+    }
+}
+
+// Runs k-means with and without distance bounds and requires identical assignments
+// in each iteration. As in a KMeansJob, points are assigned block by block, and an
+// iteration may be skipped after some blocks, leaving the bounds of the remaining
+// points behind. A skipped iteration is either repeated with the same centers
+// (as a KMeansJob does) or followed by new centers right away.
+void testPruningEquivalence(int nbPoints, int nbCenters, int dim) {
+    // Points around a few clusters, so that most assignments settle quickly
+    auto points = getRandomPoints(nbPoints, dim);
+    auto clusterCenters = getRandomPoints(nbCenters, dim);
+    for (int p = 0; p < nbPoints; p++) {
+        const int cluster = (int) (Random::rand() * nbCenters);
+        for (int d = 0; d < dim; d++) points[p*dim + d] = clusterCenters[cluster*dim + d] + 0.1f * points[p*dim + d];
+    }
+    std::vector<Point> centers;
+    for (int c = 0; c < nbCenters; c++)
+        centers.emplace_back(points.begin() + c*dim, points.begin() + (c+1)*dim);
+
+    const int pointsPerBlock = 256;
+    KMeansUtils::CenterMatrix matrix;
+    KMeansUtils::BoundedAssignment bounds;
+    bounds.init(nbPoints);
+    std::vector<int> nearest(nbPoints), nearestPruned(nbPoints);
+    int nbSkipped = 0;
+    for (int iter = 0; iter < 20; iter++) {
+        matrix.set(centers, dim);
+        bounds.updateCenters(centers, matrix);
+        const bool skip = iter % 5 == 2;
+        const bool repeatAfterSkip = iter % 10 == 2;
+        const int nbBlocksToAssign = skip ? 1 + (int) (Random::rand() * 3) : INT32_MAX;
+        int blockIdx = 0;
+        nearestPruned.assign(nbPoints, -1);
+        for (int blockStart = 0; blockStart < nbPoints && blockIdx < nbBlocksToAssign; blockStart += pointsPerBlock, blockIdx++) {
+            const int blockEnd = std::min(nbPoints, blockStart + pointsPerBlock);
+            bounds.assign(points.data(), blockStart, blockEnd, matrix, nearestPruned.data());
+        }
+        KMeansUtils::nearestCenters(points.data(), nbPoints, matrix, nearest.data());
+        const int nbAssigned = std::min(nbPoints, nbBlocksToAssign * pointsPerBlock);
+        for (int p = 0; p < nbAssigned; p++) {
+            assert(nearestPruned[p] == nearest[p]
+                || log_return_false("[ERROR] iter %i point %i: center %i with bounds, %i without\n",
+                    iter, p, nearestPruned[p], nearest[p]));
+        }
+        if (skip) {
+            nbSkipped++;
+            if (repeatAfterSkip) continue;
+        }
+        moveCenters(points, dim, nearest, centers);
+    }
+    assert(nbSkipped > 0);
+    LOG(V2_INFO, "Bounds yield identical assignments for n=%i k=%i d=%i (%i skipped iterations)\n",
+        nbPoints, nbCenters, dim, nbSkipped);
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    // Numbers of points which are not a multiple of the point block size
+    // and numbers of centers which are not a multiple of the padding / center block size
+    for (int k : {1, 5, 16, 17, 33, 64, 65, 100}) {
+        for (int dim : {1, 3, 16, 37}) {
+            testNearestCenters(1003, k, dim);
+        }
+    }
+    for (int k : {2, 17, 40}) {
+        for (int dim : {2, 13}) {
+            testPruningEquivalence(5000, k, dim);
+        }
+    }
+}
@@ -2,13 +2,20 @@
 #include <assert.h>
 #include <cstdio>
 #include <stdlib.h>
+#include <cctype>
 #include <cstdint>
 #include <vector>
 
+#include "app/sat/parse/sat_reader.hpp"
+#include "app/sat/proof/lrat_line.hpp"
+#include "app/sat/proof/lrat_utils.hpp"
 #include "app/sat/proof/trusted/lrat_checker.hpp"
+#include "data/job_description.hpp"
 #include "util/logger.hpp"
 #include "util/params.hpp"
 #include "util/random.hpp"
+#include "util/sys/buffered_io.hpp"
+#include "util/sys/proc.hpp"
 #include "util/sys/timer.hpp"
 
 bool addCls(LratChecker& chk, uint64_t id, const std::vector<int>& lits, const std::vector<uint64_t>& hints) {
@@ -18,14 +25,7 @@ bool delCls(LratChecker& chk, const std::vector<uint64_t>& ids) {
     return chk.deleteClause(ids.data(), ids.size());
 }
 
-int main(int argc, char** argv) {
-    Timer::init();
-    Random::init(rand(), rand());
-    Logger::init(0, V5_DEBG);
-
-    Parameters params;
-    params.init(argc, argv);
-
+void testCorrectness() {
     std::vector<int> orig {
         1, -2, 0,
         2, -4, 0,
@@ -56,5 +56,118 @@ int main(int argc, char** argv) {
     ok = addCls(chk, 14, {}, {11, 10, 1}); assert(ok);
     ok = chk.validateUnsat(); assert(ok);
 
+}
+
+// Inserts, finds and erases clauses with IDs of a fixed stride (as produced by
+// several solvers) interleaved with consecutive IDs (as of the original clauses).
+void testClauseTableWithStride(u64 stride) {
+    LratClauseTable table(stride);
+    std::vector<u64> ids;
+    for (u64 id = 1; id <= 5000; id++) ids.push_back(id);
+    for (u64 k = 1; k <= 3000; k++) for (u64 r = 0; r < stride; r += 3) ids.push_back(5000 + k*stride + r);
+    for (u64 id : ids) {
+        int lits[2] {(int) (id % 1000) + 1, -(int) (id % 777) - 1};
+        bool ok = table.insert(id, lits, 2); assert(ok);
+    }
+    assert(table.size() == ids.size());
+    int lits[1] {1};
+    bool ok = table.insert(ids[42], lits, 1); assert(!ok); // duplicate
+    for (u64 id : ids) {
+        const int* cls = table.find(id); assert(cls);
+        assert(cls[0] == (int) (id % 1000) + 1 && cls[1] == -(int) (id % 777) - 1 && cls[2] == 0);
+    }
+    assert(!table.find(5000 + 3001*stride)); // beyond the inserted IDs
+    if (stride > 1) assert(!table.find(5000 + stride + 1)); // residue class not inserted
+    // erase every other clause, then check again
+    for (size_t i = 0; i < ids.size(); i += 2) {ok = table.erase(ids[i]); assert(ok);}
+    for (size_t i = 0; i < ids.size(); i++) {
+        const int* cls = table.find(ids[i]);
+        assert((cls == nullptr) == (i % 2 == 0));
+    }
+    ok = table.erase(ids[0]); assert(!ok);
+    LOG(V2_INFO, "Clause table with ID stride %lu ok\n", stride);
+}
+
+// Derives a long chain of units x1 -> x2 -> ... -> xN, deleting each unit
+// once its successor has been derived, and finally the empty clause.
+// Covers many pages of clause IDs, page releases, and compaction.
+void benchmarkChain(int nbVars) {
+    std::vector<int> orig {1, 0};
+    for (int v = 1; v < nbVars; v++) {
+        orig.push_back(-v); orig.push_back(v+1); orig.push_back(0);
+    }
+    orig.push_back(-nbVars); orig.push_back(0);
+    const uint64_t nbOrigClauses = nbVars+1;
+
+    float time = Timer::elapsedSeconds();
+    LratChecker chk(nbVars);
+    bool ok = chk.loadOriginalClauses(orig.data(), orig.size()); assert(ok);
+    uint64_t unitId = 1; // x1
+    uint64_t id = nbOrigClauses+1;
+    for (int v = 1; v < nbVars; v++) {
+        // x(v+1) from x(v) and (-x(v) | x(v+1))
+        ok = addCls(chk, id, {v+1}, {unitId, (uint64_t) v+1}); assert(ok);
+        ok = delCls(chk, {(uint64_t) v+1}); assert(ok);
+        if (unitId > nbOrigClauses) {ok = delCls(chk, {unitId}); assert(ok);}
+        unitId = id++;
+    }
+    ok = addCls(chk, id, {}, {unitId, nbOrigClauses}); assert(ok);
+    ok = chk.validateUnsat(); assert(ok);
+    time = Timer::elapsedSeconds() - time;
+    LOG(V2_INFO, "Chain of %i units checked; time %.3f; RAM usage: %.1f MB\n", nbVars, time,
+        Proc::getRecursiveProportionalSetSizeKbs(Proc::getPid()) / 1024.0);
+}
+
+// Checks a recorded binary LRAT proof for a CNF formula
+void benchmarkRecordedProof(Parameters& params, const char* cnfFile, const char* proofFile) {
+    SatReader reader(params, cnfFile);
+    JobDescription desc;
+    desc.setRevision(0);
+    bool ok = reader.read(desc); assert(ok);
+
+    float time = Timer::elapsedSeconds();
+    LratChecker chk(reader.getNbVars());
+    ok = chk.loadOriginalClauses(desc.getFormulaPayload(0), desc.getFormulaPayloadSize(0)); assert(ok);
+    std::ifstream ifs(proofFile, std::ios::binary);
+    BufferedFileReader proofReader(ifs);
+    lrat_utils::ReadBuffer readbuf(proofReader);
+    LratLine line;
+    unsigned long nbLines {0};
+    while (lrat_utils::readLine(readbuf, line)) {
+        nbLines++;
+        if (line.isDeletionStatement()) {
+            ok = chk.deleteClause(line.hints.data(), line.hints.size());
+        } else {
+            ok = chk.addClause(line.id, line.literals.data(), line.literals.size(), line.hints.data(), line.hints.size());
+        }
+        if (!ok) LOG(V0_CRIT, "[ERROR] line %lu: %s\n", nbLines, chk.getErrorMessage());
+        assert(ok);
+    }
+    ok = chk.validateUnsat(); assert(ok);
+    time = Timer::elapsedSeconds() - time;
+    LOG(V2_INFO, "%s checked; %lu lines; time %.3f (= %.1f lines/sec); RAM usage: %.1f MB\n", proofFile,
+        nbLines, time, nbLines/std::max(0.0001f, time),
+        Proc::getRecursiveProportionalSetSizeKbs(Proc::getPid()) / 1024.0);
+}
+
+int main(int argc, char** argv) {
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG);
+
+    // Optional benchmarks: test_lrat_checker <nb-chain-vars> (e.g., 1000000)
+    //                      test_lrat_checker <cnf-file> <binary-lrat-proof-file>
+    const bool chainBenchmark = argc == 2 && isdigit(argv[1][0]);
+    const bool recordedProof = argc == 3 && argv[1][0] != '-';
+
+    Parameters params;
+    if (!recordedProof && !chainBenchmark) params.init(argc, argv);
+
+    testCorrectness();
+    for (u64 stride : {1, 4, 7, 64}) testClauseTableWithStride(stride);
+    // a short chain still covers many pages, page releases, and compaction
+    benchmarkChain(chainBenchmark ? atoi(argv[1]) : 20'000);
+    if (recordedProof) benchmarkRecordedProof(params, argv[1], argv[2]);
+
     printf("All ok.\n");
 }
@@ -0,0 +1,93 @@
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/params.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "data/job_description.hpp"
+#include "app/maxsat/parse/maxsat_reader.hpp"
+
+std::string generateWcnf(int nbLines, int nbVars) {
+    std::string out = "c random test instance\np wcnf " + std::to_string(nbVars) + " " + std::to_string(nbLines) + "\n";
+    for (int i = 0; i < nbLines; i++) {
+        const float type = Random::rand();
+        if (type < 0.05) {
+            out += "c comment line " + std::to_string(i) + "\n";
+            continue;
+        }
+        out += type < 0.6 ? "h " : std::to_string((int) (Random::rand() * 1000) + 1) + " ";
+        const int len = type < 0.6 ? 1 + (int) (Random::rand() * 5) : 1;
+        for (int j = 0; j < len; j++) {
+            const int var = 1 + (int) (Random::rand() * nbVars);
+            out += std::to_string(Random::rand() < 0.5 ? -var : var) + " ";
+        }
+        out += "0\n";
+    }
+    return out;
+}
+
+struct ParseResult {
+    std::vector<uint8_t> data;
+    int nbVars;
+    int nbClauses;
+    bool valid;
+};
+
+ParseResult parse(Parameters& params, const std::string& content, int nbThreads) {
+    JobDescription desc;
+    desc.setRevision(0);
+    desc.beginInitialization(0);
+    MaxSatReader reader(params, "");
+    if (nbThreads == 1) reader.process(content.data(), content.data()+content.size(), desc);
+    else reader.parseInParallel(content.data(), content.size(), nbThreads, desc);
+    reader.process(EOF, desc);
+    reader.finalize(desc);
+    return {*desc.getRevisionData(0), reader.getNbVars(), reader.getNbClauses(), reader.isValidInput()};
+}
+
+void testEquivalence(Parameters& params, const std::string& content) {
+    auto expected = parse(params, content, 1);
+    for (int nbThreads : {2, 3, 4, 7, 16}) {
+        auto result = parse(params, content, nbThreads);
+        assert(result.data == expected.data || log_return_false("[ERROR] data differs with %i threads\n", nbThreads));
+        assert(result.nbVars == expected.nbVars);
+        assert(result.nbClauses == expected.nbClauses);
+        assert(result.valid == expected.valid);
+    }
+}
+
+void testSmall(Parameters& params) {
+    LOG(V2_INFO, "Testing small instance\n");
+    const std::string content = "c test\nh 1 -2 0\n3 2 0\nh -1 0\n5 -3 0";
+    auto result = parse(params, content, 1);
+    assert(result.valid);
+    assert(result.nbVars == 3);
+    assert(result.nbClauses == 2);
+    testEquivalence(params, content);
+}
+
+void testRandom(Parameters& params) {
+    for (int i = 0; i < 10; i++) {
+        const int nbLines = 1 + (int) (Random::rand() * 10'000);
+        LOG(V2_INFO, "Testing random instance with %i lines\n", nbLines);
+        auto content = generateWcnf(nbLines, 1 + (int) (Random::rand() * 500));
+        testEquivalence(params, content);
+        // without the final line break
+        content.pop_back();
+        testEquivalence(params, content);
+    }
+}
+
+int main() {
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG);
+    Parameters params;
+
+    testSmall(params);
+    testRandom(params);
+}
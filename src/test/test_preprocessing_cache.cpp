@@ -0,0 +1,214 @@
+
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "app/satwithpre/preprocessing_cache.hpp"
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/fileutils.hpp"
+#include "util/sys/proc.hpp"
+#include "util/sys/timer.hpp"
+
+typedef SatPreprocessActor::PreprocessActorResult Result;
+
+const std::string dir = "/tmp/mallob_test_ppc." + std::to_string(Proc::getPid());
+
+// Random formula with 0-separated clauses, followed by #vars and #clauses
+std::vector<int> getRandomFormula(int nbVars, int nbClauses) {
+    std::vector<int> cnf;
+    for (int c = 0; c < nbClauses; c++) {
+        int size = 1 + (int) (Random::rand() * 5);
+        for (int i = 0; i < size; i++) {
+            int lit = 1 + (int) (Random::rand() * nbVars);
+            cnf.push_back(Random::rand() < 0.5 ? lit : -lit);
+        }
+        cnf.push_back(0);
+    }
+    cnf.push_back(nbVars);
+    cnf.push_back(nbClauses);
+    return cnf;
+}
+
+PreprocessingCache::Entry getEntry(const std::vector<int>& input, Result result) {
+    PreprocessingCache::Entry entry;
+    entry.inputSize = input.size();
+    entry.inputChecksum = PreprocessingCache::getChecksum(input);
+    entry.result = result;
+    if (result == SatPreprocessActor::SIMPLIFIED) entry.formula = getRandomFormula(50, 100);
+    if (result == SatPreprocessActor::SAT) {
+        entry.model.push_back(0);
+        for (int v = 1; v <= 100; v++) entry.model.push_back(Random::rand() < 0.5 ? v : -v);
+    }
+    return entry;
+}
+
+bool tryLoad(const PreprocessingCache& cache, const std::string& key, const std::vector<int>& input,
+        PreprocessingCache::Entry& entry) {
+    return cache.tryLoad(key, input.size(), PreprocessingCache::getChecksum(input), entry);
+}
+
+size_t getFileSize(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "r");
+    assert(f);
+    fseek(f, 0, SEEK_END);
+    size_t size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+void testRoundTrip() {
+    PreprocessingCache cache(dir);
+    for (Result result : {SatPreprocessActor::SAT, SatPreprocessActor::UNSAT,
+            SatPreprocessActor::SIMPLIFIED, SatPreprocessActor::NONE}) {
+        auto input = getRandomFormula(100, 300);
+        auto key = cache.getKey(input, "kissat-test");
+        PreprocessingCache::Entry loaded;
+        assert(!tryLoad(cache, key, input, loaded));
+
+        auto entry = getEntry(input, result);
+        cache.store(key, entry);
+        assert(tryLoad(cache, key, input, loaded));
+        assert(loaded.inputSize == input.size());
+        assert(loaded.inputChecksum == entry.inputChecksum);
+        assert(loaded.result == result);
+        assert(loaded.formula == entry.formula);
+        assert(loaded.model == entry.model);
+
+        cache.remove(key);
+        assert(!tryLoad(cache, key, input, loaded));
+    }
+    LOG(V2_INFO, "Cache entries stored and loaded\n");
+}
+
+void testKeyMismatch() {
+    PreprocessingCache cache(dir);
+    auto input = getRandomFormula(100, 300);
+    auto otherInput = input;
+    otherInput[0] = -otherInput[0];
+    const std::string key = cache.getKey(input, "kissat-test");
+    // other formulas and other configurations yield other keys
+    assert(cache.getKey(otherInput, "kissat-test") != key);
+    assert(cache.getKey(input, "kissat-other") != key);
+    assert(cache.getKey(input, "kissat-test") == key);
+    // keys are valid file names
+    assert(cache.getKey(input, "a b/c").find('/') == std::string::npos);
+
+    cache.store(key, getEntry(input, SatPreprocessActor::SIMPLIFIED));
+    PreprocessingCache::Entry loaded;
+    assert(tryLoad(cache, key, input, loaded));
+    // an entry is not adopted for another formula under the same key
+    assert(!tryLoad(cache, key, otherInput, loaded));
+    auto longerInput = input;
+    longerInput.insert(longerInput.end()-2, {1, 0});
+    assert(!tryLoad(cache, key, longerInput, loaded));
+    assert(!cache.tryLoad(key, input.size()+1, PreprocessingCache::getChecksum(input), loaded));
+    cache.remove(key);
+    LOG(V2_INFO, "Mismatching cache entries rejected\n");
+}
+
+void testMalformedEntry() {
+    PreprocessingCache cache(dir);
+    auto input = getRandomFormula(100, 300);
+    const std::string key = cache.getKey(input, "kissat-test");
+    const std::string path = cache.getPath(key);
+    PreprocessingCache::Entry loaded;
+
+    // every truncation of an entry is rejected
+    cache.store(key, getEntry(input, SatPreprocessActor::SAT));
+    const size_t size = getFileSize(path);
+    for (size_t truncatedSize = size; truncatedSize > 0; truncatedSize--) {
+        assert(truncate(path.c_str(), truncatedSize-1) == 0);
+        assert(!tryLoad(cache, key, input, loaded)
+            || log_return_false("[ERROR] entry truncated to %lu/%lu bytes accepted\n", truncatedSize-1, size));
+    }
+
+    // a vector size beyond the end of the file is rejected without allocating it
+    cache.store(key, getEntry(input, SatPreprocessActor::SIMPLIFIED));
+    FILE* f = fopen(path.c_str(), "r+");
+    assert(f);
+    fseek(f, 2*sizeof(int) + 3*sizeof(size_t), SEEK_SET);
+    size_t hugeSize = 1UL << 60;
+    assert(fwrite(&hugeSize, sizeof(size_t), 1, f) == 1);
+    fclose(f);
+    assert(!tryLoad(cache, key, input, loaded));
+
+    // trailing data is rejected
+    cache.store(key, getEntry(input, SatPreprocessActor::SIMPLIFIED));
+    f = fopen(path.c_str(), "a");
+    assert(f);
+    int x = 1;
+    assert(fwrite(&x, sizeof(int), 1, f) == 1);
+    fclose(f);
+    assert(!tryLoad(cache, key, input, loaded));
+
+    // an entry of another format version is rejected
+    cache.store(key, getEntry(input, SatPreprocessActor::UNSAT));
+    f = fopen(path.c_str(), "r+");
+    assert(f);
+    int version = 1;
+    assert(fwrite(&version, sizeof(int), 1, f) == 1);
+    fclose(f);
+    assert(!tryLoad(cache, key, input, loaded));
+
+    cache.remove(key);
+    LOG(V2_INFO, "Malformed cache entries rejected\n");
+}
+
+void testTempFileAndRename() {
+    PreprocessingCache cache(dir);
+    auto input = getRandomFormula(100, 300);
+    const std::string key = cache.getKey(input, "kissat-test");
+    auto entry = getEntry(input, SatPreprocessActor::SIMPLIFIED);
+    PreprocessingCache::Entry loaded;
+
+    // Concurrent writers replace the entry while a reader loads it:
+    // the reader always sees a complete entry of one of the writers
+    const int nbWriters = 4;
+    std::vector<PreprocessingCache::Entry> entries;
+    for (int w = 0; w < nbWriters; w++) entries.push_back(getEntry(input, SatPreprocessActor::SIMPLIFIED));
+    cache.store(key, entries[0]);
+    std::atomic_bool stop {false};
+    std::vector<std::thread> writers;
+    for (int w = 0; w < nbWriters; w++) {
+        writers.emplace_back([&, w]() {
+            while (!stop) cache.store(key, entries[w]);
+        });
+    }
+    for (int i = 0; i < 1000; i++) {
+        assert(tryLoad(cache, key, input, loaded));
+        bool found = false;
+        for (auto& e : entries) found |= e.formula == loaded.formula;
+        assert(found);
+    }
+    stop = true;
+    for (auto& writer : writers) writer.join();
+
+    // no temporary files are left behind
+    assert(FileUtils::glob(cache.getPath(key) + ".tmp.*").empty());
+    assert(FileUtils::glob(dir + "/*").size() == 1);
+
+    // an entry which cannot be written is not stored, and no temporary file remains
+    cache.remove(key);
+    FileUtils::rmrf(dir);
+    cache.store(key, entry);
+    assert(!tryLoad(cache, key, input, loaded));
+    assert(FileUtils::glob(dir + "/*").empty());
+    LOG(V2_INFO, "Cache entries replaced atomically\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    testRoundTrip();
+    testKeyMismatch();
+    testMalformedEntry();
+    testTempFileAndRename();
+    FileUtils::rmrf(dir);
+}
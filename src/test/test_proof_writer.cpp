@@ -0,0 +1,127 @@
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "app/sat/proof/lrat_line.hpp"
+#include "app/sat/proof/merging/proof_writer.hpp"
+#include "app/sat/proof/serialized_lrat_line.hpp"
+#include "util/assert.hpp"
+#include "util/block_reversed_file_reader.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+
+// Writes an inverted proof of the given number of lines, i.e., the line with the
+// highest ID first, and returns the text lines of the forward proof.
+std::vector<std::string> writeInvertedProof(ProofWriter& writer, int nbLines) {
+    std::vector<std::string> forwardLines(nbLines);
+    for (int i = nbLines; i >= 1; i--) {
+        if (i % 10 == 0) {
+            std::vector<LratClauseId> hints {(LratClauseId) i-1, (LratClauseId) i-2};
+            writer.pushDeletionBlocking(i, hints);
+            forwardLines[i-1] = std::to_string(i) + " d " + std::to_string(i-1) + " " + std::to_string(i-2) + " 0\n";
+            continue;
+        }
+        LratLine line;
+        line.id = i;
+        int nbLits = 1 + (int) (Random::rand() * 10);
+        for (int l = 0; l < nbLits; l++) line.literals.push_back(1 + (int) (Random::rand() * 100'000));
+        int nbHints = (int) (Random::rand() * 10);
+        for (int h = 0; h < nbHints; h++) line.hints.push_back(1 + (int) (Random::rand() * i));
+        SerializedLratLine sline(line);
+        forwardLines[i-1] = sline.toStr();
+        writer.pushAdditionBlocking(sline);
+    }
+    writer.markExhausted();
+    while (!writer.isDone()) usleep(1000);
+    return forwardLines;
+}
+
+std::string readFile(const std::string& path) {
+    std::ifstream ifs(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+}
+
+std::string readBlocksReversed(const std::string& path, const std::vector<size_t>& blockSizes) {
+    BlockReversedFileReader reader(path, blockSizes);
+    std::string out;
+    const char* data;
+    size_t size;
+    while (reader.nextBlock(data, size)) out.append(data, size);
+    assert(reader.valid());
+    return out;
+}
+
+void testTextProof() {
+    const std::string path = "test_proof_writer.lrat";
+    const int nbLines = 300'000;
+    std::vector<std::string> forwardLines;
+    std::vector<size_t> blockSizes;
+    {
+        ProofWriter writer(path, /*binary=*/false, /*reverseBlocks=*/true);
+        forwardLines = writeInvertedProof(writer, nbLines);
+        blockSizes = writer.getBlockSizes();
+    }
+    assert(blockSizes.size() > 1);
+    std::string expected;
+    for (auto& line : forwardLines) expected += line;
+    // Reading the blocks in reverse order yields the forward proof
+    assert(readBlocksReversed(path, blockSizes) == expected);
+    remove(path.c_str());
+    LOG(V2_INFO, "Text proof of %i lines in %lu blocks\n", nbLines, blockSizes.size());
+}
+
+void testBinaryProof() {
+    const std::string path = "test_proof_writer.lrat";
+    const std::string invertedPath = "test_proof_writer_inverted.lrat";
+    const int nbLines = 300'000;
+    std::vector<size_t> blockSizes;
+    {
+        Random::init(1, 1);
+        ProofWriter writer(invertedPath, /*binary=*/true);
+        writeInvertedProof(writer, nbLines);
+    }
+    {
+        Random::init(1, 1);
+        ProofWriter writer(path, /*binary=*/true, /*reverseBlocks=*/true);
+        writeInvertedProof(writer, nbLines);
+        blockSizes = writer.getBlockSizes();
+    }
+    assert(blockSizes.size() > 1);
+    // The forward proof is exactly the byte-wise reversal of the fully inverted proof
+    std::string expected = readFile(invertedPath);
+    std::reverse(expected.begin(), expected.end());
+    assert(readBlocksReversed(path, blockSizes) == expected);
+    remove(path.c_str());
+    remove(invertedPath.c_str());
+    LOG(V2_INFO, "Binary proof of %i lines in %lu blocks\n", nbLines, blockSizes.size());
+}
+
+void testDestructionBeforeEnd() {
+    // The writer must not wait for further input on destruction
+    const std::string path = "test_proof_writer.lrat";
+    {
+        ProofWriter writer(path, /*binary=*/true, /*reverseBlocks=*/true);
+        LratLine line;
+        line.id = 1;
+        line.literals.push_back(1);
+        SerializedLratLine sline(line);
+        writer.pushAdditionBlocking(sline);
+    }
+    remove(path.c_str());
+    LOG(V2_INFO, "Destroyed incomplete proof writer\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    testTextProof();
+    testBinaryProof();
+    testDestructionBeforeEnd();
+}
@@ -0,0 +1,61 @@
+
+#include <assert.h>
+#include <stdlib.h>
+#include <cstdint>
+#include <set>
+
+#include "util/random.hpp"
+#include "util/roaring_id_set.hpp"
+#include "util/logger.hpp"
+#include "util/sys/timer.hpp"
+
+void testAgainstReference(uint64_t maxId, int nbOps) {
+    RoaringIdSet set;
+    std::set<uint64_t> reference;
+    for (int i = 0; i < nbOps; i++) {
+        uint64_t id = (uint64_t) (Random::rand() * maxId);
+        if (Random::rand() < 0.6) {
+            bool inserted = set.insert(id);
+            assert(inserted == reference.insert(id).second);
+        } else {
+            bool erased = set.erase(id);
+            assert(erased == (reference.erase(id) > 0));
+        }
+        assert(set.size() == reference.size());
+    }
+    for (uint64_t id = 0; id < std::min(maxId, 1UL<<20); id++) {
+        assert(set.contains(id) == (reference.count(id) > 0));
+    }
+    LOG(V2_INFO, "max. ID %lu, %i ops: %lu IDs in %lu chunks\n", maxId, nbOps, set.size(), set.getNumChunks());
+}
+
+void testDenseRange() {
+    // Register a dense, decreasing range of IDs as done during proof merging,
+    // which must switch chunks to bitmaps and back and then release them
+    RoaringIdSet set;
+    const uint64_t offset = 1UL << 40;
+    for (uint64_t id = offset + 500'000; id > offset; id--) {
+        assert(set.insert(id));
+        assert(!set.insert(id));
+    }
+    assert(set.size() == 500'000);
+    assert(set.getNumChunks() == 8);
+    for (uint64_t id = offset + 500'000; id > offset; id--) {
+        assert(set.contains(id));
+        assert(set.erase(id));
+        assert(!set.erase(id));
+    }
+    assert(set.size() == 0);
+    assert(set.getNumChunks() == 0);
+}
+
+int main() {
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG);
+
+    testAgainstReference(1000, 100'000);
+    testAgainstReference(200'000, 1'000'000);
+    testAgainstReference(1UL << 50, 100'000);
+    testDenseRange();
+}
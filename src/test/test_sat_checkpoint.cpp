@@ -0,0 +1,110 @@
+
+#include <cstdio>
+#include <vector>
+#include <unistd.h>
+
+#include "app/sat/data/sat_checkpoint.hpp"
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+
+void testReservoir() {
+    const size_t capacity = 10000;
+    LearnedClauseReservoir reservoir(capacity);
+    std::vector<int> condLits {42};
+    for (int c = 0; c < 10000; c++) {
+        std::vector<int> lits;
+        int size = 1 + (int) (Random::rand() * 20);
+        for (int i = 0; i < size; i++) lits.push_back(c+1);
+        reservoir.add(lits.data(), lits.size(), std::min(size, 2), condLits);
+    }
+    auto buffer = reservoir.extract();
+    assert(buffer.size() <= capacity);
+    assert(!buffer.empty());
+    // clauses must be intact and the newest clause must be present
+    size_t pos = 0;
+    int lastId = 0;
+    while (pos < buffer.size()) {
+        int size = buffer[pos];
+        assert(pos + 2 + size <= buffer.size());
+        int id = buffer[pos+2];
+        assert(id > lastId);
+        for (int i = 0; i < size-1; i++) assert(buffer[pos+2+i] == id);
+        assert(buffer[pos+2+size-1] == 42);
+        lastId = id;
+        pos += 2 + size;
+    }
+    assert(pos == buffer.size());
+    assert(lastId == 10000);
+    assert(reservoir.extract().empty());
+    LOG(V2_INFO, "Reservoir holds %lu ints\n", buffer.size());
+}
+
+void testRoundtrip() {
+    const std::string path = "test_sat_checkpoint.bin";
+    SatCheckpoint out;
+    out.jobId = 7;
+    out.revision = 3;
+    out.runNonce = 12345;
+    out.formulaChecksum = SatCheckpoint::getFormulaChecksum({1, -2, 0, 2, 3, 0});
+    for (int s = 0; s < 4; s++) {
+        out.clausesPerSolver.emplace_back();
+        for (int i = 0; i < 1000*s; i++) out.clausesPerSolver.back().push_back((int) (Random::rand() * 1000) - 500);
+    }
+    assert(out.write(path));
+
+    SatCheckpoint in;
+    assert(in.read(path));
+    assert(in.jobId == out.jobId);
+    assert(in.revision == out.revision);
+    assert(in.runNonce == out.runNonce);
+    assert(in.formulaChecksum == out.formulaChecksum);
+    assert(in.clausesPerSolver == out.clausesPerSolver);
+
+    // truncated file must be rejected
+    FILE* f = fopen(path.c_str(), "r+b");
+    assert(f);
+    assert(ftruncate(fileno(f), 100) == 0);
+    fclose(f);
+    SatCheckpoint truncated;
+    assert(!truncated.read(path));
+    remove(path.c_str());
+    assert(!truncated.read(path));
+    LOG(V2_INFO, "Checkpoint roundtrip successful\n");
+}
+
+void testRejectOtherFormula() {
+    const std::string path = "test_sat_checkpoint_compat.bin";
+    const std::vector<int> formula {1, -2, 0, 2, 3, 0};
+    const std::vector<int> otherFormula {1, -2, 0, 2, -3, 0};
+    const int runNonce = 4711;
+
+    SatCheckpoint out;
+    out.jobId = 1;
+    out.revision = 0;
+    out.runNonce = runNonce;
+    out.formulaChecksum = SatCheckpoint::getFormulaChecksum(formula);
+    out.clausesPerSolver.push_back({2, 2, 1, 3});
+    assert(out.write(path));
+
+    SatCheckpoint in;
+    assert(in.read(path));
+    remove(path.c_str());
+    assert(in.isCompatible(1, SatCheckpoint::getFormulaChecksum(formula), runNonce));
+    // same job ID, but different formula (e.g., left behind by an earlier run)
+    assert(!in.isCompatible(1, SatCheckpoint::getFormulaChecksum(otherFormula), runNonce));
+    // same formula, but written by another run
+    assert(!in.isCompatible(1, SatCheckpoint::getFormulaChecksum(formula), runNonce+1));
+    assert(!in.isCompatible(2, SatCheckpoint::getFormulaChecksum(formula), runNonce));
+    LOG(V2_INFO, "Checkpoint of other formula rejected\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+    testReservoir();
+    testRoundtrip();
+    testRejectOtherFormula();
+}
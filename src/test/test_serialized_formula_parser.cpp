@@ -1,6 +1,8 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <climits>
 #include <vector>
 
 #include "app/sat/parse/serialized_formula_parser.hpp"
@@ -40,6 +42,33 @@ void testLarge() {
     }
 }
 
+void testChunks() {
+    std::vector<int> payload;
+    for (size_t i = 0; i < 100'000; i++) {
+        payload.push_back(i+1); payload.push_back(-(i+2)); payload.push_back(0);
+    }
+    // assumptions
+    payload.push_back(INT32_MAX);
+    payload.push_back(7); payload.push_back(-8); payload.push_back(0);
+
+    for (size_t maxChunkSize : {1, 2, 1000, 1<<20}) {
+        SerializedFormulaParser parser(Logger::getMainInstance(), payload.data(), payload.size());
+        std::vector<int> lits;
+        const int* chunk;
+        size_t chunkSize;
+        while (parser.getNextLiteralChunk(chunk, chunkSize, maxChunkSize)) {
+            assert(chunkSize > 0 && chunkSize <= maxChunkSize);
+            lits.insert(lits.end(), chunk, chunk+chunkSize);
+        }
+        assert(lits.size() == 300'000);
+        assert(std::equal(lits.begin(), lits.end(), payload.begin()));
+        int lit;
+        assert(parser.getNextAssumption(lit) && lit == 7);
+        assert(parser.getNextAssumption(lit) && lit == -8);
+        assert(!parser.getNextAssumption(lit));
+    }
+}
+
 int main() {
 
     Timer::init();
@@ -59,4 +88,5 @@ int main() {
     }
 
     testLarge();
+    testChunks();
 }
@@ -0,0 +1,156 @@
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/random.hpp"
+#include "util/sys/timer.hpp"
+#include "app/maxsat/encoding/shared_cardinality_encoding.hpp"
+
+// Mock encoding which introduces one fresh variable per encoded bound,
+// defined by a binary clause, and assumes its negation to enforce the bound.
+// Like the actual encodings, it is incremental: encoding a bound again has no effect.
+class MockEncoding : public CardinalityEncoding {
+public:
+    int nbEncodeCalls {0};
+    std::vector<int> varOfBound;
+    MockEncoding(unsigned int nbVars, const std::vector<MaxSatInstance::ObjectiveTerm>& objective) :
+        CardinalityEncoding(nbVars, objective), varOfBound(100, 0) {}
+    virtual void doEncode(size_t min, size_t ub, size_t max) override {
+        nbEncodeCalls++;
+        if (varOfBound[ub] != 0) return;
+        varOfBound[ub] = ++_nb_vars;
+        cardinality_encoding_add_literal(-varOfBound[ub], this);
+        cardinality_encoding_add_literal(ub+1, this);
+        cardinality_encoding_add_literal(0, this);
+    }
+    virtual void doEnforce(size_t bound) override {
+        cardinality_encoding_add_assumption(-varOfBound[bound], this);
+    }
+};
+
+void testSequential() {
+    LOG(V2_INFO, "Testing sequential use\n");
+    std::vector<MaxSatInstance::ObjectiveTerm> objective {{1, 1}, {1, 2}};
+    auto mock = new MockEncoding(10, objective);
+    SharedCardinalityEncoding enc(mock);
+
+    size_t cursorA {0}, cursorB {0};
+    std::vector<int> litsA, litsB, assumptions;
+    enc.encodeAndEnforce(0, 5, 10, cursorA, litsA, assumptions);
+    assert(assumptions == std::vector<int>({-11}));
+    assert(litsA == std::vector<int>({-11, 6, 0}));
+
+    // B receives A's clauses and no new encoding is performed
+    assumptions.clear();
+    enc.encodeAndEnforce(0, 5, 10, cursorB, litsB, assumptions);
+    assert(mock->nbEncodeCalls == 1);
+    assert(assumptions == std::vector<int>({-11}));
+    assert(litsB == litsA);
+
+    // A receives only the new clause(s) of bound 3
+    assumptions.clear();
+    litsA.clear();
+    enc.encodeAndEnforce(0, 3, 10, cursorA, litsA, assumptions);
+    assert(mock->nbEncodeCalls == 2);
+    assert(assumptions == std::vector<int>({-12}));
+    assert(litsA == std::vector<int>({-12, 4, 0}));
+
+    // B is up to date afterwards
+    enc.encodeAndEnforce(0, 3, 10, cursorB, litsB, assumptions);
+    assert(litsB == std::vector<int>({-11, 6, 0, -12, 4, 0}));
+    assert(cursorA == cursorB);
+}
+
+void testOwnBoundOnly() {
+    LOG(V2_INFO, "Testing receipt of required clauses only\n");
+    std::vector<MaxSatInstance::ObjectiveTerm> objective {{1, 1}, {1, 2}};
+    auto mock = new MockEncoding(10, objective);
+    SharedCardinalityEncoding enc(mock);
+
+    size_t cursorA {0}, cursorB {0};
+    std::vector<int> litsA, litsB, assumptions;
+    enc.encodeAndEnforce(0, 5, 10, cursorA, litsA, assumptions);
+    enc.encodeAndEnforce(0, 3, 10, cursorB, litsB, assumptions);
+    enc.encodeAndEnforce(0, 7, 10, cursorB, litsB, assumptions);
+    assert(litsB == std::vector<int>({-11, 6, 0, -12, 4, 0, -13, 8, 0}));
+
+    // A does not receive the clauses of B's later bounds for its own bound
+    litsA.clear();
+    assumptions.clear();
+    enc.encodeAndEnforce(0, 5, 10, cursorA, litsA, assumptions);
+    assert(assumptions == std::vector<int>({-11}));
+    assert(litsA.empty() || log_return_false("[ERROR] received %lu lits for a present bound\n", litsA.size()));
+
+    // For bound 7, A receives everything up to bound 7's clauses
+    enc.encodeAndEnforce(0, 7, 10, cursorA, litsA, assumptions);
+    assert(litsA == std::vector<int>({-12, 4, 0, -13, 8, 0}));
+    assert(cursorA == cursorB);
+    assert(mock->nbEncodeCalls == 3);
+}
+
+void testBoundRange() {
+    LOG(V2_INFO, "Testing bounds within different ranges\n");
+    std::vector<MaxSatInstance::ObjectiveTerm> objective {{1, 1}, {1, 2}};
+    auto mock = new MockEncoding(10, objective);
+    SharedCardinalityEncoding enc(mock);
+
+    size_t cursor {0};
+    std::vector<int> lits, assumptions;
+    enc.encodeAndEnforce(0, 5, 10, cursor, lits, assumptions);
+    enc.encodeAndEnforce(0, 5, 10, cursor, lits, assumptions);
+    assert(mock->nbEncodeCalls == 1);
+    // The same bound within another range is encoded (and enforced) for this range
+    enc.encodeAndEnforce(2, 5, 10, cursor, lits, assumptions);
+    assert(mock->nbEncodeCalls == 2);
+    enc.encodeAndEnforce(0, 5, 8, cursor, lits, assumptions);
+    assert(mock->nbEncodeCalls == 3);
+    enc.encodeAndEnforce(2, 5, 10, cursor, lits, assumptions);
+    assert(mock->nbEncodeCalls == 3);
+    assert(assumptions == std::vector<int>(5, -11));
+    assert(lits == std::vector<int>({-11, 6, 0}));
+}
+
+void testConcurrent() {
+    LOG(V2_INFO, "Testing concurrent use\n");
+    std::vector<MaxSatInstance::ObjectiveTerm> objective {{1, 1}, {1, 2}};
+    auto mock = new MockEncoding(10, objective);
+    SharedCardinalityEncoding enc(mock);
+
+    const int nbThreads = 4;
+    std::vector<std::vector<int>> lits(nbThreads);
+    std::vector<size_t> cursors(nbThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nbThreads; t++) threads.emplace_back([&, t]() {
+        for (size_t bound = 50; bound > 0; bound--) {
+            std::vector<int> assumptions;
+            enc.encodeAndEnforce(0, (bound + t) % 50 + 1, 60, cursors[t], lits[t], assumptions);
+            assert(assumptions.size() == 1);
+        }
+    });
+    for (auto& thread : threads) thread.join();
+    assert(mock->nbEncodeCalls == 50);
+
+    // Each user requested each bound and thus received all clauses, each exactly once
+    for (auto& l : lits) {
+        assert(l.size() == 3*50);
+        std::vector<int> definedVars;
+        for (size_t i = 0; i < l.size(); i += 3) definedVars.push_back(-l[i]);
+        std::sort(definedVars.begin(), definedVars.end());
+        for (size_t i = 0; i < definedVars.size(); i++) assert(definedVars[i] == 11+i);
+    }
+}
+
+int main() {
+    Timer::init();
+    Random::init(rand(), rand());
+    Logger::init(0, V5_DEBG);
+
+    testSequential();
+    testOwnBoundOnly();
+    testBoundRange();
+    testConcurrent();
+}
@@ -0,0 +1,102 @@
+
+#include <functional>
+#include <memory>
+#include <unistd.h>
+#include <vector>
+
+#include "util/assert.hpp"
+#include "util/logger.hpp"
+#include "util/merge_source_interface.hpp"
+#include "util/random.hpp"
+#include "util/spsc_blocking_ringbuffer.hpp"
+#include "util/sys/timer.hpp"
+#include "util/threaded_merge_tree.hpp"
+
+template<typename T>
+class LambdaMergeSource : public MergeSourceInterface<T> {
+private:
+    std::function<bool(T&)> source;
+public:
+    LambdaMergeSource(std::function<bool(T&)> source) : source(source) {}
+    bool pollBlocking(T& output) override {
+        return source(output);
+    }
+    size_t getCurrentSize() const override {
+        return 0;
+    }
+};
+
+void testMerge(int nbSources, int fanIn) {
+    // Each source provides a descending sequence of random numbers
+    std::vector<std::vector<int>> sequences(nbSources);
+    size_t nbElems = 0;
+    for (auto& seq : sequences) {
+        int size = (int) (Random::rand() * 1000);
+        int x = 1'000'000;
+        for (int i = 0; i < size; i++) {
+            x -= (int) (Random::rand() * 100);
+            seq.push_back(x);
+        }
+        nbElems += size;
+    }
+    std::vector<size_t> positions(nbSources, 0);
+    std::vector<std::unique_ptr<MergeSourceInterface<int>>> sources;
+    std::vector<MergeSourceInterface<int>*> ptrs;
+    for (int s = 0; s < nbSources; s++) {
+        sources.emplace_back(new LambdaMergeSource<int>([&, s](int& out) {
+            if (positions[s] == sequences[s].size()) return false;
+            out = sequences[s][positions[s]++];
+            return true;
+        }));
+        ptrs.push_back(sources.back().get());
+    }
+
+    ThreadedMergeTree<int> tree(ptrs, fanIn, /*bufferSize=*/16);
+    int last = INT32_MAX;
+    size_t nbMerged = 0;
+    int elem;
+    while (tree.pollBlocking(elem)) {
+        assert(elem <= last);
+        last = elem;
+        nbMerged++;
+    }
+    assert(nbMerged == nbElems);
+    LOG(V2_INFO, "Merged %lu elements of %i sources with fan-in %i\n", nbMerged, nbSources, fanIn);
+}
+
+void testDestructionWhileBlocked() {
+    // Sources which never provide any element nor are marked exhausted:
+    // each group worker blocks while polling its sources.
+    const int nbSources = 20;
+    std::vector<std::unique_ptr<SPSCBlockingRingbuffer<int>>> sources;
+    std::vector<MergeSourceInterface<int>*> ptrs;
+    for (int s = 0; s < nbSources; s++) {
+        sources.emplace_back(new SPSCBlockingRingbuffer<int>(16));
+        ptrs.push_back(sources.back().get());
+    }
+    // Fill the first group's sources, so that its worker blocks
+    // on the group's (full) output instead
+    for (int i = 16; i > 0; i--) {
+        int x = i;
+        sources[0]->pushBlocking(x);
+    }
+    for (int s = 1; s < 4; s++) sources[s]->markExhausted();
+    {
+        ThreadedMergeTree<int> tree(ptrs, /*fanIn=*/4, /*bufferSize=*/4);
+        usleep(10'000);
+        // leaving the scope must not hang
+    }
+    LOG(V2_INFO, "Destroyed tree with blocked workers\n");
+}
+
+int main() {
+    Timer::init();
+    Random::init(0, 0);
+    Logger::init(0, V5_DEBG);
+
+    testMerge(1, 4);
+    testMerge(4, 4);
+    testMerge(17, 4);
+    testMerge(100, 8);
+    testDestructionWhileBlocked();
+}
@@ -0,0 +1,79 @@
+
+#pragma once
+
+#include "util/sys/buffered_io.hpp"
+#include <fstream>
+#include <vector>
+
+// Reads a file which consists of a sequence of blocks of known sizes
+// in reverse block order, i.e., the last block first, but reads the bytes
+// within each block in forward order.
+class BlockReversedFileReader : public LinearFileReader {
+
+private:
+    std::ifstream _stream;
+    std::vector<size_t> _block_sizes;
+    size_t _block_end {0}; // end offset of the block to read next
+    bool _valid {true};
+
+    std::vector<char> _buffer;
+    size_t _buffer_pos {0};
+
+public:
+    BlockReversedFileReader(const std::string& filename, const std::vector<size_t>& blockSizes) :
+            LinearFileReader(), _stream(filename, std::ios_base::binary), _block_sizes(blockSizes) {
+        _valid = _stream.good();
+        for (size_t size : _block_sizes) _block_end += size;
+    }
+
+    bool valid() const {
+        return _valid;
+    }
+
+    // Provides the next entire block
+    bool nextBlock(const char*& data, size_t& size) {
+        if (_buffer_pos == _buffer.size() && !refillBuffer()) return false;
+        data = _buffer.data() + _buffer_pos;
+        size = _buffer.size() - _buffer_pos;
+        _buffer_pos = _buffer.size();
+        return true;
+    }
+
+    inline bool next(char& c) {
+        if (_buffer_pos == _buffer.size() && !refillBuffer()) return false;
+        c = _buffer[_buffer_pos++];
+        return true;
+    }
+
+    inline virtual char next() override {
+        char c;
+        if (!next(c)) return '\0';
+        return c;
+    }
+
+    virtual bool endOfFile() override {
+        return _buffer_pos == _buffer.size() && _block_sizes.empty();
+    }
+
+private:
+    bool refillBuffer() {
+        while (_valid && !_block_sizes.empty()) {
+            const size_t size = _block_sizes.back();
+            _block_sizes.pop_back();
+            _block_end -= size;
+            if (size == 0) continue;
+            _buffer.resize(size);
+            _stream.seekg(_block_end, std::ios_base::beg);
+            _stream.read(_buffer.data(), size);
+            if ((size_t) _stream.gcount() != size) {
+                _valid = false;
+                break;
+            }
+            _buffer_pos = 0;
+            return true;
+        }
+        _buffer.clear();
+        _buffer_pos = 0;
+        return false;
+    }
+};
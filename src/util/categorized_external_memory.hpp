@@ -101,6 +101,23 @@ public:
         _num_elems -= result.size();
     }
 
+    // Read all objects at the given address without removing them.
+    void fetch(size_t address, std::vector<T>& result) {
+        if (address >= _blocks_per_address.size())
+            return;
+        for (auto& block : _blocks_per_address.at(address)) {
+            result.resize(result.size() + (block.size / sizeof(T)));
+            auto insertionPoint = result.data() + result.size() - (block.size / sizeof(T));
+            if (!block.buffer.empty()) {
+                memcpy(insertionPoint, block.buffer.data(), block.size);
+            } else {
+                unsigned long pos = _blocksize * block.address;
+                _disk.seekg(pos, std::ios::beg);
+                _disk.read((char*) insertionPoint, block.size);
+            }
+        }
+    }
+
     unsigned long long size() const {
         return _num_elems;
     }
@@ -7,5 +7,7 @@ class MergeSourceInterface {
 public:
     virtual bool pollBlocking(T& elem) = 0;
     virtual size_t getCurrentSize() const = 0;
+    // Makes any current or future blocking poll return false (if supported by the source)
+    virtual void markTerminated() {}
     virtual ~MergeSourceInterface() {}
 };
@@ -0,0 +1,121 @@
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "util/tsl/robin_map.h"
+
+// Exact set of unsigned 64-bit IDs in the style of a roaring bitmap.
+// IDs are grouped by their upper bits into chunks of 2^16 consecutive IDs.
+// A chunk stores its members either as a sorted array of 16-bit offsets
+// (if it has few members) or as a bitmap of 8 KiB (if it has many members).
+// Dense ranges of IDs therefore cost at most one bit per ID, sparse IDs
+// two bytes per ID plus a small per-chunk overhead, and empty chunks nothing.
+class RoaringIdSet {
+
+private:
+    static constexpr int CHUNK_BITS = 16;
+    static constexpr uint64_t CHUNK_SIZE = 1UL << CHUNK_BITS;
+    // An array of 4096 16-bit offsets is as large as a bitmap
+    static constexpr size_t MAX_ARRAY_SIZE = 4096;
+    static constexpr size_t MIN_BITMAP_SIZE = MAX_ARRAY_SIZE / 2;
+
+    struct Chunk {
+        std::vector<uint16_t> array; // sorted, used if bitmap is empty
+        std::vector<uint64_t> bitmap;
+        size_t count {0};
+    };
+    struct ChunkIdHasher {
+        std::size_t operator()(uint64_t val) const {
+            // mix the upper bits into the lower bits, which select the bucket
+            val ^= val >> 33;
+            val *= 0xff51afd7ed558ccdUL;
+            return val ^ (val >> 33);
+        }
+    };
+    tsl::robin_map<uint64_t, Chunk, ChunkIdHasher> _chunks;
+    size_t _size {0};
+
+public:
+    // Returns true iff the ID was not contained before.
+    bool insert(uint64_t id) {
+        auto& chunk = _chunks[id >> CHUNK_BITS];
+        const uint16_t offset = id & (CHUNK_SIZE-1);
+        if (!chunk.bitmap.empty()) {
+            uint64_t& word = chunk.bitmap[offset / 64];
+            const uint64_t bit = 1UL << (offset % 64);
+            if (word & bit) return false;
+            word |= bit;
+        } else {
+            auto it = std::lower_bound(chunk.array.begin(), chunk.array.end(), offset);
+            if (it != chunk.array.end() && *it == offset) return false;
+            chunk.array.insert(it, offset);
+            if (chunk.array.size() > MAX_ARRAY_SIZE) toBitmap(chunk);
+        }
+        chunk.count++;
+        _size++;
+        return true;
+    }
+
+    bool contains(uint64_t id) const {
+        auto it = _chunks.find(id >> CHUNK_BITS);
+        if (it == _chunks.end()) return false;
+        auto& chunk = it->second;
+        const uint16_t offset = id & (CHUNK_SIZE-1);
+        if (!chunk.bitmap.empty()) return chunk.bitmap[offset / 64] & (1UL << (offset % 64));
+        return std::binary_search(chunk.array.begin(), chunk.array.end(), offset);
+    }
+
+    // Returns true iff the ID was contained before.
+    bool erase(uint64_t id) {
+        auto it = _chunks.find(id >> CHUNK_BITS);
+        if (it == _chunks.end()) return false;
+        auto& chunk = it.value();
+        const uint16_t offset = id & (CHUNK_SIZE-1);
+        if (!chunk.bitmap.empty()) {
+            uint64_t& word = chunk.bitmap[offset / 64];
+            const uint64_t bit = 1UL << (offset % 64);
+            if (!(word & bit)) return false;
+            word &= ~bit;
+            chunk.count--;
+            if (chunk.count > 0 && chunk.count < MIN_BITMAP_SIZE) toArray(chunk);
+        } else {
+            auto pos = std::lower_bound(chunk.array.begin(), chunk.array.end(), offset);
+            if (pos == chunk.array.end() || *pos != offset) return false;
+            chunk.array.erase(pos);
+            chunk.count--;
+        }
+        _size--;
+        if (chunk.count == 0) _chunks.erase(it);
+        return true;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    size_t getNumChunks() const {
+        return _chunks.size();
+    }
+
+private:
+    void toBitmap(Chunk& chunk) {
+        chunk.bitmap.assign(CHUNK_SIZE / 64, 0);
+        for (uint16_t offset : chunk.array) chunk.bitmap[offset / 64] |= 1UL << (offset % 64);
+        std::vector<uint16_t>().swap(chunk.array);
+    }
+    void toArray(Chunk& chunk) {
+        chunk.array.clear();
+        chunk.array.reserve(chunk.count);
+        for (size_t w = 0; w < chunk.bitmap.size(); w++) {
+            uint64_t word = chunk.bitmap[w];
+            while (word) {
+                chunk.array.push_back(w*64 + __builtin_ctzll(word));
+                word &= word-1;
+            }
+        }
+        std::vector<uint64_t>().swap(chunk.bitmap);
+    }
+};
@@ -80,6 +80,8 @@ public:
 
     inline bool pollBlocking(T& out, bool returnIfEmpty) {
 
+        if (_terminated) return false;
+
         if (_input_exhausted && _exhausted_is_one_time_signal) {
             auto lock = _buffer_mutex.getLock();
             if (_input_exhausted && _exhausted_is_one_time_signal) {
@@ -98,9 +100,10 @@ public:
             // wait until elements are there or the input is marked exhausted
             //LOG(V2_INFO, "SPSC wait nonempty or exhausted\n");
             waitFor([&]() {
-                return _input_exhausted || !empty();
+                return _terminated || _input_exhausted || !empty();
             });
             //LOG(V2_INFO, "SPSC wait nonempty or exhausted done\n");
+            if (_terminated) return false;
 
             if (_input_exhausted && _exhausted_is_one_time_signal) {
                 auto lock = _buffer_mutex.getLock();
@@ -152,7 +155,7 @@ public:
         _buffer_cond_var.notify();
     }
 
-    void markTerminated() {
+    void markTerminated() override {
         {
             auto lock = _buffer_mutex.getLock();
             _terminated = true;
@@ -2,17 +2,21 @@
 #pragma once
 
 #include <fstream>
+#include <vector>
 
 #define READ_BUFFER_SIZE 131072
 
 class BufferedFileWriter {
 
-    std::ofstream& stream;
+    std::ofstream* stream {nullptr};
+    std::vector<unsigned char>* vec {nullptr};
     unsigned char write_buffer[READ_BUFFER_SIZE];
     size_t write_pos {0};
 
 public:
-    BufferedFileWriter(std::ofstream& stream) : stream(stream) {}
+    BufferedFileWriter(std::ofstream& stream) : stream(&stream) {}
+    // Appends all output to the provided vector instead of a file
+    BufferedFileWriter(std::vector<unsigned char>& vec) : vec(&vec) {}
     ~BufferedFileWriter() {
         flush();
     }
@@ -22,8 +26,10 @@ public:
         write_buffer[write_pos++] = c;
     }
     void flush() {
-        if (stream.good())
-            stream.write((const char*) write_buffer, write_pos);
+        if (vec)
+            vec->insert(vec->end(), write_buffer, write_buffer+write_pos);
+        else if (stream->good())
+            stream->write((const char*) write_buffer, write_pos);
         write_pos = 0;
     }
 };
@@ -0,0 +1,54 @@
+
+#pragma once
+
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Minimal wrapper around Linux futexes which allows a thread to sleep
+// until an int in (possibly process-shared) memory is changed by another party.
+// The non-private futex operations are used, so the int may reside in
+// shared memory mapped by different processes.
+class Futex {
+
+public:
+    // Sleep as long as *addr == expected, but at most for the given number
+    // of milliseconds (negative: no timeout). Spurious wake-ups are possible,
+    // so the caller must re-check its condition.
+    static void wait(volatile int* addr, int expected, int timeoutMillis = -1) {
+        if (timeoutMillis < 0) {
+            syscall(SYS_futex, (int*) addr, FUTEX_WAIT, expected, nullptr, nullptr, 0);
+            return;
+        }
+        timespec timeout;
+        timeout.tv_sec = timeoutMillis / 1000;
+        timeout.tv_nsec = (timeoutMillis % 1000) * 1000 * 1000;
+        syscall(SYS_futex, (int*) addr, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+    }
+
+    // Wake up all parties sleeping on the provided address.
+    static void wakeAll(volatile int* addr) {
+        syscall(SYS_futex, (int*) addr, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+};
+
+// Event counter in (possibly process-shared) memory. A party which wants to
+// sleep until "something happens" reads the current state, re-checks its
+// actual conditions, and then waits for the state to change. Any notification
+// after reading the state will then wake it up, so no notification can be missed.
+struct FutexEvent {
+    volatile int counter {0};
+
+    int state() const {
+        return __atomic_load_n(&counter, __ATOMIC_ACQUIRE);
+    }
+    void notify() {
+        __atomic_fetch_add(&counter, 1, __ATOMIC_RELEASE);
+        Futex::wakeAll(&counter);
+    }
+    void wait(int lastState, int timeoutMillis = -1) {
+        Futex::wait(&counter, lastState, timeoutMillis);
+    }
+};
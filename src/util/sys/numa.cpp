@@ -0,0 +1,115 @@
+
+#include "numa.hpp"
+
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "util/logger.hpp"
+
+std::vector<int> Numa::_nodes;
+std::vector<std::vector<int>> Numa::_cpus_per_node;
+
+namespace {
+// Parses a list such as "0-3,8,10-11"
+std::vector<int> parseList(const std::string& list) {
+    std::vector<int> out;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        std::string range = list.substr(pos, end-pos);
+        size_t dash = range.find('-');
+        try {
+            int first = std::stoi(range.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(range.substr(dash+1));
+            for (int i = first; i <= last; i++) out.push_back(i);
+        } catch (...) {}
+        pos = end+1;
+    }
+    return out;
+}
+std::string readLine(const std::string& path) {
+    std::ifstream ifs(path);
+    std::string line;
+    if (ifs.good()) std::getline(ifs, line);
+    return line;
+}
+}
+
+void Numa::init() {
+    if (!_nodes.empty()) return;
+
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool hasMask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+    for (int node : parseList(readLine("/sys/devices/system/node/online"))) {
+        std::vector<int> cpus;
+        for (int cpu : parseList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))) {
+            if (cpu < CPU_SETSIZE && (!hasMask || CPU_ISSET(cpu, &allowed))) cpus.push_back(cpu);
+        }
+        if (cpus.empty()) continue;
+        _nodes.push_back(node);
+        _cpus_per_node.push_back(std::move(cpus));
+    }
+    if (_nodes.empty()) {
+        // No topology information: treat the machine as a single node
+        _nodes.push_back(0);
+        _cpus_per_node.emplace_back();
+    }
+    LOG(V4_VVER, "NUMA: %i node(s) available\n", (int) _nodes.size());
+}
+
+int Numa::getNumNodes() {
+    init();
+    return _nodes.size();
+}
+
+int Numa::getNodeForIndex(int index) {
+    init();
+    return _nodes[index % _nodes.size()];
+}
+
+bool Numa::pinThisThreadToNode(int node) {
+    init();
+    for (size_t i = 0; i < _nodes.size(); i++) {
+        if (_nodes[i] != node) continue;
+        if (_cpus_per_node[i].empty()) return false;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : _cpus_per_node[i]) CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+    }
+    return false;
+}
+
+bool Numa::setPreferredNodeOfThisThread(int node) {
+    if (node < 0) return syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0) == 0;
+    const size_t bitsPerWord = 8*sizeof(unsigned long);
+    std::vector<unsigned long> mask(node / bitsPerWord + 1, 0);
+    mask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+    // the kernel reads maxnode-1 bits
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask.data(), mask.size()*bitsPerWord + 1) == 0;
+}
+
+std::vector<Numa::NodeStats> Numa::getNodeStats() {
+    init();
+    std::vector<NodeStats> out;
+    for (int node : _nodes) {
+        NodeStats stats;
+        stats.node = node;
+        std::ifstream ifs("/sys/devices/system/node/node" + std::to_string(node) + "/numastat");
+        std::string key;
+        unsigned long val;
+        while (ifs >> key >> val) {
+            if (key == "local_node") stats.localPages = val;
+            if (key == "other_node") stats.remotePages = val;
+        }
+        out.push_back(stats);
+    }
+    return out;
+}
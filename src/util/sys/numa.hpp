@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include <stddef.h>
+#include <vector>
+
+/*
+Minimal interface to the NUMA topology of this machine (read from /sys) and to
+the placement of threads and memory on NUMA nodes (via sched_setaffinity and
+set_mempolicy), without depending on libnuma. Only nodes on which this process
+is allowed to run are considered. Call init() from the main thread before any
+thread of this process has been pinned.
+*/
+class Numa {
+
+private:
+    static std::vector<int> _nodes;
+    static std::vector<std::vector<int>> _cpus_per_node;
+
+public:
+    static void init();
+
+    // Number of NUMA nodes with CPUs available to this process (at least one)
+    static int getNumNodes();
+    // Node ID for the i-th thread, distributing consecutive threads round robin
+    static int getNodeForIndex(int index);
+    // Restrict the calling thread to the CPUs of the given node
+    static bool pinThisThreadToNode(int node);
+    // Make memory which the calling thread faults in from now on prefer the given node
+    // (node < 0: revert to the default policy, i.e., allocation on the local node)
+    static bool setPreferredNodeOfThisThread(int node);
+
+    // System-wide counters of pages allocated on each node,
+    // distinguishing allocations for local and for remote threads
+    struct NodeStats {
+        int node;
+        unsigned long localPages {0};
+        unsigned long remotePages {0};
+    };
+    static std::vector<NodeStats> getNodeStats();
+};
+
+// Within the lifetime of this object, memory faulted in by the calling thread
+// is placed on the provided NUMA node (if node >= 0).
+class NumaPreferredNodeScope {
+private:
+    const int _node;
+public:
+    NumaPreferredNodeScope(int node) : _node(node) {
+        if (_node >= 0) Numa::setPreferredNodeOfThisThread(_node);
+    }
+    ~NumaPreferredNodeScope() {
+        if (_node >= 0) Numa::setPreferredNodeOfThisThread(-1);
+    }
+};
@@ -0,0 +1,81 @@
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "merge_source_interface.hpp"
+#include "small_merger.hpp"
+#include "spsc_blocking_ringbuffer.hpp"
+#include "util/sys/background_worker.hpp"
+
+// Merges a (possibly large) number of sources via a two-level tree of SmallMergers.
+// The sources are partitioned into groups of at most fanIn sources, and each group
+// is merged by its own thread into a ringbuffer. The merger at the top, which is
+// polled by the caller, then only needs to compare the heads of the groups.
+// With at most fanIn sources, this is equivalent to a single SmallMerger.
+// Destroying the tree before all sources are exhausted terminates the sources
+// of the groups (see MergeSourceInterface::markTerminated) to release its threads.
+template <typename T>
+class ThreadedMergeTree : public MergeSourceInterface<T> {
+
+private:
+    std::vector<MergeSourceInterface<T>*> _group_sources;
+    std::vector<std::unique_ptr<SmallMerger<T>>> _group_mergers;
+    std::vector<std::unique_ptr<SPSCBlockingRingbuffer<T>>> _group_outputs;
+    std::vector<std::unique_ptr<BackgroundWorker>> _workers;
+    std::unique_ptr<SmallMerger<T>> _top_merger;
+
+public:
+    ThreadedMergeTree(std::vector<MergeSourceInterface<T>*>& sources, int fanIn, int bufferSize) {
+
+        if (sources.size() <= (size_t) fanIn) {
+            _top_merger.reset(new SmallMerger<T>(sources));
+            return;
+        }
+
+        _group_sources = sources;
+        std::vector<MergeSourceInterface<T>*> topSources;
+        for (size_t begin = 0; begin < sources.size(); begin += fanIn) {
+            std::vector<MergeSourceInterface<T>*> group(sources.begin()+begin,
+                sources.begin()+std::min(sources.size(), begin+fanIn));
+            _group_mergers.emplace_back(new SmallMerger<T>(group));
+            _group_outputs.emplace_back(new SPSCBlockingRingbuffer<T>(bufferSize));
+            topSources.push_back(_group_outputs.back().get());
+        }
+        _top_merger.reset(new SmallMerger<T>(topSources));
+
+        for (size_t i = 0; i < _group_mergers.size(); i++) {
+            _workers.emplace_back(new BackgroundWorker());
+            auto& worker = *_workers.back();
+            auto& merger = *_group_mergers[i];
+            auto& output = *_group_outputs[i];
+            worker.run([&]() {
+                T elem;
+                while (worker.continueRunning() && merger.pollBlocking(elem)) {
+                    if (!output.pushBlocking(elem)) break; // terminated
+                }
+                output.markExhausted();
+            });
+        }
+    }
+
+    bool pollBlocking(T& output) override {
+        return _top_merger->pollBlocking(output);
+    }
+
+    size_t getCurrentSize() const override {
+        return _top_merger->getCurrentSize();
+    }
+
+    std::string getReport() {
+        return _top_merger->getReport();
+    }
+
+    ~ThreadedMergeTree() {
+        // A group worker may be blocked on its output or on one of its sources
+        for (auto& output : _group_outputs) output->markTerminated();
+        for (auto source : _group_sources) source->markTerminated();
+        for (auto& worker : _workers) worker->stop();
+    }
+};